@@ -9,11 +9,16 @@ required_conan_version = ">=2.0.14"
 
 class xSDK(ConanFile):
     settings = "os", "arch", "compiler", "build_type"
+    options = {"with_benchmarks": [True, False]}
+    default_options = {"with_benchmarks": False}
 
     def requirements(self):
         self.requires("gtest/1.14.0")
         self.requires("rapidjson/cci.20230929")
         self.requires("xerces-c/3.2.5")
+        # Required only for WITH_BENCHMARKS=ON builds
+        if self.options.with_benchmarks:
+            self.requires("benchmark/1.8.3")
 
     def generate(self):
         tc = CMakeDeps(self)
@@ -30,22 +30,21 @@ INode::OnChangePF printer = [](INode::CallbackReason _cbr,
     return true;
 };
 // Function that checks that the number of clients should not be greater than 10
+// (called only for "num_clients" key, see OnChangeKeysAdd() below)
 INode::OnChangePF limit_num_clients = [](INode::CallbackReason _cbr,
                           const INode::SPtrC&   _node,
                           const XKey&           _key,
                           const XValueRT&       _from,
                           const XValueRT&       _to) {
-    if (_key.StringGet() == "num_clients") {
-        if (_to.Int64() > 10) {
-            std::cout << "Reached the maximum number of clients" << std::endl;
-            return false;
-        }
+    if (_to.Int64() > 10) {
+        std::cout << "Reached the maximum number of clients" << std::endl;
+        return false;
     }
     return true;
 };
 // Add OnChange callbacks
 spMap->OnChangeAdd(std::move(printer));
-spMap->OnChangeAdd(std::move(limit_num_clients));
+spMap->OnChangeKeysAdd(std::move(limit_num_clients), {{"num_clients"}, {}});
 
 spMap->Set("num_clients", 0);
 // Output: 1 reason: Changes
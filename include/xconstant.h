@@ -37,6 +37,32 @@ enum class OnEachRes {
     Stop
 };
 
+/**
+ * @brief Enum class representing the storage layouts of map nodes.
+ */
+enum class MapLayout {
+    /// Ordered tree (std::map), keys are enumerated in lexicographical order.
+    Tree,
+    /// Open-addressing hash table, keys enumeration order is unspecified.
+    Hash,
+    /// Open-addressing hash table, keys are enumerated in insertion order.
+    HashOrdered,
+    /// Sorted vector for small maps, promoted to Tree when grows (same enumeration order as Tree).
+    Flat,
+    /// Sorted vector for small maps, promoted to Hash when grows.
+    FlatHash
+};
+
+/**
+ * @brief Enum class representing the storage layouts of array nodes.
+ */
+enum class ArrayLayout {
+    /// Contiguous vector: O(1) index access, amortised O(1) append.
+    Vector,
+    /// Double-ended queue (std::deque): O(1) insert/erase at the front.
+    Deque
+};
+
 // Special values for map/arrays
 static constexpr size_t kIdxBegin = 0;  ///< The index of the first element in the map/array.
 static constexpr size_t kIdxEnd   = -1; ///< The index of the last element in the map/array.
@@ -61,7 +87,8 @@ static constexpr std::string_view kXMLAttributePrefix = "-"; ///< Prefix for XML
 static constexpr std::string_view kXMLValueName = "#text";   ///< Name for the XML value element.
 
 // Special values for JSON/XML export
-static constexpr size_t kExportIndentCount = 4;   ///< Number of spaces for indentation when exporting data.
-static constexpr char   kExportIndentChar  = ' '; ///< Character used for indentation when exporting data.
+static constexpr size_t kExportIndentCount = 4;         ///< Number of spaces for indentation when exporting data.
+static constexpr char   kExportIndentChar  = ' ';       ///< Character used for indentation when exporting data.
+static constexpr size_t kExportChunkSize   = 64 * 1024; ///< Max size of chunk passed to sink when streaming export.
 
 } // namespace xsdk
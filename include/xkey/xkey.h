@@ -29,9 +29,18 @@ using XKeyVariant = std::variant<std::monostate, size_t, std::string_view>;
  */
 class XKey: public XKeyVariant {
     /**
-     * @brief Holder for the owned string.
+     * @brief Interned key string (string_view of variant points to it), empty if key was not constructed
+     * from interned string.
+     */
+    xnode::StringAtom    atom_;
+    /**
+     * @brief Holder for the owned long string.
      */
     xnode::String::SPtrC str_hold_p_;
+    /**
+     * @brief Owned short string (w/o allocation).
+     */
+    xnode::StringShort   str_short_ {std::string_view()};
 
 public:
     ///@name Base constructors
@@ -44,12 +53,23 @@ public:
      * @brief Move constructor.
      * @param _other The other XKey to move from.
      */
-    XKey(XKey&& _other) noexcept = default;
+    XKey(XKey&& _other) noexcept
+        : XKeyVariant(std::move(_other)),
+          atom_(std::move(_other.atom_)),
+          str_hold_p_(std::move(_other.str_hold_p_)),
+          str_short_(_other.str_short_)
+    {
+        ShortRebind_(_other);
+    }
     /**
      * @brief Copy constructor.
      * @param _other The other XKey to copy from.
      */
-    XKey(const XKey& _other) = default;
+    XKey(const XKey& _other)
+        : XKeyVariant(_other), atom_(_other.atom_), str_hold_p_(_other.str_hold_p_), str_short_(_other.str_short_)
+    {
+        ShortRebind_(_other);
+    }
     ///@}
 
     ///@name XKeyVariant constructors
@@ -101,11 +121,7 @@ public:
      * @brief Move constructor from std::string.
      * @param _str The std::string to initialize the XKey with.
      */
-    XKey(std::string&& _str)
-    {
-        str_hold_p_           = std::make_shared<const std::string>(std::move(_str));
-        (XKeyVariant&)* this = *str_hold_p_;
-    }
+    XKey(std::string&& _str) : XKeyVariant(std::string_view(_str)) { InitHolder_(std::move(_str)); }
     /**
      * @brief Copy constructor from std::string.
      * @param _str The std::string to initialize the XKey with.
@@ -121,30 +137,55 @@ public:
      * @param _psz The const char* to initialize the XKey with.
      */
     XKey(const char* _psz) : XKeyVariant(std::string_view(_psz)) { InitHolder_(); }
+    /**
+     * @brief Constructor from interned string (w/o allocations, the key keeps the interned string).
+     * @param _atom The interned string to initialize the XKey with.
+     */
+    XKey(const xnode::StringAtom& _atom) : XKeyVariant(_atom.view()), atom_(_atom) {}
     ///@}
 
     ///@name Constructors with custom holder
     ///@{
     /**
      * @brief Constructor from @c XKeyVariant with custom string holder.
+     * @details Holder is kept only if the string is not short (short strings are copied into the key).
      * @param _str_hold_p The @c xbase::String::SPtrC to store the XKey string with.
      * @param _var The @c XKeyVariant to initialize the XKey with.
      */
-    XKey(const xnode::String::SPtrC& _str_hold_p, XKeyVariant&& _var)
-        : XKeyVariant(std::move(_var)),
-          str_hold_p_(_str_hold_p)
+    XKey(const xnode::String::SPtrC& _str_hold_p, XKeyVariant&& _var) : XKeyVariant(std::move(_var))
     {
+        InitHolder_(_str_hold_p);
     }
     /**
      * @brief Constructor from @c std::string_view with custom string holder.
+     * @details Holder is kept only if the string is not short (short strings are copied into the key).
      * @param _str_hold_p The @c xbase::String::SPtrC to store the XKey string with.
      * @param _str The @c std::string_view to initialize the XKey with.
      */
-    XKey(const xnode::String::SPtrC& _str_hold_p, std::string_view _str) : XKeyVariant(_str), str_hold_p_(_str_hold_p) {}
+    XKey(const xnode::String::SPtrC& _str_hold_p, std::string_view _str) : XKeyVariant(_str)
+    {
+        InitHolder_(_str_hold_p);
+    }
     ///@}
 
-    XKey& operator=(XKey&&)      = default;
-    XKey& operator=(const XKey&) = default;
+    XKey& operator=(XKey&& _other) noexcept
+    {
+        XKeyVariant::operator=(std::move(_other));
+        atom_       = std::move(_other.atom_);
+        str_hold_p_ = std::move(_other.str_hold_p_);
+        str_short_  = _other.str_short_;
+        ShortRebind_(_other);
+        return *this;
+    }
+    XKey& operator=(const XKey& _other)
+    {
+        XKeyVariant::operator=(_other);
+        atom_       = _other.atom_;
+        str_hold_p_ = _other.str_hold_p_;
+        str_short_  = _other.str_short_;
+        ShortRebind_(_other);
+        return *this;
+    }
 
 public:
     explicit operator bool() const { return !IsEmpty(); }
@@ -186,9 +227,25 @@ public:
      * not a string type.
      */
     std::optional<std::string_view> StringGet() const;
+    /**
+     * @brief Get the interned string of the XKey.
+     * @details Strings are interned on keys insertion into nodes, keys constructed from strings are not interned
+     * (lookups by keys borrow interned strings, @see xnode::StringAtom::Borrow()).
+     * @return The interned string, empty atom if the XKey is not constructed from interned string.
+     */
+    const xnode::StringAtom&        AtomGet() const { return atom_; }
 
 private:
-    void InitHolder_();
+    // Keep own string: short string inline, long string in shared holder
+    void InitHolder_(const xnode::String::SPtrC& _str_hold_p = nullptr);
+    void InitHolder_(std::string&& _str);
+    // Point string_view to own inline string if it pointed to inline string of copied key
+    void ShortRebind_(const XKey& _from)
+    {
+        auto* p_sv = std::get_if<std::string_view>(this);
+        if (p_sv && p_sv->data() == _from.str_short_.c_str())
+            *p_sv = str_short_.view();
+    }
 
     // Make private for hide XKeyVariant::index() from public access
     // - could easy mess 'index' with 'IndexGet' and got error.
@@ -8,9 +8,12 @@
 #include "xvalue/xvalue_rt.h"
 
 #include "xconstant.h"
+#include "xnode_async.h"
 #include "xnode_factory.h"
 #include "xnode_functions.h"
 #include "xnode_interfaces.h"
 #include "xnode_json.h"
+#include "xnode_path.h"
+#include "xnode_transaction.h"
 #include "xnode_xml.h"
 #include "xstring.h"
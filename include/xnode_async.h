@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xsdk::xnode {
+
+/**
+ * @brief Options of asynchronous callbacks dispatcher. @see INode::OnChangeAsyncAdd()
+ * @details Each dispatcher thread drains own bounded lock-free queue (many writers, single reader), every async
+ *          callback is bound to one of threads, so the notifications of callback are called in order of changes.
+ */
+struct AsyncOptions {
+    /// Policy for full queue of dispatcher thread.
+    enum class Overflow {
+        Block, ///< Writer waits for free space in queue after the changed nodes are unlocked (so async
+               ///< callbacks could read them), notifications posted by async callbacks to the queue of own
+               ///< thread are dropped (the thread can't wait for itself).
+        Drop   ///< Notification is dropped (counted in AsyncMetrics::dropped).
+    };
+
+    /// Count of dispatcher threads (at least one).
+    size_t   threads    = 1;
+    /// Queue size of each thread, rounded up to power of 2.
+    size_t   queue_size = 64 * 1024;
+    /// Full queue policy.
+    Overflow overflow   = Overflow::Block;
+};
+
+/**
+ * @brief Metrics of asynchronous callbacks dispatcher (sum for all threads).
+ */
+struct AsyncMetrics {
+    size_t   depth            = 0; ///< Count of queued notifications (including called ones).
+    size_t   depth_max        = 0; ///< Max count of queued notifications (of single queue).
+    uint64_t enqueued         = 0; ///< Total count of queued notifications.
+    uint64_t delivered        = 0; ///< Total count of processed notifications (including removed callbacks).
+    uint64_t dropped          = 0; ///< Count of notifications dropped by Overflow::Drop policy or on exit.
+    uint64_t blocked          = 0; ///< Count of writes waited for queue space by Overflow::Block policy.
+    double   latency_avg_usec = 0; ///< Average time from change to callback call.
+    double   latency_max_usec = 0; ///< Max time from change to callback call.
+};
+
+/**
+ * @brief  Sets options of asynchronous callbacks dispatcher.
+ * @note   The dispatcher threads are started on first async callback adding, after that options can't be changed.
+ * @return \c false if dispatcher already started.
+ */
+bool         AsyncConfigure(const AsyncOptions& _options);
+/**
+ * @brief  Returns metrics of asynchronous callbacks dispatcher.
+ */
+AsyncMetrics AsyncMetricsGet();
+/**
+ * @brief  Waits until notifications queued before the call are delivered (e.g. before check of results or exit).
+ * @note   Should not be called from async callbacks.
+ */
+void         AsyncFlush();
+
+} // namespace xsdk::xnode
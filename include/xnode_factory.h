@@ -3,6 +3,7 @@
 #include "xnode_interfaces.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <cassert>
 
@@ -25,16 +26,63 @@ public:
      */
     virtual ~INodeFactory() = default;
 
+    /**
+     * @brief Options of the created INode objects storage
+     */
+    struct Options {
+        /// Storage layout for map nodes, MapLayout::Flat saves memory for many small maps. @see MapLayout
+        MapLayout map_layout = MapLayout::Tree;
+        /// Storage layout for array nodes. @see ArrayLayout
+        ArrayLayout array_layout = ArrayLayout::Vector;
+        /// Map nodes keep erased items (visible for INode::ForPatch()), those items are removed (compacted)
+        /// when their count exceed erased_ratio_max * map size, zero (default) - disable compaction by ratio.
+        double erased_ratio_max = 0.0;
+        /// Compaction is called on erase if erased_keep_msec passed after previous one, negative (default) -
+        /// disable compaction by age. Erased items younger than erased_keep_msec are never removed by auto
+        /// compaction (all erased items are removed by compaction by ratio if compaction by age is disabled).
+        /// @see INode::ErasedCompact()
+        double erased_keep_msec = -1.0;
+        /// Values are stored with own timestamps (XValueRT). If false values are stored w/o timestamps
+        /// (less memory and no clock call per value, e.g. for bulk imports): all values of node have
+        /// common timestamp - time of node change, taken lazily on first read after change.
+        bool values_timed = true;
+        /// Readers (At(), BulkGet(), BulkGetAll(), Size()) use immutable snapshot of node items w/o locks:
+        /// for read-mostly nodes read by many threads. Each change publishes new snapshot (copy of all items,
+        /// so changes are O(size)), previous snapshots are released when no reader could access them.
+        bool read_snapshots = false;
+        /// Map nodes keep scalar values (bool, int64, uint64, double) in slots protected by sequence locks,
+        /// so AtScalar() reads them w/o node lock (e.g. counters and flags read by many threads).
+        bool scalar_slots = false;
+    };
+
     /**
      * @brief Create a new INode object
      *
      * @param _type NodeType specifying the type of INode to create
      * @param _name Optional name for the new INode object
      * @param _uid Optional unique identifier for the new INode object
+     * @param _options Optional storage options for the new INode object, factory defaults used if not specified
      *
      * @return A shared pointer to the newly created INode object
      */
-    virtual INode::SPtr NodeCreate(INode::NodeType _type, std::string_view _name = {}, uint64_t _uid = 0) = 0;
+    virtual INode::SPtr NodeCreate(INode::NodeType               _type,
+                                   std::string_view              _name    = {},
+                                   uint64_t                      _uid     = 0,
+                                   const std::optional<Options>& _options = std::nullopt) = 0;
+
+    /**
+     * @brief Set default options for INode objects created without explicit options
+     *
+     * @param _options The new default options
+     */
+    virtual void OptionsDefaultSet(const Options& _options) = 0;
+
+    /**
+     * @brief Get default options for INode objects created without explicit options
+     *
+     * @return The current default options
+     */
+    virtual Options OptionsDefaultGet() const = 0;
 };
 
 /**
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "xkey/xpath.h"
+#include "xnode_factory.h"
 #include "xnode_interfaces.h"
 
 #include <memory>
@@ -14,10 +15,14 @@ namespace xsdk::xnode {
  * @param _type Node type to create
  * @param _name Optional name for the node
  * @param _uid Optional unique identifier for the node
+ * @param _options Optional storage options for the node, factory defaults used if not specified
  *
  * @return std::shared_ptr to the newly created XNode
  */
-INode::SPtr Create(INode::NodeType _type, std::string_view _name = {}, uint64_t _uid = 0);
+INode::SPtr Create(INode::NodeType                             _type,
+                   std::string_view                            _name    = {},
+                   uint64_t                                    _uid     = 0,
+                   const std::optional<INodeFactory::Options>& _options = std::nullopt);
 /**
  * @brief Creates an XNode array
  *
@@ -2,6 +2,7 @@
 
 #include "xconstant.h"
 #include "xkey/xkey.h"
+#include "xkey/xpath.h"
 #include "xvalue/xvalue_rt.h"
 #include "xbase.h"
 
@@ -90,6 +91,54 @@ public:
      * This is an example of how to use the OnChange callbacks.
      */
 
+    /**
+     * @brief The change of node item passed to batch callbacks. @see OnChangeBatchPF
+     */
+    struct Change {
+        XKey     key;  ///< The key of changed element.
+        XValueRT from; ///< The previous value of the element (empty for added element).
+        XValueRT to;   ///< The new value of the element (empty for erased element).
+    };
+
+    /**
+     * @brief Defines a function type alias for a batch OnChange callback function.
+     *
+     * The callback is called once per operation with all changes of node: once per bulk operation
+     * (BulkSet(), BulkInsert()) or per transaction (xnode::Transaction), and with single change for other
+     * operations. The callback is called before changes and the batch is approved or vetoed as a whole
+     * (return values are the same as for @ref OnChangePF). If batch was approved, but some of changes were
+     * not applied (e.g. vetoed by per change callbacks), the callback is called with CallbackReason::Rollback
+     * and these changes (with swapped from and to values).
+     */
+    using OnChangeBatchPF =
+        std::function<std::optional<bool>(CallbackReason, const INode::SPtrC&, const std::vector<Change>&)>;
+
+    /**
+     * @brief Defines a function type alias for a subtree OnChange callback function. @see OnChangeSubtreeAdd()
+     *
+     * This callback function takes the following arguments:
+     * @tparam CallbackReason   CallbackReason::ChangesNoDiscard for applied changes or CallbackReason::Rollback
+     *                          for reverted ones.
+     * @tparam SPtrC            A shared pointer to the changed node (the node itself or its descendant).
+     * @tparam XPath            The path of element relative to the node of callback (the last key is the key of
+     *                          changed element).
+     * @tparam XValueRT         The previous value of the element.
+     * @tparam XValueRT         The new value of the element.
+     *
+     * The return value is ignored (changes can't be vetoed), if the callback needs to be removed, return
+     * `std::nullopt`.
+     */
+    using OnSubtreeChangePF = std::function<
+        std::optional<bool>(CallbackReason, const INode::SPtrC&, const XPath&, const XValueRT&, const XValueRT&)>;
+
+    /**
+     * @brief Keys filter of callback. @see OnChangeKeysAdd()
+     */
+    struct KeysFilter {
+        std::vector<XKey>        keys;     ///< The keys (names or indexes) of changed elements.
+        std::vector<std::string> prefixes; ///< The prefixes of names of changed elements.
+    };
+
 public:
     //-------------------------------------------------------------------------------
     // INode specific methods
@@ -174,6 +223,51 @@ public:
      * @see @ref callback_usage_example.cpp "Callback usage example"
      */
     virtual uint64_t OnChangeAdd(OnChangePF&& _pf_on_change, uint64_t _id = 0) const = 0;
+    /**
+     * @brief               Add a callback function to be called on changes of specified keys of a node.
+     * @details             The callback is called only for keys listed in filter or keys with listed prefixes
+     *                      (in the same order with other callbacks), so the callbacks of other keys are not
+     *                      called on change at all.
+     * @param _pf_on_change A callback function to be called on changes of keys.
+     * @param _filter       The keys and keys prefixes of changes.
+     * @param _id           An unique identifier for the callback (shared with OnChangeAdd() callbacks).
+     *                      If the identifier is 0 new unique identifier will be generated.
+     * @return              An unique identifier for the callback, 0 if filter is empty.
+     */
+    virtual uint64_t OnChangeKeysAdd(OnChangePF&& _pf_on_change, KeysFilter _filter, uint64_t _id = 0) const = 0;
+    /**
+     * @brief               Add a batch callback function to be called on changes of a node. @see OnChangeBatchPF
+     * @param _pf_on_batch  A callback function to be called with batch of changes.
+     * @param _id           An unique identifier for the callback (shared with OnChangeAdd() callbacks).
+     *                      If the identifier is 0 new unique identifier will be generated.
+     * @return              An unique identifier for the callback.
+     */
+    virtual uint64_t OnChangeBatchAdd(OnChangeBatchPF&& _pf_on_batch, uint64_t _id = 0) const = 0;
+    /**
+     * @brief               Add a callback function to be called asynchronously after changes of a node.
+     * @details             The callback is called by dispatcher thread w/o node lock (so slow observers do not
+     *                      stall writers) with CallbackReason::ChangesNoDiscard for applied changes and
+     *                      CallbackReason::Rollback for reverted ones (e.g. by aborted xnode::Transaction).
+     *                      The notifications are called in order of changes, return value is ignored except
+     *                      \c std::nullopt which removes the callback. @see xnode::AsyncConfigure()
+     * @param _pf_on_change A callback function to be called on changes of a node.
+     * @param _id           An unique identifier for the callback (shared with OnChangeAdd() callbacks).
+     *                      If the identifier is 0 new unique identifier will be generated.
+     * @return              An unique identifier for the callback.
+     */
+    virtual uint64_t OnChangeAsyncAdd(OnChangePF&& _pf_on_change, uint64_t _id = 0) const = 0;
+    /**
+     * @brief               Add a callback function to be called on changes of a node and all its descendants.
+     * @details             The changes of descendants are passed to callbacks of ancestors by parent links, so
+     *                      added (or moved) descendants are watched w/o registration. The callbacks are called
+     *                      after changes, when the writer thread released all nodes locks (so callbacks could
+     *                      access the subtree), in order of changes. @see OnSubtreeChangePF
+     * @param _pf_on_change A callback function to be called on changes in subtree.
+     * @param _id           An unique identifier for the callback (shared with OnChangeAdd() callbacks).
+     *                      If the identifier is 0 new unique identifier will be generated.
+     * @return              An unique identifier for the callback.
+     */
+    virtual uint64_t OnChangeSubtreeAdd(OnSubtreeChangePF&& _pf_on_change, uint64_t _id = 0) const = 0;
     /**
      * @brief     Remove a callback function by identifier.
      * @param _id An identifier for the callback.
@@ -213,6 +307,13 @@ public:
      * @brief Checks if the container has no elements or, in other words, if the node has no children.
      */
     virtual bool     Empty() const                                                 = 0;
+    /**
+     * @brief   Returns the structure generation of the node.
+     * @details The generation is increased on each change of the node structure: items added or removed
+     *          and child nodes set or replaced (changes of scalar values do not affect generation).
+     *          So resolved child nodes could be cached and revalidated by generation, w/o locks and lookups.
+     */
+    virtual uint64_t Generation() const                                            = 0;
 
     /**
      * @brief       Find the value associated with the given key in this node.
@@ -228,6 +329,14 @@ public:
      * @return      The XValueRT (value with timestamp) associated with the given key, or an empty value.
      */
     virtual XValueRT At(const XKey& _key)                                          = 0;
+    /**
+     * @brief       Find the scalar (bool, int64, uint64 or double) value associated with the given key.
+     * @details     For map nodes created with scalar slots (@see INodeFactory::Options) the value is read
+     *              w/o node lock, so it's the fast path for values read far more often than written.
+     * @param _key  The key.
+     * @return      The scalar value with timestamp, or an empty value if key not found or value is not scalar.
+     */
+    virtual XValueRT AtScalar(const XKey& _key) const                              = 0;
 
     /**
     * @brief                Iterate over the node items and apply the specified function on each item.
@@ -241,6 +350,33 @@ public:
     virtual bool ForPatch(std::function<bool(const XKey&, const XValueRT&)>&& _pf_on_item,
                           const XKey&                                         _from_key = XKey()) const = 0;
 
+    /**
+    * @brief                Iterate over the node items w/o copies (e.g. for serialization), erased items are skipped.
+    * @param _pf_on_item    Function that will be applied to each item, return \c true for stop iteration.
+    *                       The key and value references are valid only during the call.
+    * @param   _from_key    The starting key in the container. If set to the empty key (default),
+    *                       the function will be called on all items in the container.
+    * @returns              false if container is empty or _from_key not found
+    * @note                 The function is called under node read lock (or for read snapshot, @see
+    *                       INodeFactory::Options::read_snapshots): it should not change the node, wait for its
+    *                       writers or access nested nodes - locking of child under parent lock could deadlock with
+    *                       xnode::Transaction commit, collect nested nodes and process them after the call.
+    *                       Unlike BulkGetAll(), nested nodes are not converted to const objects, do not change
+    *                       them via the passed values.
+    */
+    virtual bool Visit(std::function<bool(const XKey&, const XValueRT&)>&& _pf_on_item,
+                       const XKey&                                         _from_key = XKey()) const = 0;
+
+    /**
+    * @brief                Remove erased items (kept for @ref ForPatch) from the map node.
+    * @param _keep_msec     Erased items younger than this time (in milliseconds) are kept,
+    *                       zero (default) - remove all erased items.
+    * @returns              Number of removed erased items (always zero for array nodes).
+    * @note                 Erased items are also compacted automatically, see
+    *                       INodeFactory::Options::erased_ratio_max and INodeFactory::Options::erased_keep_msec.
+    */
+    virtual size_t ErasedCompact(double _keep_msec = 0) = 0;
+
     // Method for take, Erase, change items via callback
     /**
      * @brief               Iterate over the node items and apply the specified function on each item.
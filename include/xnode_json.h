@@ -2,6 +2,9 @@
 
 #include "xnode_interfaces.h"
 
+#include <cstdio>
+#include <functional>
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -24,6 +27,30 @@ namespace xsdk::xnode {
  */
 std::pair<INode::SPtr, size_t> FromJson(std::string_view _json, uint64_t _uid = 0, std::string_view _name = {});
 
+/**
+ * @brief Parses the JSON buffer in place (w/o copies of strings), the buffer is owned by the resulting tree.
+ * @details The strings are unescaped over the buffer data: the string values longer than
+ *          xnode::StringShort::kSizeMax refer to the buffer (@see xnode::StringBuffer), the buffer is released
+ *          with the last value referring to it. Keys are interned as for FromJson().
+ *
+ * @param _data_p The JSON data (modified by parse), e.g. mapped file with private copy-on-write mapping and
+ *                deleter which unmaps it. Zero terminator is not required.
+ * @param _size   The size of JSON data.
+ * @param _uid    The unique identifier for the resulting node.
+ * @param _name   The name to be given to the resulting node.
+ *
+ * @return A std::pair consisting of an INode pointer and the error position if any. @see FromJson()
+ */
+std::pair<INode::SPtr, size_t> FromJsonInsitu(std::shared_ptr<char> _data_p,
+                                              size_t                _size,
+                                              uint64_t              _uid  = 0,
+                                              std::string_view      _name = {});
+/**
+ * @brief Parses the JSON string in place (w/o copies of strings), the string is owned by the resulting tree.
+ * @see FromJsonInsitu(std::shared_ptr<char>, size_t, uint64_t, std::string_view)
+ */
+std::pair<INode::SPtr, size_t> FromJsonInsitu(std::string&& _json, uint64_t _uid = 0, std::string_view _name = {});
+
 /**
  * @brief Enum class representing different JSON format options.
  * @details This enum class defines three different JSON format options: kOneLine, kOneLineArrays and kPretty.
@@ -63,6 +90,113 @@ std::string ToJson(const INode::SPtrC& _node_this,
                    JsonFormat          _json_format       = JsonFormat::kOneLineArrays,
                    size_t              _indent_char_count = kExportIndentCount,
                    char                _indent_char       = kExportIndentChar);
+/**
+ * @brief Function to convert an INode object to json format string (for calls with \c nullptr item function).
+ * @see ToJson(const INode::SPtrC&, OnCopyPF&, JsonFormat, size_t, char)
+ */
+inline std::string ToJson(const INode::SPtrC& _node_this,
+                          std::nullptr_t,
+                          JsonFormat _json_format       = JsonFormat::kOneLineArrays,
+                          size_t     _indent_char_count = kExportIndentCount,
+                          char       _indent_char       = kExportIndentChar)
+{
+    return ToJson(_node_this, OnCopyPF(nullptr), _json_format, _indent_char_count, _indent_char);
+}
+
+/**
+ * @brief Options of parallel json serialization. @see ToJsonParallel()
+ */
+struct JsonParallelOptions {
+    /// Count of threads (including calling one), zero - std::thread::hardware_concurrency().
+    size_t threads          = 0;
+    /// Nested nodes of nodes with at least this count of items are serialized by separate tasks, grouped by
+    /// about the same count of items. Trees with smaller root node are serialized by calling thread only.
+    size_t subtree_size_min = 1024;
+};
+
+/**
+ * @brief Function to convert an INode object to json format string using several threads.
+ * @details The nested nodes of large nodes are serialized into separate buffers by tasks of work stealing pool
+ *          and joined in order, so the output is the same as ToJson() output (byte to byte).
+ *
+ * @param _node_this          The INode object to be converted to json format.
+ * @param _json_format        The desired json format. @see JsonFormat.
+ * @param _indent_char_count  Number of characters for indentation <EM> (skipped for one line format)</EM>.
+ * @param _indent_char        Character used for indentation <EM> (skipped for one line format)</EM>.
+ * @param _options            Threads count and size of nodes for split. @see JsonParallelOptions
+ *
+ * @return Returns a std::string containing the json format representation of the INode object.
+ */
+std::string ToJsonParallel(const INode::SPtrC&        _node_this,
+                           JsonFormat                 _json_format       = JsonFormat::kOneLineArrays,
+                           size_t                     _indent_char_count = kExportIndentCount,
+                           char                       _indent_char       = kExportIndentChar,
+                           const JsonParallelOptions& _options           = {});
+
+/**
+ * @brief A type alias for sink of streamed json, called with consecutive chunks of output:
+ * @code
+ * bool onChunk(std::string_view _chunk) // Returns false for stop output (e.g. on write error)
+ * @endcode
+ */
+using JsonChunkPF = std::function<bool(std::string_view)>;
+
+/**
+ * @brief Function to stream INode object in json format to sink w/o accumulating of whole output.
+ * @details The output is passed to sink by chunks of _chunk_size bytes and the rest of output at the end.
+ *          The sink is called between nodes and between pages of about _chunk_size bytes of node items, w/o node
+ *          locks held, so memory usage does not depend on output size (it is bounded by chunk size plus output of
+ *          the largest single value).
+ *
+ * @param _node_this          The INode object to be converted to json format.
+ * @param _pf_chunk           The sink of output chunks.
+ * @param _json_format        The desired json format. @see JsonFormat.
+ * @param _indent_char_count  Number of characters for indentation <EM> (skipped for one line format)</EM>.
+ * @param _indent_char        Character used for indentation <EM> (skipped for one line format)</EM>.
+ * @param _chunk_size         Max size of chunk passed to sink.
+ *
+ * @return \c true if whole output is passed to sink, \c false if node is null or sink failed (the rest of
+ *         output is skipped).
+ */
+bool ToJson(const INode::SPtrC& _node_this,
+            const JsonChunkPF&  _pf_chunk,
+            JsonFormat          _json_format       = JsonFormat::kOneLineArrays,
+            size_t              _indent_char_count = kExportIndentCount,
+            char                _indent_char       = kExportIndentChar,
+            size_t              _chunk_size        = kExportChunkSize);
+/**
+ * @brief Function to stream INode object in json format to output stream. @see ToJson(const INode::SPtrC&,
+ *        const JsonChunkPF&, JsonFormat, size_t, char, size_t)
+ * @return \c false if node is null or stream failed.
+ */
+bool ToJson(const INode::SPtrC& _node_this,
+            std::ostream&       _stream,
+            JsonFormat          _json_format       = JsonFormat::kOneLineArrays,
+            size_t              _indent_char_count = kExportIndentCount,
+            char                _indent_char       = kExportIndentChar,
+            size_t              _chunk_size        = kExportChunkSize);
+/**
+ * @brief Function to stream INode object in json format to C file (not closed by function). @see ToJson(const
+ *        INode::SPtrC&, const JsonChunkPF&, JsonFormat, size_t, char, size_t)
+ * @return \c false if node or file is null or write failed.
+ */
+bool ToJson(const INode::SPtrC& _node_this,
+            std::FILE*          _file_p,
+            JsonFormat          _json_format       = JsonFormat::kOneLineArrays,
+            size_t              _indent_char_count = kExportIndentCount,
+            char                _indent_char       = kExportIndentChar,
+            size_t              _chunk_size        = kExportChunkSize);
+/**
+ * @brief Function to stream INode object in json format to file descriptor, e.g. file or socket (not closed by
+ *        function). @see ToJson(const INode::SPtrC&, const JsonChunkPF&, JsonFormat, size_t, char, size_t)
+ * @return \c false if node is null or write failed.
+ */
+bool ToJson(const INode::SPtrC& _node_this,
+            int                 _fd,
+            JsonFormat          _json_format       = JsonFormat::kOneLineArrays,
+            size_t              _indent_char_count = kExportIndentCount,
+            char                _indent_char       = kExportIndentChar,
+            size_t              _chunk_size        = kExportChunkSize);
 
 ///@}
 
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "xkey/xpath.h"
+#include "xnode_interfaces.h"
+
+#include <memory>
+#include <vector>
+
+namespace xsdk::xnode {
+
+/**
+ * @brief XPath compiled for repeated resolution (e.g. periodical reading of the same values).
+ * @details The path is parsed once and string keys are interned, so lookups of keys are done w/o allocations.
+ *          If nodes caching is enabled, the intermediate nodes are kept as weak pointers together with
+ *          generation of their parents (@see INode::Generation()). While the nodes structure is not changed
+ *          the resolution only checks generations (no locks and no keys lookups).
+ * @note    The object itself is not thread safe (the cache is updated on resolution), use one object per thread.
+ */
+class CompiledPath {
+public:
+    /**
+     * @brief Compiles the path.
+     * @param _path         The path to compile.
+     * @param _cache_nodes  If \c true, the resolved intermediate nodes are cached.
+     */
+    explicit CompiledPath(XPath _path, bool _cache_nodes = true);
+
+    /// @brief Returns the compiled path.
+    const XPath& Path() const { return path_; }
+    /// @brief Drops the cached nodes.
+    void         CacheReset();
+
+    /**
+     * @brief  Retrieves the node at the path (w/o nodes creation).
+     * @param  _root The node to start resolution from.
+     * @return The node at the path or nullptr if the path does not exist.
+     */
+    INode::SPtr               NodeGet(const INode::SPtr& _root);
+    /**
+     * @brief  Retrieves the value at the path. @see xnode::At()
+     * @param  _root The node to start resolution from.
+     * @return The value at the path or empty value if the path does not exist.
+     */
+    XValueRT                  At(const INode::SPtr& _root);
+    /**
+     * @brief  Sets the value at the path, the missed intermediate nodes are created. @see xnode::Set()
+     * @param  _root The node to start resolution from.
+     * @param  _val  The value to set.
+     * @return A pair of a boolean indicating success and the value of the target element.
+     */
+    std::pair<bool, XValueRT> Set(const INode::SPtr& _root, XValue&& _val);
+    /**
+     * @brief  Erases the value at the path. @see xnode::Erase()
+     * @param  _root The node to start resolution from.
+     * @return The erased value.
+     */
+    XValueRT                  Erase(const INode::SPtr& _root);
+
+private:
+    struct Level {
+        std::weak_ptr<INode> node_wp;
+        uint64_t             parent_generation = 0;
+    };
+
+    // Resolve node for first _depth keys
+    INode::SPtr Resolve_(const INode::SPtr& _root, size_t _depth);
+
+    const XPath          path_;
+    const bool           cache_nodes_;
+    std::weak_ptr<INode> root_wp_;
+    std::vector<Level>   levels_; // levels_[i] - node for keys [0..i]
+};
+
+} // namespace xsdk::xnode
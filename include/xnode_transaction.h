@@ -0,0 +1,67 @@
+#pragma once
+
+#include "xkey/xpath.h"
+#include "xnode_interfaces.h"
+
+#include <utility>
+#include <vector>
+
+namespace xsdk::xnode {
+
+/**
+ * @brief Atomic changes of several values in different nodes of subtree.
+ * @details The writes are gathered w/o locks and applied by Commit(): the affected nodes are locked in
+ *          deadlock-free order (by node address), all writes are applied and the nodes are unlocked. So locked
+ *          readers (At(), BulkGet() etc.) observe either none or all of the changes. Several writes of the same
+ *          key are coalesced into one change, changes of each node are passed to node callbacks together.
+ *          If any change is vetoed by callbacks (or failed), all applied changes are reverted and callbacks
+ *          of already approved changes are called with CallbackReason::Rollback.
+ * @note    Callbacks are called under lock of the changed node (as for single changes), so they should not
+ *          access other nodes of the transaction. Readers of lock-free copies (read snapshots or scalar slots,
+ *          @see INodeFactory::Options) could observe the changes of nodes separately.
+ * @note    The object itself is not thread safe, use one object per thread.
+ */
+class Transaction {
+public:
+    /**
+     * @brief Creates empty transaction.
+     * @param _root The root of subtree, the paths of writes are relative to it.
+     */
+    explicit Transaction(INode::SPtr _root);
+
+    /// @brief Returns the root of subtree.
+    const INode::SPtr& Root() const { return root_p_; }
+    /// @brief Returns the count of gathered writes.
+    size_t             Size() const { return writes_.size(); }
+    /// @brief Discards the gathered writes.
+    void               Reset() { writes_.clear(); }
+
+    /**
+     * @brief  Adds write of value, the missed intermediate nodes are created on Commit() (before nodes locks, so
+     *         they are visible to other threads and callbacks are called for them) and removed if the transaction
+     *         is aborted. @see xnode::Set()
+     * @param  _path The path of value (relative to root).
+     * @param  _val  The value to set, nodes are not allowed (the nodes structure is changed by regular methods).
+     * @return \c false if the path is empty or value is node.
+     */
+    bool Set(XPath _path, XValue&& _val);
+    /**
+     * @brief  Adds erase of value. @see xnode::Erase()
+     * @param  _path The path of value (relative to root).
+     * @return \c false if the path is empty.
+     */
+    bool Erase(XPath _path);
+
+    /**
+     * @brief  Applies the gathered writes atomically, the writes are discarded after commit.
+     * @return \c true if all writes are applied, \c false if the transaction was aborted (no changes made,
+     *         the created intermediate nodes are removed).
+     */
+    bool Commit();
+
+private:
+    const INode::SPtr                     root_p_;
+    std::vector<std::pair<XPath, XValue>> writes_; // Empty value - erase
+};
+
+} // namespace xsdk::xnode
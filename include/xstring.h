@@ -2,9 +2,15 @@
 
 #include "xbase.h"
 
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
 
 namespace xsdk::xnode {
 
@@ -33,4 +39,209 @@ public:
     }
 };
 
+/**
+ * @brief Inline (w/o heap allocation) storage for short strings, used by XValue for strings up to kSizeMax chars.
+ * @details Size of storage is the same as size of shared pointer, so XValue size is not increased.
+ *          The last byte keeps (kSizeMax - size): it's zero (string terminator) for string of kSizeMax chars,
+ *          so stored string is always zero terminated.
+ */
+class StringShort {
+public:
+    /// @brief The maximum size of string which could be stored inline.
+    static constexpr size_t kSizeMax = sizeof(std::shared_ptr<const std::string>) - 1;
+
+    /**
+     * @brief Constructs an inline string from a string_view.
+     * @param _str The string to store, should be not longer than kSizeMax.
+     */
+    explicit StringShort(std::string_view _str)
+    {
+        assert(_str.size() <= kSizeMax);
+        std::memcpy(data_, _str.data(), _str.size());
+        data_[kSizeMax] = static_cast<char>(kSizeMax - _str.size());
+    }
+
+    /// @brief Returns the size of stored string.
+    size_t size() const { return kSizeMax - static_cast<size_t>(data_[kSizeMax]); }
+    /// @brief Returns the zero terminated stored string.
+    const char* c_str() const { return data_; }
+    /// @brief Returns the stored string view.
+    std::string_view view() const { return {data_, size()}; }
+
+    bool operator==(const StringShort& _other) const { return view() == _other.view(); }
+    bool operator<(const StringShort& _other) const { return view() < _other.view(); }
+
+private:
+    char data_[kSizeMax + 1] = {};
+};
+
+/**
+ * @brief Shared buffer of strings referred by values w/o copies (e.g. JSON parsed in place, @see FromJsonInsitu()).
+ * @details The buffer owns the source data and keeps views of strings from it, XValue holds the pointer to view
+ *          which shares ownership of whole buffer: the data is released with the last value referring to it.
+ *          Views are added by single thread (e.g. parser), the pointers to views could be used by any threads.
+ * @note    The viewed strings should be zero terminated (as strings parsed in place).
+ */
+class StringBuffer {
+public:
+    /// @brief The pointer to view of string, shares ownership of the buffer.
+    using ViewPtrC = std::shared_ptr<const std::string_view>;
+
+    /**
+     * @brief Creates buffer which owns the data.
+     * @param _data_p The data of buffer (could be released by custom deleter, e.g. unmapped file).
+     */
+    static std::shared_ptr<StringBuffer> Create(std::shared_ptr<char> _data_p)
+    {
+        return std::make_shared<StringBuffer>(std::move(_data_p));
+    }
+
+    /**
+     * @brief Adds view of string from the buffer data.
+     * @param _buffer_p The buffer.
+     * @param _str      The zero terminated string from the buffer data.
+     * @return The pointer to view (w/o allocation of own control block).
+     */
+    static ViewPtrC View(const std::shared_ptr<StringBuffer>& _buffer_p, std::string_view _str)
+    {
+        assert(_str.data()[_str.size()] == '\0');
+        _buffer_p->views_.push_back(_str);
+        return ViewPtrC(_buffer_p, &_buffer_p->views_.back());
+    }
+
+    /// @brief Constructs buffer which owns the data, @see Create().
+    explicit StringBuffer(std::shared_ptr<char> _data_p) : data_p_(std::move(_data_p)) {}
+
+    /// @brief Returns the data of buffer.
+    const char* data() const { return data_p_.get(); }
+    /// @brief Returns count of views.
+    size_t      size() const { return views_.size(); }
+
+private:
+    std::shared_ptr<char>        data_p_;
+    std::deque<std::string_view> views_; // Stable addresses for values pointers
+};
+
+/**
+ * @brief Interned string: atoms with equal strings share one immutable instance from the process-wide intern
+ *        table, so atoms are copied w/o allocations and compared for equality by pointer.
+ * @details Interned strings are reference counted: the string is removed from the table with the last atom,
+ *          so the table size is bounded by the count of strings in use (e.g. keys of existing nodes). Lookup in
+ *          the table is lock-free, insertion and removal of a string lock one table shard.
+ *          Borrowed atoms (@see Borrow()) are not counted: lookups do not write shared memory.
+ *          Empty string is represented by empty atom (no table entry).
+ */
+class StringAtom {
+public:
+    /// @brief Constructs an empty atom.
+    StringAtom() = default;
+    /**
+     * @brief Constructs an atom from a string, the string is added to the intern table if not yet interned.
+     * @param _str The string to intern.
+     */
+    explicit StringAtom(std::string_view _str) : StringAtom(Intern_(_str, true)) {}
+
+    /// @brief Copy constructor, copy of borrowed atom is owning atom.
+    StringAtom(const StringAtom& _other) : bits_(_other.bits_)
+    {
+        if (bits_ & kBorrowed)
+            bits_ = reinterpret_cast<uintptr_t>(Acquire_(_other.Entry_()));
+        else if (bits_)
+            Entry_()->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    StringAtom(StringAtom&& _other) noexcept : bits_(std::exchange(_other.bits_, 0)) {}
+    ~StringAtom()
+    {
+        if (bits_ & kBorrowed)
+            Leave_();
+        else if (bits_)
+            Release_(Entry_());
+    }
+
+    StringAtom& operator=(const StringAtom& _other)
+    {
+        StringAtom(_other).swap(*this);
+        return *this;
+    }
+    StringAtom& operator=(StringAtom&& _other) noexcept
+    {
+        StringAtom(std::move(_other)).swap(*this);
+        return *this;
+    }
+
+    void swap(StringAtom& _other) noexcept { std::swap(bits_, _other.bits_); }
+
+    /**
+     * @brief Finds an already interned string (w/o insertion into the table).
+     * @param _str The string to find.
+     * @return The atom of string, or empty atom if the string was never interned.
+     */
+    static StringAtom Find(std::string_view _str) { return StringAtom(Intern_(_str, false)); }
+    /**
+     * @brief Finds an already interned string w/o reference counting, e.g. for lookup of key in containers.
+     * @details Borrowed atom keeps the string by reclamation critical section of thread (@see impl::XEpoch),
+     *          so it's not removed from memory until the atom is destroyed (but could be removed from the table).
+     * @note Borrowed atom should be short lived and destroyed by the same thread (could be moved only within
+     *       the thread), its copies are owning atoms.
+     * @param _str The string to find.
+     * @return The borrowed atom of string, or empty atom if the string is not interned.
+     */
+    static StringAtom Borrow(std::string_view _str);
+    /**
+     * @brief Returns borrowed atom of the same string (@see Borrow(std::string_view)).
+     * @param _atom The atom to borrow.
+     */
+    static StringAtom Borrow(const StringAtom& _atom);
+    /// @brief Returns count of interned strings (in use by atoms).
+    static size_t Count();
+
+    /// @brief Returns the interned string.
+    const std::string& str() const { return bits_ ? Entry_()->str : Empty_(); }
+    /// @brief Returns the interned string view.
+    std::string_view view() const { return str(); }
+    /// @brief Returns the size of interned string.
+    size_t size() const { return str().size(); }
+    /// @brief Returns true for empty atom.
+    bool empty() const { return !bits_; }
+    /// @brief Returns true for borrowed atom (@see Borrow()).
+    bool borrowed() const { return bits_ & kBorrowed; }
+    /// @brief Returns the hash of interned string (the same as std::hash<std::string_view>, computed once).
+    size_t hash() const { return bits_ ? Entry_()->hash : 0; }
+
+    bool operator==(const StringAtom& _other) const { return Entry_() == _other.Entry_(); }
+    bool operator!=(const StringAtom& _other) const { return Entry_() != _other.Entry_(); }
+    // Strings order (not pointers) for keep sorted containers order
+    bool operator<(const StringAtom& _other) const { return Entry_() != _other.Entry_() && view() < _other.view(); }
+
+private:
+    struct Entry {
+        size_t                      hash = 0;
+        std::string                 str;
+        mutable std::atomic<size_t> refs = 1; // Count of atoms, the entry is removed from table with the last one
+    };
+    class Table;
+
+    // Low bit of entry pointer: the atom is borrowed (not counted)
+    static constexpr uintptr_t kBorrowed = 1;
+
+    // Adopts reference of entry
+    explicit StringAtom(const Entry* _entry_p) : bits_(reinterpret_cast<uintptr_t>(_entry_p)) {}
+
+    const Entry* Entry_() const { return reinterpret_cast<const Entry*>(bits_ & ~kBorrowed); }
+
+    // Returns the entry with added reference
+    static const Entry*       Intern_(std::string_view _str, bool _insert);
+    // Returns the entry (or entry of the same string if released) with added reference
+    static const Entry*       Acquire_(const Entry* _entry_p);
+    static void               Release_(const Entry* _entry_p);
+    static void               Leave_();
+    static const std::string& Empty_()
+    {
+        static const std::string empty;
+        return empty;
+    }
+
+    uintptr_t bits_ = 0; // Entry pointer and kBorrowed flag
+};
+
 } // namespace xsdk::xnode
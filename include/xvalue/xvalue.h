@@ -19,10 +19,20 @@ using XValueNull = const void*;
 
 /**
  * @brief XVariant is a variant type template which can store various values: monostate,
- * empty, null, bool, integers, floating-point numbers, strings, and objects.
+ * empty, null, bool, integers, floating-point numbers, strings (short inline, shared or views of shared buffer),
+ * and objects.
  */
-using XVariant = std::
-    variant<std::monostate, XValueNull, bool, int64_t, uint64_t, double, xnode::String::SPtrC, IObject::SPtrC, IObject::SPtr>;
+using XVariant = std::variant<std::monostate,
+                              XValueNull,
+                              bool,
+                              int64_t,
+                              uint64_t,
+                              double,
+                              xnode::StringShort,
+                              xnode::String::SPtrC,
+                              xnode::StringBuffer::ViewPtrC,
+                              IObject::SPtrC,
+                              IObject::SPtr>;
 
 /**
 * @brief A utility class used for storing and manipulating values.
@@ -123,18 +133,24 @@ public:
     ///@}
 
     ///@name String constructors
+    /// @note Strings up to xnode::StringShort::kSizeMax chars are stored inline (w/o heap allocation)
     ///@{
     // xo_string
     /** @brief Move constructor an XValue from a std::string value.*/
-    XValue(std::string&& _str) : XVariant(std::make_shared<const std::string>(std::move(_str))) {}
+    XValue(std::string&& _str) : XVariant(StringMake_(std::move(_str))) {}
     /// @brief Copy constructor an XValue from a std::string value.
-    XValue(const std::string& _str) : XVariant(std::make_shared<const std::string>(_str)) {}
+    XValue(const std::string& _str) : XVariant(StringMake_(std::string_view(_str))) {}
     /// @brief Constructor an XValue from a std::string_view object.
-    XValue(std::string_view _str) : XVariant(std::make_shared<const std::string>(_str)) {}
+    XValue(std::string_view _str) : XVariant(StringMake_(_str)) {}
     /// @brief Constructor an XValue from a char*.
-    XValue(char* _psz) : XVariant(std::make_shared<const std::string>(_psz ? (const char*)_psz : "")) {}
+    XValue(char* _psz) : XVariant(StringMake_(std::string_view(_psz ? (const char*)_psz : ""))) {}
     /// @brief Constructor an XValue from a const char*.
-    XValue(const char* _psz) : XVariant(std::make_shared<const std::string>(_psz ? _psz : "")) {}
+    XValue(const char* _psz) : XVariant(StringMake_(std::string_view(_psz ? _psz : ""))) {}
+    /**
+     * @brief Constructor an XValue from a view of string in shared buffer (w/o copy of string).
+     * @note  Intended for long strings: the short ones are stored inline w/o buffer reference.
+     */
+    XValue(xnode::StringBuffer::ViewPtrC&& _view_p) : XVariant(std::move(_view_p)) {}
     ///@}
 
     ///@name Object constructors
@@ -270,6 +286,26 @@ public:
         auto sp_obj = xobject::PtrQuery<TObject>(ObjectPtrC().get());
         return sp_obj ? sp_obj : _default;
     }
+
+private:
+    // Short strings are stored inline, long strings are shared (copy w/o allocation)
+    static XVariant StringMake_(std::string_view _str)
+    {
+        if (_str.size() <= xnode::StringShort::kSizeMax)
+            return xnode::StringShort(_str);
+
+        return std::make_shared<const std::string>(_str);
+    }
+    static XVariant StringMake_(std::string&& _str)
+    {
+        if (_str.size() <= xnode::StringShort::kSizeMax)
+            return xnode::StringShort(_str);
+
+        return std::make_shared<const std::string>(std::move(_str));
+    }
+
+    // Return zero terminated string for both string representations, nullptr for not string values
+    const char* StringC_() const noexcept;
 };
 
 } // namespace xsdk
\ No newline at end of file
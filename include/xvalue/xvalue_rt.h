@@ -4,6 +4,11 @@
 #include "xtimed.h"
 #include "xvalue.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ratio>
+
 namespace xsdk {
 
 namespace xnode {
@@ -70,13 +75,78 @@ namespace xnode {
         constexpr static uint32_t TicksPerSecond() { return TicksPerSecondT; }
     };
 
+    /**
+     * @brief ShardedClock template class generating unique timestamps without a single shared atomic.
+     *
+     * Low bits of timestamp are the shard index: each thread is bound to one of (1 << ShardsBitsT) shards
+     * (round-robin on first use) and only threads of the same shard share the (cache line aligned) last clock tick.
+     * Timestamps are unique and monotonic per shard only: timestamps of different threads are not ordered within
+     * clock tick (4 nsec by default, could be much coarser for some clocks). Nodes order own changes explicitly
+     * (change timestamp is greater than timestamp of previous change of node).
+     *
+     * @note With default parameters timestamps range is about 18 years from ClockT epoch (e.g. system boot).
+     *
+     * @tparam ClockT Type of clock to use.
+     * @tparam TicksPerSecondT Number of clock ticks per second (timestamp ticks per second are multiplied by shards).
+     * @tparam ShardsBitsT Number of bits for shard index.
+     */
+    template <class ClockT = std::chrono::steady_clock, size_t TicksPerSecondT = 250'000'000, size_t ShardsBitsT = 6>
+    class ShardedClock {
+        static constexpr size_t kShards = size_t(1) << ShardsBitsT;
+
+        struct alignas(64) Shard {
+            std::atomic_int64_t tick_last = {};
+        };
+
+    public:
+        /**
+         * @brief Generates the current unique timestamp.
+         * @return The current unique timestamp (in 1 / TicksPerSecond() units).
+         */
+        static int64_t Timestamp()
+        {
+            static_assert(TicksPerSecondT > 0 && ShardsBitsT > 0 && ShardsBitsT < 16);
+            using Ticks = std::chrono::duration<int64_t, std::ratio<1, TicksPerSecondT>>;
+
+            static Shard              shards[kShards];
+            static std::atomic_size_t shards_next = 0;
+            thread_local const size_t shard_idx   = shards_next.fetch_add(1, std::memory_order_relaxed) % kShards;
+
+            auto tick = std::chrono::duration_cast<Ticks>(ClockT::now().time_since_epoch()).count();
+
+            auto&   tick_last = shards[shard_idx].tick_last;
+            auto    prev      = tick_last.load(std::memory_order_relaxed);
+            int64_t next      = 0;
+            do {
+                next = std::max(tick, prev + 1);
+            } while (!tick_last.compare_exchange_weak(prev, next, std::memory_order_relaxed));
+
+            return (next << ShardsBitsT) | (int64_t)shard_idx;
+        }
+
+        /**
+         * @brief The number of timestamp ticks per second.
+         */
+        constexpr static int64_t TicksPerSecond() { return (int64_t)(TicksPerSecondT * kShards); }
+    };
+
 } // namespace xnode
 
+#ifdef XNODE_SHARDED_CLOCK
+/**
+ * @brief XValueRT is a wrapper of XValue class using ShardedClock to generate unique timestamps
+ * (enabled by WITH_SHARDED_CLOCK cmake option).
+ * @tparam XValue The data type to store.
+ * @tparam XTimed A clock type that generates unique monotonic timestamps.
+ */
+using XValueRT = XTimed<XValue, xnode::ShardedClock<>>;
+#else
 /**
  * @brief XValueRT is a wrapper of XValue class using UniqueClock to generate unique monotonic timestamps.
  * @tparam XValue The data type to store.
  * @tparam XTimed A clock type that generates unique monotonic timestamps.
  */
 using XValueRT = XTimed<XValue, xnode::UniqueClock<>>;
+#endif
 
 } // namespace xsdk
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "xcontainer_factory_impl.h"
 
 #include "../impl/xcontainer_array.h"
+#include "../impl/xcontainer_flat_map.h"
+#include "../impl/xcontainer_hash_map.h"
 #include "../impl/xcontainer_map.h"
 #include "../impl/xcontainer_map_w_erase.h"
 
@@ -24,18 +26,43 @@ std::shared_ptr<IContainerFactory> XContainerFactory::create()
 }
 
 /*virtual*/ std::unique_ptr<IContainer> XContainerFactory::ContainerCreate(IContainer::ContainerType _type,
-                                                                           bool                      _erase_detection)
+                                                                           bool                      _erase_detection,
+                                                                           MapLayout                 _map_layout,
+                                                                           ArrayLayout               _array_layout,
+                                                                           bool                      _values_timed)
+{
+    if (_values_timed)
+        return ContainerCreate_<IContainer::MappedType>(_type, _erase_detection, _map_layout, _array_layout);
+
+    return ContainerCreate_<XValue>(_type, _erase_detection, _map_layout, _array_layout);
+}
+
+template <class TStored>
+std::unique_ptr<IContainer> XContainerFactory::ContainerCreate_(IContainer::ContainerType _type,
+                                                                bool                      _erase_detection,
+                                                                MapLayout                 _map_layout,
+                                                                ArrayLayout               _array_layout)
 {
     if (_type == IContainer::ContainerType::Array) {
         assert(!_erase_detection);
-        return std::make_unique<XContainerArray>();
+        if (_array_layout == ArrayLayout::Deque)
+            return std::make_unique<XContainerArray<std::deque<TStored>>>();
+
+        assert(_array_layout == ArrayLayout::Vector);
+        return std::make_unique<XContainerArray<std::vector<TStored>>>();
     }
 
     assert(_type == IContainer::ContainerType::Map);
-    if (_erase_detection)
-        return std::make_unique<XContainerMapWithErase>();
+    switch (_map_layout) {
+        case MapLayout::Hash: return MapCreate_<XContainerHashMap<false, TStored>>(_erase_detection);
+        case MapLayout::HashOrdered: return MapCreate_<XContainerHashMap<true, TStored>>(_erase_detection);
+        case MapLayout::Flat: return MapCreate_<XContainerFlatMap<XContainerMap<TStored>>>(_erase_detection);
+        case MapLayout::FlatHash:
+            return MapCreate_<XContainerFlatMap<XContainerHashMap<false, TStored>>>(_erase_detection);
+        default: assert(_map_layout == MapLayout::Tree);
+    }
 
-    return std::make_unique<XContainerMap>();
+    return MapCreate_<XContainerMap<TStored>>(_erase_detection);
 }
 
 } // namespace impl
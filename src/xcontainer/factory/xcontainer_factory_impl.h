@@ -2,6 +2,8 @@
 
 #include "../xcontainer_factory.h"
 
+#include "../impl/xcontainer_map_w_erase.h"
+
 #include <cassert>
 #include <memory>
 #include <string>
@@ -17,7 +19,27 @@ public:
 
 public:
     virtual std::unique_ptr<IContainer> ContainerCreate(IContainer::ContainerType _type,
-                                                        bool                      _erase_detection) override;
+                                                        bool                      _erase_detection,
+                                                        MapLayout                 _map_layout,
+                                                        ArrayLayout               _array_layout,
+                                                        bool                      _values_timed) override;
+
+private:
+    template <class TMap>
+    static std::unique_ptr<IContainer> MapCreate_(bool _erase_detection)
+    {
+        if (_erase_detection)
+            return std::make_unique<XContainerMapWithErase<TMap>>();
+
+        return std::make_unique<TMap>();
+    }
+
+    // TStored - IContainer::MappedType or XValue (values w/o own timestamps)
+    template <class TStored>
+    static std::unique_ptr<IContainer> ContainerCreate_(IContainer::ContainerType _type,
+                                                        bool                      _erase_detection,
+                                                        MapLayout                 _map_layout,
+                                                        ArrayLayout               _array_layout);
 };
 
 } // namespace xsdk::impl
\ No newline at end of file
@@ -1,29 +1,36 @@
 #include "xcontainer_array.h"
 
+#include <algorithm>
 #include <cassert>
+#include <type_traits>
 
 namespace xsdk::impl {
 
-bool XContainerArray::IsKeyValid(const KeyType& _key) const { return KeyToIndex_(_key).has_value(); }
+template <class TValues>
+bool XContainerArray<TValues>::IsKeyValid(const KeyType& _key) const { return KeyToIndex_(_key).has_value(); }
 
-bool XContainerArray::Empty() const { return values_deq_.empty(); }
+template <class TValues>
+bool XContainerArray<TValues>::Empty() const { return values_.empty(); }
 
-size_t XContainerArray::Size() const { return values_deq_.size(); }
+template <class TValues>
+size_t XContainerArray<TValues>::Size() const { return values_.size(); }
 
 // Return 'false' if empty or key not found
-bool XContainerArray::ForEach(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
-                              const std::optional<KeyType>&                            _from_key) const
+template <class TValues>
+bool XContainerArray<TValues>::ForEach(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
+                                       const std::optional<KeyType>&                            _from_key) const
 {
-    auto it = values_deq_.begin();
+    auto it = values_.begin();
     if (_from_key.has_value())
-        it = DeqFind_(_from_key.value());
+        it = ValuesFind_(_from_key.value());
 
-    if (it == values_deq_.end())
+    if (it == values_.end())
         return false;
 
-    size_t idx = 0;
-    while (_pf_on_item && it != values_deq_.end()) {
-        if (_pf_on_item(IndexToKey_(idx++), *it))
+    // Keys are indexes in array (not from _from_key)
+    auto idx = static_cast<size_t>(it - values_.begin());
+    while (_pf_on_item && it != values_.end()) {
+        if (_pf_on_item(IndexToKey_(idx++), values_time_.Get(*it)))
             break;
 
         ++it;
@@ -33,30 +40,39 @@ bool XContainerArray::ForEach(std::function<bool(const KeyType&, const MappedTyp
 }
 
 // Return 'false' if empty or key not found
-bool XContainerArray::ForEach(std::function<OnEachRes(const KeyType&, MappedType&)>&& _pf_on_each,
-                              const std::optional<KeyType>&                           _from_key,
-                              const OnChangePF&                                       _pf_on_change)
+template <class TValues>
+bool XContainerArray<TValues>::ForEach(std::function<OnEachRes(const KeyType&, MappedType&)>&& _pf_on_each,
+                                       const std::optional<KeyType>&                           _from_key,
+                                       const OnChangePF&                                       _pf_on_change)
 {
-    auto it = values_deq_.begin();
+    auto it = values_.begin();
     if (_from_key.has_value())
-        it = DeqFind_(_from_key.value(), false);
+        it = ValuesFind_(_from_key.value(), false);
 
-    if (it == values_deq_.end())
+    if (it == values_.end())
         return false;
 
     if (_pf_on_each) {
-        size_t idx = 0;
-        while (it != values_deq_.end()) {
-            MappedType val = *it; // For detect chnaging
+        // Values timestamp is changed after loop (the same for all items in loop)
+        bool changed = false;
+        auto idx     = static_cast<size_t>(it - values_.begin());
+        while (it != values_.end()) {
+            MappedType val = values_time_.Get(*it); // For detect chnaging
             auto       res = _pf_on_each(KeyType(idx++), val);
             if ((res == OnEachRes::Erase || res == OnEachRes::EraseStop) &&
-                (!_pf_on_change || _pf_on_change(IndexToKey_(idx), *it, MappedType()))) {
+                (!_pf_on_change || _pf_on_change(IndexToKey_(idx), values_time_.Get(*it), MappedType()))) {
                 assert(val == *it);
-                it = values_deq_.erase(it);
+                ObjectRemove_(*it);
+                it      = values_.erase(it);
+                changed = true;
             }
             else {
-                if (val != *it && (!_pf_on_change || _pf_on_change(IndexToKey_(idx), *it, val)))
-                    *it = val;
+                if (val != *it && (!_pf_on_change || _pf_on_change(IndexToKey_(idx), values_time_.Get(*it), val))) {
+                    ObjectRemove_(*it);
+                    ObjectAdd_(val, it - values_.begin());
+                    *it     = val;
+                    changed = true;
+                }
 
                 ++it;
             }
@@ -64,98 +80,206 @@ bool XContainerArray::ForEach(std::function<OnEachRes(const KeyType&, MappedType
             if (res == OnEachRes::Stop || res == OnEachRes::EraseStop)
                 break;
         }
+
+        if (changed)
+            values_time_.Changed();
     }
 
     return true;
 }
 
-std::optional<IContainer::MappedType> XContainerArray::At(const KeyType& _key) const
+template <class TValues>
+std::optional<IContainer::MappedType> XContainerArray<TValues>::At(const KeyType& _key) const
+{
+    auto it = ValuesFind_(_key);
+    if (it == values_.end())
+        return std::nullopt;
+
+    return values_time_.Get(*it);
+}
+
+template <class TValues>
+size_t XContainerArray<TValues>::ValueCount(const MappedType& _val) const
+{
+    const auto* object_p = ObjectGet_(_val);
+    if (!object_p)
+        return IContainer::ValueCount(_val);
+
+    auto it = objects_.find(object_p);
+    return it != objects_.end() ? it->second.count : 0;
+}
+
+template <class TValues>
+std::optional<IContainer::KeyType> XContainerArray<TValues>::ObjectKey(const IObject* _object_p) const
 {
-    auto it = DeqFind_(_key);
-    if (it == values_deq_.end())
+    auto it = objects_.find(_object_p);
+    if (it == objects_.end() || values_.empty())
         return std::nullopt;
 
-    return *it;
+    // Search around the index of the last add (usually the object is there or shifted by few items)
+    auto hint = std::min(it->second.idx_hint, values_.size() - 1);
+    for (size_t dist = 0; dist <= std::max(hint, values_.size() - 1 - hint); ++dist) {
+        if (dist <= hint && ObjectGet_(values_[hint - dist]) == _object_p)
+            return IndexToKey_(hint - dist);
+        if (dist > 0 && hint + dist < values_.size() && ObjectGet_(values_[hint + dist]) == _object_p)
+            return IndexToKey_(hint + dist);
+    }
+
+    assert(!"object index is not consistent with values");
+    return std::nullopt;
 }
 
-std::pair<bool, IContainer::MappedType> XContainerArray::Set(const KeyType&    _key,
-                                                             const MappedType& _val,
-                                                             const OnChangePF& _pf_on_change)
+template <class TValues>
+std::pair<bool, IContainer::MappedType> XContainerArray<TValues>::Set(const KeyType&    _key,
+                                                                      const MappedType& _val,
+                                                                      const OnChangePF& _pf_on_change)
 {
     // todo: fill array to index
-    auto it = DeqFind_(_key, true);
-    if (it == values_deq_.end())
+    auto it = ValuesFind_(_key, true);
+    if (it == values_.end())
         return {false, MappedType()}; // 2think about res
 
-    if (ValueAt_(it) == _val)
-        return {false, *it}; // 2think about res
+    if (StoredAt_(it) == _val)
+        return {false, ValueAt_(it)}; // 2think about res
 
     if (_pf_on_change && !_pf_on_change(_key, ValueAt_(it), _val))
         return {false, ValueAt_(it)}; // 2think about res
 
-    return {true, std::exchange(*it, _val)};
+    ObjectRemove_(*it);
+    ObjectAdd_(_val, it - values_.begin());
+    return {true, values_time_.Exchange(*it, _val)};
 }
 
-std::pair<bool, IContainer::MappedType> XContainerArray::Set(const KeyType&    _key,
-                                                             MappedType&&      _val,
-                                                             const OnChangePF& _pf_on_change)
+template <class TValues>
+std::pair<bool, IContainer::MappedType> XContainerArray<TValues>::Set(const KeyType&    _key,
+                                                                      MappedType&&      _val,
+                                                                      const OnChangePF& _pf_on_change)
 {
     // todo: fill array to index
-    auto it = DeqFind_(_key, true);
-    if (it == values_deq_.end())
+    auto it = ValuesFind_(_key, true);
+    if (it == values_.end())
         return {false, MappedType()}; // 2think about res
 
-    if (ValueAt_(it) == _val)
-        return {false, *it}; // 2think about res
+    if (StoredAt_(it) == _val)
+        return {false, ValueAt_(it)}; // 2think about res
 
     if (_pf_on_change && !_pf_on_change(_key, ValueAt_(it), _val))
         return {false, ValueAt_(it)}; // 2think about res
 
-    return {true, std::exchange(*it, std::move(_val))};
+    ObjectRemove_(*it);
+    ObjectAdd_(_val, it - values_.begin());
+    return {true, values_time_.Exchange(*it, std::move(_val))};
 }
 
-IContainer::EmplaceRes XContainerArray::Emplace(const KeyType&    _key,
-                                                const MappedType& _val,
-                                                const OnChangePF& _pf_on_change)
+template <class TValues>
+IContainer::EmplaceRes XContainerArray<TValues>::Emplace(const KeyType&    _key,
+                                                         const MappedType& _val,
+                                                         const OnChangePF& _pf_on_change)
 {
-    auto it = DeqFind_(_key, false);
+    auto it = ValuesFind_(_key, false);
     if (_pf_on_change && !_pf_on_change(_key, ValueAt_(it), _val))
         return {false, KeyType(), ValueAt_(it)}; // 2think about res
 
-    it = values_deq_.insert(it, _val);
-    return {true, IndexToKey_(it - values_deq_.begin()), MappedType() /*_val*/};
+    ObjectAdd_(_val, it - values_.begin());
+    it = values_.insert(it, _val);
+    values_time_.Changed();
+    return {true, IndexToKey_(it - values_.begin()), MappedType() /*_val*/};
 }
 
-IContainer::EmplaceRes XContainerArray::Emplace(const KeyType& _key, MappedType&& _val, const OnChangePF& _pf_on_change)
+template <class TValues>
+IContainer::EmplaceRes XContainerArray<TValues>::Emplace(const KeyType&    _key,
+                                                         MappedType&&      _val,
+                                                         const OnChangePF& _pf_on_change)
 {
-    auto it = DeqFind_(_key, false);
+    auto it = ValuesFind_(_key, false);
     if (_pf_on_change && !_pf_on_change(_key, ValueAt_(it), _val))
         return {false, KeyType(), ValueAt_(it)}; // 2think about res
 
-    it = values_deq_.insert(it, std::move(_val));
-    return {true, IndexToKey_(it - values_deq_.begin()), MappedType() /**it*/};
+    ObjectAdd_(_val, it - values_.begin());
+    it = values_.insert(it, std::move(_val));
+    values_time_.Changed();
+    return {true, IndexToKey_(it - values_.begin()), MappedType() /**it*/};
 }
 
-std::optional<IContainer::MappedType> XContainerArray::Erase(const KeyType& _key, const OnChangePF& _pf_on_change)
+template <class TValues>
+std::optional<IContainer::MappedType> XContainerArray<TValues>::Erase(const KeyType&    _key,
+                                                                      const OnChangePF& _pf_on_change)
 {
-    auto it = DeqFind_(_key, false);
-    if (it == values_deq_.end())
+    auto it = ValuesFind_(_key, false);
+    if (it == values_.end())
         return std::nullopt;
 
-    if (_pf_on_change && !_pf_on_change(_key, *it, MappedType()))
+    if (_pf_on_change && !_pf_on_change(_key, ValueAt_(it), MappedType()))
         return std::nullopt; // 2think about res
 
-    auto val = std::move(*it);
-    values_deq_.erase(it);
+    ObjectRemove_(*it);
+    auto val = values_time_.Take(*it);
+    values_.erase(it);
+    values_time_.Changed();
     return val;
 }
 
-void XContainerArray::Clear() { values_deq_.clear(); }
+template <class TValues>
+void XContainerArray<TValues>::Clear()
+{
+    values_.clear();
+    objects_.clear();
+    values_time_.Changed();
+}
 
-inline const IContainer::MappedType& XContainerArray::ValueAt_(const typename std::deque<MappedType>::const_iterator& _it)
+template <class TValues>
+void XContainerArray<TValues>::Reserve(size_t _size)
+{
+    if constexpr (std::is_same_v<TValues, std::vector<typename TValues::value_type>>)
+        values_.reserve(_size);
+}
+
+template <class TValues>
+void XContainerArray<TValues>::ObjectAdd_(const XValue& _val, size_t _idx)
+{
+    const auto* object_p = ObjectGet_(_val);
+    if (!object_p)
+        return;
+
+    auto& entry    = objects_[object_p];
+    entry.idx_hint = _idx;
+    ++entry.count;
+}
+
+template <class TValues>
+void XContainerArray<TValues>::ObjectRemove_(const XValue& _val)
+{
+    const auto* object_p = ObjectGet_(_val);
+    if (!object_p)
+        return;
+
+    auto it = objects_.find(object_p);
+    assert(it != objects_.end() && it->second.count > 0);
+    if (it != objects_.end() && --it->second.count == 0)
+        objects_.erase(it);
+}
+
+template <class TValues>
+inline const XValue& XContainerArray<TValues>::StoredAt_(const typename TValues::const_iterator& _it) const
+{
+    static const XValue empty;
+    return _it != values_.end() ? *_it : empty;
+}
+
+template <class TValues>
+inline auto XContainerArray<TValues>::ValueAt_(const typename TValues::const_iterator& _it) const ->
+    typename ValuesTime::ValueRef
 {
     static const MappedType empty;
-    return _it != values_deq_.end() ? *_it : empty;
+    if (_it == values_.end())
+        return empty;
+
+    return values_time_.Get(*_it);
 }
 
+template class XContainerArray<std::vector<IContainer::MappedType>>;
+template class XContainerArray<std::deque<IContainer::MappedType>>;
+template class XContainerArray<std::vector<XValue>>;
+template class XContainerArray<std::deque<XValue>>;
+
 } // namespace xsdk::impl
\ No newline at end of file
@@ -1,18 +1,40 @@
 #pragma once
 
 #include "../xcontainer.h"
+#include "xcontainer_values.h"
 
 #include <deque>
 #include <functional>
 #include <optional>
+#include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 namespace xsdk::impl {
 
+// TValues - random access sequence: std::vector (default, contiguous) or std::deque
+//           of MappedType or XValue (values w/o own timestamps, see XValuesTime)
+template <class TValues = std::vector<IContainer::MappedType>>
 class XContainerArray: public IContainer {
 
-    std::deque<MappedType> values_deq_;
+    using ValuesTime = XValuesTime<typename TValues::value_type>;
+
+    TValues    values_;
+    ValuesTime values_time_;
+
+    // Object values (e.g. child nodes): count for O(1) ValueCount() and index of the last add for ObjectKey()
+    // (the index could be shifted by inserts and erases before the object)
+    struct ObjectEntry {
+        size_t count    = 0;
+        size_t idx_hint = 0;
+    };
+    std::unordered_map<const IObject*, ObjectEntry> objects_;
+
+    static const IObject* ObjectGet_(const XValue& _val)
+    {
+        return _val.IsObject() ? _val.ObjectPtrC().get() : nullptr;
+    }
 
     static std::optional<size_t> KeyToIndex_(const KeyType& _key)
     {
@@ -51,6 +73,12 @@ public:
 
     virtual std::optional<MappedType> At(const KeyType& _key) const override;
 
+    // O(1) for objects, O(n) for other values
+    virtual size_t ValueCount(const MappedType& _val) const override;
+
+    // O(1) if the object is not shifted since added, otherwise O(shift)
+    virtual std::optional<KeyType> ObjectKey(const IObject* _object_p) const override;
+
     virtual std::pair<bool, MappedType> Set(const KeyType&    _key,
                                             const MappedType& _val,
                                             const OnChangePF& _pf_on_change) override;
@@ -67,41 +95,39 @@ public:
 
     virtual void Clear() override;
 
+    virtual void Reserve(size_t _size) override;
+
+    virtual bool ValuesTimed() const override { return ValuesTime::kTimed; }
+
 protected:
-    const MappedType& ValueAt_(const typename std::deque<MappedType>::const_iterator& _it);
+    void ObjectAdd_(const XValue& _val, size_t _idx);
+    void ObjectRemove_(const XValue& _val);
 
-    auto DeqFind_(const KeyType& _key) const -> auto
+    // Stored value (w/o timestamp for XValue storage) for compare
+    const XValue& StoredAt_(const typename TValues::const_iterator& _it) const;
+    // Value with timestamp for callbacks and results
+    typename ValuesTime::ValueRef ValueAt_(const typename TValues::const_iterator& _it) const;
+
+    auto ValuesFind_(const KeyType& _key) const -> auto
     {
         auto idx = KeyToIndex_(_key).value_or(kIdxEnd);
         if (idx == kIdxLast) // special pos
-            idx = values_deq_.size() > 1 ? values_deq_.size() - 1 : 0;
-        if (idx < values_deq_.size()) {
-            auto it = values_deq_.begin();
-            std::advance(it, idx);
-            return it;
-        }
-
-        return values_deq_.end();
+            idx = values_.size() > 1 ? values_.size() - 1 : 0;
+        return idx < values_.size() ? values_.begin() + idx : values_.end();
     }
 
-    auto DeqFind_(const KeyType& _key, bool _increase_size) -> auto
+    auto ValuesFind_(const KeyType& _key, bool _increase_size) -> auto
     {
         auto idx = KeyToIndex_(_key).value_or(kIdxEnd);
         if (idx == kIdxEnd)
-            return values_deq_.end();
+            return values_.end();
         if (idx == kIdxLast) // special pos
-            idx = values_deq_.size() > 1 ? values_deq_.size() - 1 : 0;
-
-        while (_increase_size && idx >= values_deq_.size() && idx < values_deq_.size() + max_size_increase)
-            values_deq_.emplace_back();
+            idx = values_.size() > 1 ? values_.size() - 1 : 0;
 
-        if (idx < values_deq_.size()) {
-            auto it = values_deq_.begin();
-            std::advance(it, idx);
-            return it;
-        }
+        if (_increase_size && idx >= values_.size() && idx < values_.size() + max_size_increase)
+            values_.resize(idx + 1);
 
-        return values_deq_.end();
+        return idx < values_.size() ? values_.begin() + idx : values_.end();
     }
 };
 
@@ -0,0 +1,330 @@
+#include "xcontainer_flat_map.h"
+
+#include "xcontainer_hash_map.h"
+#include "xcontainer_map.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace xsdk::impl {
+
+template <class TPromoted>
+bool XContainerFlatMap<TPromoted>::IsKeyValid(const KeyType& _key) const
+{
+    return !KeyToAtom_(_key).empty();
+}
+
+template <class TPromoted>
+bool XContainerFlatMap<TPromoted>::Empty() const
+{
+    if (promoted_p_)
+        return promoted_p_->Empty();
+
+    return values_vec_.empty();
+}
+
+template <class TPromoted>
+size_t XContainerFlatMap<TPromoted>::Size() const
+{
+    if (promoted_p_)
+        return promoted_p_->Size();
+
+    return values_vec_.size();
+}
+
+// Return 'false' if empty or key not found
+template <class TPromoted>
+bool XContainerFlatMap<TPromoted>::ForEach(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
+                                           const std::optional<KeyType>& _from_key) const
+{
+    if (promoted_p_)
+        return promoted_p_->ForEach(std::move(_pf_on_item), _from_key);
+
+    auto it = values_vec_.begin();
+    if (_from_key.has_value()) {
+        auto [it_found, found] = FlatFind_(KeyToAtom_(_from_key.value()));
+        it                     = found ? it_found : values_vec_.end();
+    }
+
+    if (it == values_vec_.end())
+        return false;
+
+    while (_pf_on_item && it != values_vec_.end()) {
+        if (_pf_on_item(AtomToKey_(it->first), values_time_.Get(it->second)))
+            break;
+
+        ++it;
+    }
+
+    return true;
+}
+
+// Return 'false' if empty or key not found
+template <class TPromoted>
+bool XContainerFlatMap<TPromoted>::ForEach(std::function<OnEachRes(const KeyType&, MappedType&)>&& _pf_on_each,
+                                           const std::optional<KeyType>& _from_key,
+                                           const OnChangePF&             _pf_on_change)
+{
+    if (promoted_p_)
+        return promoted_p_->ForEach(std::move(_pf_on_each), _from_key, _pf_on_change);
+
+    auto it = values_vec_.begin();
+    if (_from_key.has_value()) {
+        auto [it_found, found] = FlatFind_(KeyToAtom_(_from_key.value()));
+        it                     = found ? it_found : values_vec_.end();
+    }
+
+    if (it == values_vec_.end())
+        return false;
+
+    if (_pf_on_each) {
+        // Values timestamp is changed after loop (the same for all items in loop)
+        bool changed = false;
+        while (it != values_vec_.end()) {
+            MappedType val = values_time_.Get(it->second); // For detect chnaging
+            auto       key = AtomToKey_(it->first);
+            auto       res = _pf_on_each(key, val);
+            if (res == OnEachRes::Erase || res == OnEachRes::EraseStop) {
+                if (!_pf_on_change || _pf_on_change(key, values_time_.Get(it->second), MappedType())) {
+                    assert(val == it->second);
+                    it      = values_vec_.erase(it);
+                    changed = true;
+                }
+                else {
+                    ++it;
+                }
+            }
+            else {
+                if (val != it->second && (!_pf_on_change || _pf_on_change(key, values_time_.Get(it->second), val))) {
+                    it->second = std::move(val);
+                    changed    = true;
+                }
+
+                ++it;
+            }
+
+            if (res == OnEachRes::Stop || res == OnEachRes::EraseStop)
+                break;
+        }
+
+        if (changed)
+            values_time_.Changed();
+    }
+
+    return true;
+}
+
+template <class TPromoted>
+std::optional<IContainer::MappedType> XContainerFlatMap<TPromoted>::At(const KeyType& _key) const
+{
+    if (promoted_p_)
+        return promoted_p_->At(_key);
+
+    auto [it, found] = FlatFind_(KeyToAtom_(_key));
+    if (!found)
+        return std::nullopt;
+
+    return values_time_.Get(it->second);
+}
+
+template <class TPromoted>
+std::pair<bool, IContainer::MappedType> XContainerFlatMap<TPromoted>::Set(const KeyType&    _key,
+                                                                          const MappedType& _val,
+                                                                          const OnChangePF& _pf_on_change)
+{
+    if (promoted_p_)
+        return promoted_p_->Set(_key, _val, _pf_on_change);
+
+    return Set_(_key, _val, _pf_on_change);
+}
+
+template <class TPromoted>
+std::pair<bool, IContainer::MappedType> XContainerFlatMap<TPromoted>::Set(const KeyType&    _key,
+                                                                          MappedType&&      _val,
+                                                                          const OnChangePF& _pf_on_change)
+{
+    if (promoted_p_)
+        return promoted_p_->Set(_key, std::move(_val), _pf_on_change);
+
+    return Set_(_key, std::move(_val), _pf_on_change);
+}
+
+template <class TPromoted>
+IContainer::EmplaceRes XContainerFlatMap<TPromoted>::Emplace(const KeyType&    _key,
+                                                             const MappedType& _val,
+                                                             const OnChangePF& _pf_on_change)
+{
+    if (promoted_p_)
+        return promoted_p_->Emplace(_key, _val, _pf_on_change);
+
+    return Emplace_(_key, _val, _pf_on_change);
+}
+
+template <class TPromoted>
+IContainer::EmplaceRes XContainerFlatMap<TPromoted>::Emplace(const KeyType&    _key,
+                                                             MappedType&&      _val,
+                                                             const OnChangePF& _pf_on_change)
+{
+    if (promoted_p_)
+        return promoted_p_->Emplace(_key, std::move(_val), _pf_on_change);
+
+    return Emplace_(_key, std::move(_val), _pf_on_change);
+}
+
+template <class TPromoted>
+std::optional<IContainer::MappedType> XContainerFlatMap<TPromoted>::Erase(const KeyType&    _key,
+                                                                          const OnChangePF& _pf_on_change)
+{
+    if (promoted_p_)
+        return promoted_p_->Erase(_key, _pf_on_change);
+
+    auto [it, found] = FlatFind_(KeyToAtom_(_key));
+    if (!found)
+        return std::nullopt;
+
+    if (_pf_on_change && !_pf_on_change(_key, values_time_.Get(it->second), MappedType()))
+        return std::nullopt; // 2think about res
+
+    auto erased = values_time_.Take(it->second);
+    values_vec_.erase(it);
+    values_time_.Changed();
+    return erased;
+}
+
+template <class TPromoted>
+void XContainerFlatMap<TPromoted>::Clear()
+{
+    values_vec_.clear();
+    values_time_.Changed();
+    promoted_p_.reset();
+}
+
+template <class TPromoted>
+void XContainerFlatMap<TPromoted>::Reserve(size_t _size)
+{
+    if (promoted_p_)
+        promoted_p_->Reserve(_size);
+    else if (_size <= kFlatSizeMax)
+        values_vec_.reserve(_size);
+}
+
+template <class TPromoted>
+auto XContainerFlatMap<TPromoted>::FlatFind_(const xnode::StringAtom& _key) const
+    -> std::pair<typename FlatVec::const_iterator, bool>
+{
+    auto [it, found] = const_cast<XContainerFlatMap*>(this)->FlatFind_(_key);
+    return {it, found};
+}
+
+template <class TPromoted>
+auto XContainerFlatMap<TPromoted>::FlatFind_(const xnode::StringAtom& _key)
+    -> std::pair<typename FlatVec::iterator, bool>
+{
+    if (_key.empty())
+        return {values_vec_.end(), false};
+
+    // Few items: pointers compare scan is faster than strings compare in binary search
+    auto it = std::find_if(values_vec_.begin(), values_vec_.end(), [&_key](const FlatItem& item) {
+        return item.first == _key;
+    });
+    if (it != values_vec_.end())
+        return {it, true};
+
+    // Position for insert
+    it = std::lower_bound(values_vec_.begin(), values_vec_.end(), _key, [](const FlatItem& item, const auto& key) {
+        return item.first < key;
+    });
+    return {it, false};
+}
+
+template <class TPromoted>
+const XValue& XContainerFlatMap<TPromoted>::StoredAt_(const std::pair<typename FlatVec::iterator, bool>& _found) const
+{
+    static const XValue empty;
+    return _found.second ? _found.first->second : empty;
+}
+
+template <class TPromoted>
+auto XContainerFlatMap<TPromoted>::ValueAt_(const std::pair<typename FlatVec::iterator, bool>& _found) const ->
+    typename ValuesTime::ValueRef
+{
+    static const MappedType empty;
+    if (!_found.second)
+        return empty;
+
+    return values_time_.Get(_found.first->second);
+}
+
+template <class TPromoted>
+template <class TValue>
+std::pair<bool, IContainer::MappedType> XContainerFlatMap<TPromoted>::Set_(const KeyType&    _key,
+                                                                           TValue&&          _val,
+                                                                           const OnChangePF& _pf_on_change)
+{
+    const auto& key = KeyToAtom_(_key);
+    if (key.empty())
+        return {false, MappedType()}; // 2think about res
+
+    auto found = FlatFind_(key);
+    if (StoredAt_(found) == _val)
+        return {false, ValueAt_(found)}; // 2think about res
+
+    if (!found.second && PromoteCheck_())
+        return promoted_p_->Set(_key, std::forward<TValue>(_val), _pf_on_change);
+
+    if (_pf_on_change && !_pf_on_change(_key, ValueAt_(found), _val))
+        return {false, ValueAt_(found)}; // 2think about res
+
+    if (!found.second) {
+        values_vec_.emplace(found.first, key, std::forward<TValue>(_val));
+        values_time_.Changed();
+        return {true, MappedType()};
+    }
+
+    return {true, values_time_.Exchange(found.first->second, std::forward<TValue>(_val))};
+}
+
+template <class TPromoted>
+template <class TValue>
+IContainer::EmplaceRes XContainerFlatMap<TPromoted>::Emplace_(const KeyType&    _key,
+                                                              TValue&&          _val,
+                                                              const OnChangePF& _pf_on_change)
+{
+    const auto& key   = KeyToAtom_(_key);
+    auto        found = FlatFind_(key);
+    if (key.empty() || found.second)
+        return {false, _key, ValueAt_(found)}; // Add result description
+
+    if (PromoteCheck_())
+        return promoted_p_->Emplace(_key, std::forward<TValue>(_val), _pf_on_change);
+
+    if (_pf_on_change && !_pf_on_change(_key, ValueAt_(found), _val))
+        return {false, _key, MappedType()}; // Add result description
+
+    values_vec_.emplace(found.first, key, std::forward<TValue>(_val));
+    values_time_.Changed();
+    return {true, AtomToKey_(key), MappedType()};
+}
+
+template <class TPromoted>
+bool XContainerFlatMap<TPromoted>::PromoteCheck_()
+{
+    assert(!promoted_p_);
+    if (values_vec_.size() < kFlatSizeMax)
+        return false;
+
+    // Items are already approved -> no callback
+    promoted_p_ = std::make_unique<TPromoted>();
+    for (auto& [key, val] : values_vec_)
+        promoted_p_->Emplace(AtomToKey_(key), values_time_.Take(val));
+
+    FlatVec().swap(values_vec_);
+    return true;
+}
+
+template class XContainerFlatMap<XContainerMap<>>;
+template class XContainerFlatMap<XContainerHashMap<false>>;
+template class XContainerFlatMap<XContainerMap<XValue>>;
+template class XContainerFlatMap<XContainerHashMap<false, XValue>>;
+
+} // namespace xsdk::impl
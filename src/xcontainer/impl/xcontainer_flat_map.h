@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../xcontainer.h"
+#include "xcontainer_values.h"
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace xsdk::impl {
+
+// Map for small nodes: sorted vector of {key, value} (one allocation for all items, cache friendly)
+// When size reach kFlatSizeMax items moved to TPromoted container and all calls are forwarded to it
+// (no demotion back on erase), values stored as TPromoted does (with or w/o own timestamps)
+template <class TPromoted>
+class XContainerFlatMap: public IContainer {
+
+    using ValuesTime = XValuesTime<typename TPromoted::StoredType>;
+    using FlatItem   = std::pair<xnode::StringAtom, typename TPromoted::StoredType>;
+    using FlatVec    = std::vector<FlatItem>;
+
+    static constexpr size_t kFlatSizeMax = 16;
+
+    FlatVec                     values_vec_;
+    ValuesTime                  values_time_;
+    std::unique_ptr<IContainer> promoted_p_;
+
+    static const xnode::StringAtom& KeyToAtom_(const KeyType& _key)
+    {
+        static const xnode::StringAtom empty;
+        const auto*                    atom_p = std::get_if<xnode::StringAtom>(&_key);
+        return atom_p ? *atom_p : empty;
+    }
+
+    static KeyType AtomToKey_(const xnode::StringAtom& _atom) { return {_atom}; }
+
+public:
+    using StoredType = typename TPromoted::StoredType;
+
+    XContainerFlatMap()                             = default;
+    XContainerFlatMap(XContainerFlatMap&&) noexcept = default;
+
+public:
+    virtual ContainerType Type() const override { return ContainerType::Map; }
+
+    virtual bool IsKeyValid(const KeyType& _key) const override;
+
+    virtual bool Empty() const override;
+
+    virtual size_t Size() const override;
+
+    virtual bool ForEach(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
+                         const std::optional<KeyType>&                            _from_key) const override;
+
+    // Return 'false' if empty or key not found
+    virtual bool ForEach( // NOLINT(readability-function-cognitive-complexity)
+        std::function<OnEachRes(const KeyType&, MappedType&)>&& _pf_on_each,
+        const std::optional<KeyType>&                           _from_key,
+        const OnChangePF&                                       _pf_on_change) override;
+
+    virtual std::optional<MappedType> At(const KeyType& _key) const override;
+
+    virtual std::pair<bool, MappedType> Set(const KeyType&    _key,
+                                            const MappedType& _val,
+                                            const OnChangePF& _pf_on_change) override;
+
+    virtual std::pair<bool, MappedType> Set(const KeyType&    _key,
+                                            MappedType&&      _val,
+                                            const OnChangePF& _pf_on_change) override;
+
+    virtual EmplaceRes Emplace(const KeyType& _key, const MappedType& _val, const OnChangePF& _pf_on_change) override;
+
+    virtual EmplaceRes Emplace(const KeyType& _key, MappedType&& _val, const OnChangePF& _pf_on_change) override;
+
+    virtual std::optional<MappedType> Erase(const KeyType& _key, const OnChangePF& _pf_on_change) override;
+
+    virtual void Clear() override;
+
+    virtual void Reserve(size_t _size) override;
+
+    virtual bool ValuesTimed() const override { return ValuesTime::kTimed; }
+
+private:
+    // Return {found or lower bound iterator, found}
+    std::pair<typename FlatVec::const_iterator, bool> FlatFind_(const xnode::StringAtom& _key) const;
+    std::pair<typename FlatVec::iterator, bool>       FlatFind_(const xnode::StringAtom& _key);
+
+    // Stored value (w/o timestamp for XValue storage) for compare
+    const XValue& StoredAt_(const std::pair<typename FlatVec::iterator, bool>& _found) const;
+    // Value with timestamp for callbacks and results
+    typename ValuesTime::ValueRef ValueAt_(const std::pair<typename FlatVec::iterator, bool>& _found) const;
+
+    template <class TValue>
+    std::pair<bool, MappedType> Set_(const KeyType& _key, TValue&& _val, const OnChangePF& _pf_on_change);
+
+    template <class TValue>
+    EmplaceRes Emplace_(const KeyType& _key, TValue&& _val, const OnChangePF& _pf_on_change);
+
+    // Return true if promoted (for new key insertion)
+    bool PromoteCheck_();
+};
+
+} // namespace xsdk::impl
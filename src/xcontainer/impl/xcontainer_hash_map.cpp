@@ -0,0 +1,393 @@
+#include "xcontainer_hash_map.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace xsdk::impl {
+
+template <bool kInsertionOrder, class TStored>
+bool XContainerHashMap<kInsertionOrder, TStored>::IsKeyValid(const KeyType& _key) const
+{
+    return !KeyToAtom_(_key).empty();
+}
+
+template <bool kInsertionOrder, class TStored>
+bool XContainerHashMap<kInsertionOrder, TStored>::Empty() const
+{
+    return Size() == 0;
+}
+
+template <bool kInsertionOrder, class TStored>
+size_t XContainerHashMap<kInsertionOrder, TStored>::Size() const
+{
+    assert(holes_ <= entries_.size());
+    return entries_.size() - holes_;
+}
+
+// Return 'false' if empty or key not found
+template <bool kInsertionOrder, class TStored>
+bool XContainerHashMap<kInsertionOrder, TStored>::ForEach(
+    std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
+    const std::optional<KeyType>&                            _from_key) const
+{
+    size_t idx = 0;
+    if (_from_key.has_value())
+        idx = EntryFind_(_from_key.value());
+
+    // Skip leading holes
+    while (idx < entries_.size() && entries_[idx].key.empty())
+        ++idx;
+
+    if (idx >= entries_.size())
+        return false;
+
+    for (; _pf_on_item && idx < entries_.size(); ++idx) {
+        const auto& entry = entries_[idx];
+        if (entry.key.empty())
+            continue;
+
+        if (_pf_on_item(AtomToKey_(entry.key), values_time_.Get(entry.value)))
+            break;
+    }
+
+    return true;
+}
+
+// Return 'false' if empty or key not found
+template <bool kInsertionOrder, class TStored>
+bool XContainerHashMap<kInsertionOrder, TStored>::ForEach(
+    std::function<OnEachRes(const KeyType&, MappedType&)>&& _pf_on_each,
+    const std::optional<KeyType>&                           _from_key,
+    const OnChangePF&                                       _pf_on_change)
+{
+    size_t idx = 0;
+    if (_from_key.has_value())
+        idx = EntryFind_(_from_key.value());
+
+    while (idx < entries_.size() && entries_[idx].key.empty())
+        ++idx;
+
+    if (idx >= entries_.size())
+        return false;
+
+    if (_pf_on_each) {
+        // Values timestamp is changed after loop (the same for all items in loop)
+        bool changed = false;
+        while (idx < entries_.size()) {
+            auto& entry = entries_[idx];
+            if (entry.key.empty()) {
+                ++idx;
+                continue;
+            }
+
+            MappedType val = values_time_.Get(entry.value); // For detect chnaging
+            auto       key = AtomToKey_(entry.key);
+            auto       res = _pf_on_each(key, val);
+            if (res == OnEachRes::Erase || res == OnEachRes::EraseStop) {
+                if (!_pf_on_change || _pf_on_change(key, ValueAt_(idx), MappedType())) {
+                    assert(val == entry.value);
+                    EntryRemove_(idx);
+                    changed = true;
+                    // Unordered: last entry moved to idx -> check it at next step
+                    if constexpr (kInsertionOrder)
+                        ++idx;
+                }
+                else {
+                    ++idx;
+                }
+            }
+            else {
+                if (val != entry.value && (!_pf_on_change || _pf_on_change(key, ValueAt_(idx), val))) {
+                    entry.value = std::move(val);
+                    changed     = true;
+                }
+
+                ++idx;
+            }
+
+            if (res == OnEachRes::Stop || res == OnEachRes::EraseStop)
+                break;
+        }
+
+        if (changed)
+            values_time_.Changed();
+
+        Compact_();
+    }
+
+    return true;
+}
+
+template <bool kInsertionOrder, class TStored>
+std::optional<IContainer::MappedType> XContainerHashMap<kInsertionOrder, TStored>::At(const KeyType& _key) const
+{
+    auto idx = EntryFind_(_key);
+    if (idx == std::string::npos)
+        return std::nullopt;
+
+    return values_time_.Get(entries_[idx].value);
+}
+
+template <bool kInsertionOrder, class TStored>
+std::pair<bool, IContainer::MappedType> XContainerHashMap<kInsertionOrder, TStored>::Set(
+    const KeyType&    _key,
+    const MappedType& _val,
+    const OnChangePF& _pf_on_change)
+{
+    return Set_(_key, _val, _pf_on_change);
+}
+
+template <bool kInsertionOrder, class TStored>
+std::pair<bool, IContainer::MappedType> XContainerHashMap<kInsertionOrder, TStored>::Set(
+    const KeyType&    _key,
+    MappedType&&      _val,
+    const OnChangePF& _pf_on_change)
+{
+    return Set_(_key, std::move(_val), _pf_on_change);
+}
+
+template <bool kInsertionOrder, class TStored>
+IContainer::EmplaceRes XContainerHashMap<kInsertionOrder, TStored>::Emplace(const KeyType&    _key,
+                                                                            const MappedType& _val,
+                                                                            const OnChangePF& _pf_on_change)
+{
+    return Emplace_(_key, _val, _pf_on_change);
+}
+
+template <bool kInsertionOrder, class TStored>
+IContainer::EmplaceRes XContainerHashMap<kInsertionOrder, TStored>::Emplace(const KeyType&    _key,
+                                                                            MappedType&&      _val,
+                                                                            const OnChangePF& _pf_on_change)
+{
+    return Emplace_(_key, std::move(_val), _pf_on_change);
+}
+
+template <bool kInsertionOrder, class TStored>
+std::optional<IContainer::MappedType> XContainerHashMap<kInsertionOrder, TStored>::Erase(
+    const KeyType&    _key,
+    const OnChangePF& _pf_on_change)
+{
+    auto idx = EntryFind_(_key);
+    if (idx == std::string::npos)
+        return std::nullopt;
+
+    if (_pf_on_change && !_pf_on_change(_key, ValueAt_(idx), MappedType()))
+        return std::nullopt; // 2think about res
+
+    auto erased = EntryRemove_(idx);
+    values_time_.Changed();
+    Compact_();
+    return erased;
+}
+
+template <bool kInsertionOrder, class TStored>
+void XContainerHashMap<kInsertionOrder, TStored>::Clear()
+{
+    entries_.clear();
+    slots_.clear();
+    holes_ = 0;
+    values_time_.Changed();
+}
+
+template <bool kInsertionOrder, class TStored>
+void XContainerHashMap<kInsertionOrder, TStored>::Reserve(size_t _size)
+{
+    entries_.reserve(_size + holes_);
+
+    auto slots_count = std::max(kSlotsMin, slots_.size());
+    while (_size * 4 > slots_count * 3)
+        slots_count *= 2;
+
+    if (slots_count != slots_.size())
+        SlotsRebuild_(slots_count);
+}
+
+template <bool kInsertionOrder, class TStored>
+std::pair<size_t, bool> XContainerHashMap<kInsertionOrder, TStored>::SlotFind_(const xnode::StringAtom& _key) const
+{
+    assert(!slots_.empty());
+    const size_t hash = _key.hash();
+    const size_t mask = slots_.size() - 1;
+    for (size_t slot_idx = hash & mask;; slot_idx = (slot_idx + 1) & mask) {
+        const auto& slot = slots_[slot_idx];
+        if (slot.entry_idx == kSlotEmpty)
+            return {slot_idx, false};
+
+        if (slot.hash_low == (uint32_t)hash && entries_[slot.entry_idx].key == _key)
+            return {slot_idx, true};
+    }
+}
+
+template <bool kInsertionOrder, class TStored>
+size_t XContainerHashMap<kInsertionOrder, TStored>::EntryFind_(const KeyType& _key) const
+{
+    const auto& key = KeyToAtom_(_key);
+    if (key.empty() || slots_.empty())
+        return std::string::npos;
+
+    auto [slot_idx, found] = SlotFind_(key);
+    return found ? slots_[slot_idx].entry_idx : std::string::npos;
+}
+
+template <bool kInsertionOrder, class TStored>
+const XValue& XContainerHashMap<kInsertionOrder, TStored>::StoredAt_(size_t _entry_idx) const
+{
+    static const XValue empty;
+    return _entry_idx != std::string::npos ? entries_[_entry_idx].value : empty;
+}
+
+template <bool kInsertionOrder, class TStored>
+auto XContainerHashMap<kInsertionOrder, TStored>::ValueAt_(size_t _entry_idx) const -> typename ValuesTime::ValueRef
+{
+    static const MappedType empty;
+    if (_entry_idx == std::string::npos)
+        return empty;
+
+    return values_time_.Get(entries_[_entry_idx].value);
+}
+
+template <bool kInsertionOrder, class TStored>
+template <class TValue>
+std::pair<bool, IContainer::MappedType> XContainerHashMap<kInsertionOrder, TStored>::Set_(
+    const KeyType&    _key,
+    TValue&&          _val,
+    const OnChangePF& _pf_on_change)
+{
+    const auto& key = KeyToAtom_(_key);
+    if (key.empty())
+        return {false, MappedType()}; // 2think about res
+
+    auto idx = EntryFind_(_key);
+    if (StoredAt_(idx) == _val)
+        return {false, ValueAt_(idx)}; // 2think about res
+
+    if (_pf_on_change && !_pf_on_change(_key, ValueAt_(idx), _val))
+        return {false, ValueAt_(idx)}; // 2think about res
+
+    if (idx == std::string::npos) {
+        EntryAdd_(key, TStored(std::forward<TValue>(_val)));
+        return {true, MappedType()};
+    }
+
+    return {true, values_time_.Exchange(entries_[idx].value, std::forward<TValue>(_val))};
+}
+
+template <bool kInsertionOrder, class TStored>
+template <class TValue>
+IContainer::EmplaceRes XContainerHashMap<kInsertionOrder, TStored>::Emplace_(const KeyType&    _key,
+                                                                             TValue&&          _val,
+                                                                             const OnChangePF& _pf_on_change)
+{
+    const auto& key = KeyToAtom_(_key);
+    auto idx = EntryFind_(_key);
+    if (key.empty() || idx != std::string::npos)
+        return {false, _key, ValueAt_(idx)}; // Add result description
+
+    if (_pf_on_change && !_pf_on_change(_key, ValueAt_(idx), _val))
+        return {false, _key, MappedType()}; // Add result description
+
+    EntryAdd_(key, TStored(std::forward<TValue>(_val)));
+    return {true, AtomToKey_(key), MappedType()};
+}
+
+template <bool kInsertionOrder, class TStored>
+void XContainerHashMap<kInsertionOrder, TStored>::EntryAdd_(const xnode::StringAtom& _key, TStored&& _val)
+{
+    assert(entries_.size() < kSlotEmpty);
+
+    // Keep load factor <= 0.75 (slots used by all entries, Size() could be overridden e.g. for erased items)
+    if ((entries_.size() - holes_ + 1) * 4 > slots_.size() * 3)
+        SlotsRebuild_(std::max(kSlotsMin, slots_.size() * 2));
+
+    auto [slot_idx, found] = SlotFind_(_key);
+    assert(!found);
+
+    slots_[slot_idx] = {(uint32_t)entries_.size(), (uint32_t)_key.hash()};
+    entries_.push_back({_key, std::move(_val), _key.hash()});
+    values_time_.Changed();
+}
+
+template <bool kInsertionOrder, class TStored>
+IContainer::MappedType XContainerHashMap<kInsertionOrder, TStored>::EntryRemove_(size_t _entry_idx)
+{
+    assert(_entry_idx < entries_.size() && !entries_[_entry_idx].key.empty());
+
+    const size_t mask = slots_.size() - 1;
+
+    // Find slot of entry
+    auto slot_idx = entries_[_entry_idx].hash & mask;
+    while (slots_[slot_idx].entry_idx != _entry_idx)
+        slot_idx = (slot_idx + 1) & mask;
+
+    // Backward shift deletion: move following slots of the cluster closer to their home slot
+    for (auto next_idx = (slot_idx + 1) & mask; slots_[next_idx].entry_idx != kSlotEmpty;
+         next_idx      = (next_idx + 1) & mask) {
+        auto home_idx = slots_[next_idx].hash_low & mask;
+        if (((next_idx - home_idx) & mask) >= ((next_idx - slot_idx) & mask)) {
+            slots_[slot_idx] = slots_[next_idx];
+            slot_idx         = next_idx;
+        }
+    }
+    slots_[slot_idx] = Slot();
+
+    auto erased   = values_time_.Take(entries_[_entry_idx].value);
+    auto last_idx = entries_.size() - 1;
+    if (kInsertionOrder && _entry_idx != last_idx) {
+        // Keep order: leave hole
+        entries_[_entry_idx] = Entry();
+        ++holes_;
+        return erased;
+    }
+
+    // Move last entry to erased place
+    if (_entry_idx != last_idx) {
+        auto last_slot_idx = entries_[last_idx].hash & mask;
+        while (slots_[last_slot_idx].entry_idx != last_idx)
+            last_slot_idx = (last_slot_idx + 1) & mask;
+
+        slots_[last_slot_idx].entry_idx = (uint32_t)_entry_idx;
+        entries_[_entry_idx]            = std::move(entries_[last_idx]);
+    }
+    entries_.pop_back();
+    return erased;
+}
+
+template <bool kInsertionOrder, class TStored>
+void XContainerHashMap<kInsertionOrder, TStored>::SlotsRebuild_(size_t _slots_count)
+{
+    assert(_slots_count >= kSlotsMin && (_slots_count & (_slots_count - 1)) == 0);
+
+    slots_.assign(_slots_count, Slot());
+    const size_t mask = _slots_count - 1;
+    for (size_t idx = 0; idx < entries_.size(); ++idx) {
+        if (entries_[idx].key.empty())
+            continue;
+
+        auto slot_idx = entries_[idx].hash & mask;
+        while (slots_[slot_idx].entry_idx != kSlotEmpty)
+            slot_idx = (slot_idx + 1) & mask;
+
+        slots_[slot_idx] = {(uint32_t)idx, (uint32_t)entries_[idx].hash};
+    }
+}
+
+template <bool kInsertionOrder, class TStored>
+void XContainerHashMap<kInsertionOrder, TStored>::Compact_()
+{
+    if (holes_ < kHolesCompact || holes_ * 2 < entries_.size())
+        return;
+
+    entries_.erase(
+        std::remove_if(entries_.begin(), entries_.end(), [](const Entry& entry) { return entry.key.empty(); }),
+        entries_.end());
+    holes_ = 0;
+
+    SlotsRebuild_(slots_.size());
+}
+
+template class XContainerHashMap<false>;
+template class XContainerHashMap<true>;
+template class XContainerHashMap<false, XValue>;
+template class XContainerHashMap<true, XValue>;
+
+} // namespace xsdk::impl
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "../xcontainer.h"
+#include "xcontainer_values.h"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace xsdk::impl {
+
+// Open-addressing (linear probing) hash map: dense entries vector + slots table with entries indexes.
+// kInsertionOrder = true : items enumerated in insertion order, erased entries became holes
+//                          and removed on compaction (on erase, when holes more than half of entries)
+// kInsertionOrder = false: erase move last entry to erased place, enumeration order is unspecified
+// TStored - MappedType or XValue (values w/o own timestamps, see XValuesTime)
+template <bool kInsertionOrder = false, class TStored = IContainer::MappedType>
+class XContainerHashMap: public IContainer {
+
+    using ValuesTime = XValuesTime<TStored>;
+
+    struct Entry {
+        xnode::StringAtom key; // Empty for holes (valid keys are never empty)
+        TStored           value;
+        size_t            hash = 0;
+    };
+
+    struct Slot {
+        uint32_t entry_idx = kSlotEmpty;
+        uint32_t hash_low  = 0; // For skip keys compare and for slot home w/o entry access
+    };
+
+    static constexpr uint32_t kSlotEmpty    = UINT32_MAX;
+    static constexpr size_t   kSlotsMin     = 8;
+    static constexpr size_t   kHolesCompact = 16;
+
+    std::vector<Entry> entries_;
+    std::vector<Slot>  slots_; // Size is power of 2 (or zero)
+    size_t             holes_ = 0;
+    ValuesTime         values_time_;
+
+    static const xnode::StringAtom& KeyToAtom_(const KeyType& _key)
+    {
+        static const xnode::StringAtom empty;
+        const auto*                    atom_p = std::get_if<xnode::StringAtom>(&_key);
+        return atom_p ? *atom_p : empty;
+    }
+
+    static KeyType AtomToKey_(const xnode::StringAtom& _atom) { return {_atom}; }
+
+public:
+    using StoredType = TStored;
+
+    XContainerHashMap()                             = default;
+    XContainerHashMap(XContainerHashMap&&) noexcept = default;
+    XContainerHashMap(const XContainerHashMap&)     = default;
+
+public:
+    virtual ContainerType Type() const override { return ContainerType::Map; }
+
+    virtual bool IsKeyValid(const KeyType& _key) const override;
+
+    virtual bool Empty() const override;
+
+    virtual size_t Size() const override;
+
+    virtual bool ForEach(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
+                         const std::optional<KeyType>&                            _from_key) const override;
+
+    // Return 'false' if empty or key not found
+    virtual bool ForEach( // NOLINT(readability-function-cognitive-complexity)
+        std::function<OnEachRes(const KeyType&, MappedType&)>&& _pf_on_each,
+        const std::optional<KeyType>&                           _from_key,
+        const OnChangePF&                                       _pf_on_change) override;
+
+    virtual std::optional<MappedType> At(const KeyType& _key) const override;
+
+    virtual std::pair<bool, MappedType> Set(const KeyType&    _key,
+                                            const MappedType& _val,
+                                            const OnChangePF& _pf_on_change) override;
+
+    virtual std::pair<bool, MappedType> Set(const KeyType&    _key,
+                                            MappedType&&      _val,
+                                            const OnChangePF& _pf_on_change) override;
+
+    virtual EmplaceRes Emplace(const KeyType& _key, const MappedType& _val, const OnChangePF& _pf_on_change) override;
+
+    virtual EmplaceRes Emplace(const KeyType& _key, MappedType&& _val, const OnChangePF& _pf_on_change) override;
+
+    virtual std::optional<MappedType> Erase(const KeyType& _key, const OnChangePF& _pf_on_change) override;
+
+    virtual void Clear() override;
+
+    virtual void Reserve(size_t _size) override;
+
+    virtual bool ValuesTimed() const override { return ValuesTime::kTimed; }
+
+private:
+    // Return {slot index, found}, for not found - index of empty slot for insert
+    // (keys are compared by pointer, hash is precomputed by interning)
+    std::pair<size_t, bool> SlotFind_(const xnode::StringAtom& _key) const;
+    // Return entry index or npos
+    size_t EntryFind_(const KeyType& _key) const;
+
+    // Stored value (w/o timestamp for XValue storage) for compare
+    const XValue& StoredAt_(size_t _entry_idx) const;
+    // Value with timestamp for callbacks and results
+    typename ValuesTime::ValueRef ValueAt_(size_t _entry_idx) const;
+
+    template <class TValue>
+    std::pair<bool, MappedType> Set_(const KeyType& _key, TValue&& _val, const OnChangePF& _pf_on_change);
+
+    template <class TValue>
+    EmplaceRes Emplace_(const KeyType& _key, TValue&& _val, const OnChangePF& _pf_on_change);
+
+    void       EntryAdd_(const xnode::StringAtom& _key, TStored&& _val);
+    MappedType EntryRemove_(size_t _entry_idx);
+    void       SlotsRebuild_(size_t _slots_count);
+    void       Compact_();
+};
+
+} // namespace xsdk::impl
@@ -0,0 +1,157 @@
+#include "xcontainer_keys_index.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace xsdk::impl {
+
+namespace {
+
+size_t LowBit(size_t _idx) { return _idx & (~_idx + 1); }
+
+} // namespace
+
+bool XKeysIndex::Insert(const KeyType& _key, const KeyType* _key_next_p, bool _live)
+{
+    Block* block_p = nullptr;
+    size_t pos     = 0;
+    if (_key_next_p) {
+        auto it = key_blocks_.find(*_key_next_p);
+        if (it == key_blocks_.end())
+            return false;
+
+        block_p = it->second;
+        pos     = std::find(block_p->keys.begin(), block_p->keys.end(), *_key_next_p) - block_p->keys.begin();
+    }
+    else {
+        // Appended keys fill the last block, the middle blocks are split on overflow
+        if (blocks_.empty() || blocks_.back()->keys.size() >= kBlockMax) {
+            blocks_.push_back(std::make_unique<Block>());
+            blocks_.back()->ordinal = blocks_.size() - 1;
+            FenwickPush_(0);
+        }
+
+        block_p = blocks_.back().get();
+        pos     = block_p->keys.size();
+    }
+
+    block_p->keys.insert(block_p->keys.begin() + pos, _key);
+    block_p->live.insert(block_p->live.begin() + pos, _live);
+    key_blocks_[_key] = block_p;
+    if (_live) {
+        ++block_p->live_count;
+        ++live_;
+        FenwickAdd_(block_p->ordinal, 1);
+    }
+
+    if (block_p->keys.size() > kBlockMax)
+        BlockSplit_(block_p);
+
+    return true;
+}
+
+bool XKeysIndex::LiveSet(const KeyType& _key, bool _live)
+{
+    auto it = key_blocks_.find(_key);
+    if (it == key_blocks_.end())
+        return false;
+
+    auto* block_p = it->second;
+    auto  pos     = std::find(block_p->keys.begin(), block_p->keys.end(), _key) - block_p->keys.begin();
+    if (block_p->live[pos] == _live)
+        return true;
+
+    block_p->live[pos] = _live;
+    if (_live) {
+        ++block_p->live_count;
+        ++live_;
+    }
+    else {
+        --block_p->live_count;
+        --live_;
+    }
+    FenwickAdd_(block_p->ordinal, _live ? 1 : -1);
+    return true;
+}
+
+std::optional<XKeysIndex::KeyType> XKeysIndex::KeyAt(size_t _index) const
+{
+    if (_index >= live_)
+        return std::nullopt;
+
+    // Fenwick tree descent: the last block with live items before it <= _index
+    size_t blocks = blocks_.size();
+    size_t step   = 1;
+    while (step * 2 <= blocks)
+        step *= 2;
+
+    size_t ordinal = 0;
+    size_t rest    = _index;
+    for (; step > 0; step /= 2) {
+        if (ordinal + step <= blocks && fenwick_[ordinal + step] <= rest) {
+            ordinal += step;
+            rest -= fenwick_[ordinal];
+        }
+    }
+
+    const auto& block = *blocks_[ordinal];
+    for (size_t pos = 0; pos < block.keys.size(); ++pos) {
+        if (block.live[pos] && rest-- == 0)
+            return block.keys[pos];
+    }
+
+    assert(false);
+    return std::nullopt;
+}
+
+void XKeysIndex::BlockSplit_(Block* _block_p)
+{
+    auto block_new_p = std::make_unique<Block>();
+    auto half        = _block_p->keys.size() / 2;
+    block_new_p->keys.assign(_block_p->keys.begin() + half, _block_p->keys.end());
+    block_new_p->live.assign(_block_p->live.begin() + half, _block_p->live.end());
+    _block_p->keys.resize(half);
+    _block_p->live.resize(half);
+
+    block_new_p->live_count = std::count(block_new_p->live.begin(), block_new_p->live.end(), 1);
+    _block_p->live_count -= block_new_p->live_count;
+    for (const auto& key : block_new_p->keys)
+        key_blocks_[key] = block_new_p.get();
+
+    // Ordinals of next blocks are changed -> Fenwick tree is rebuilt (once per half of block insertions)
+    blocks_.insert(blocks_.begin() + _block_p->ordinal + 1, std::move(block_new_p));
+    for (auto ordinal = _block_p->ordinal + 1; ordinal < blocks_.size(); ++ordinal)
+        blocks_[ordinal]->ordinal = ordinal;
+
+    FenwickBuild_();
+}
+
+void XKeysIndex::FenwickAdd_(size_t _ordinal, int64_t _delta)
+{
+    for (auto idx = _ordinal + 1; idx < fenwick_.size(); idx += LowBit(idx))
+        fenwick_[idx] += static_cast<size_t>(_delta);
+}
+
+void XKeysIndex::FenwickPush_(size_t _count)
+{
+    // New node covers (idx - LowBit(idx), idx]: sum of nodes of this range is added
+    auto idx = fenwick_.size();
+    auto sum = _count;
+    for (auto child = idx - 1; child > idx - LowBit(idx); child -= LowBit(child))
+        sum += fenwick_[child];
+
+    fenwick_.push_back(sum);
+}
+
+void XKeysIndex::FenwickBuild_()
+{
+    fenwick_.assign(blocks_.size() + 1, 0);
+    for (size_t idx = 1; idx < fenwick_.size(); ++idx) {
+        fenwick_[idx] += blocks_[idx - 1]->live_count;
+        auto parent = idx + LowBit(idx);
+        if (parent < fenwick_.size())
+            fenwick_[parent] += fenwick_[idx];
+    }
+}
+
+} // namespace xsdk::impl
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../xcontainer.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace xsdk::impl {
+
+// Keys of map container in enumeration order (including erased items kept by container) with live flags,
+// for access to live keys by index. Keys are stored in blocks of limited size with live items counts:
+// KeyAt() - O(log n) by Fenwick tree of blocks counts and scan of one block, key insertion or live flag
+// change - O(block size), the block of key is found via hash map.
+class XKeysIndex {
+public:
+    using KeyType = IContainer::KeyType;
+
+    struct KeyHash {
+        size_t operator()(const KeyType& _key) const
+        {
+            const auto* atom_p = std::get_if<xnode::StringAtom>(&_key);
+            return atom_p ? atom_p->hash() : std::hash<size_t>()(_key.index());
+        }
+    };
+
+private:
+    static constexpr size_t kBlockMax = 128;
+
+    struct Block {
+        std::vector<KeyType> keys;
+        std::vector<uint8_t> live;
+        size_t               live_count = 0;
+        size_t               ordinal    = 0; // Position in blocks_
+    };
+
+    std::vector<std::unique_ptr<Block>>          blocks_;
+    std::unordered_map<KeyType, Block*, KeyHash> key_blocks_;
+    std::vector<size_t>                          fenwick_ = {0}; // Live counts of blocks (1-based)
+    size_t                                       live_    = 0;
+
+public:
+    // Add key after all keys or before _key_next_p (nullptr - at the end), return false if _key_next_p not found
+    bool Insert(const KeyType& _key, const KeyType* _key_next_p, bool _live);
+    // Change live flag of key (item is erased or restored), return false if key not found
+    bool LiveSet(const KeyType& _key, bool _live);
+
+    // Return live key at _index position (nullopt if out of range)
+    std::optional<KeyType> KeyAt(size_t _index) const;
+
+    size_t Size() const { return live_; }
+
+private:
+    void BlockSplit_(Block* _block_p);
+    void FenwickAdd_(size_t _ordinal, int64_t _delta);
+    void FenwickPush_(size_t _count);
+    void FenwickBuild_();
+};
+
+} // namespace xsdk::impl
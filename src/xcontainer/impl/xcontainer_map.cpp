@@ -4,15 +4,28 @@
 
 namespace xsdk::impl {
 
-bool XContainerMap::IsKeyValid(const KeyType& _key) const { return !KeyToString_(_key).empty(); }
+template <class TStored>
+bool XContainerMap<TStored>::IsKeyValid(const KeyType& _key) const
+{
+    return !KeyToAtom_(_key).empty();
+}
 
-bool XContainerMap::Empty() const { return values_map_.empty(); }
+template <class TStored>
+bool XContainerMap<TStored>::Empty() const
+{
+    return values_map_.empty();
+}
 
-size_t XContainerMap::Size() const { return values_map_.size(); }
+template <class TStored>
+size_t XContainerMap<TStored>::Size() const
+{
+    return values_map_.size();
+}
 
 // Return 'false' if empty or key not found
-bool XContainerMap::ForEach(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
-                            const std::optional<KeyType>&                            _from_key) const
+template <class TStored>
+bool XContainerMap<TStored>::ForEach(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
+                                     const std::optional<KeyType>&                            _from_key) const
 {
     auto it = values_map_.begin();
     if (_from_key.has_value())
@@ -22,7 +35,7 @@ bool XContainerMap::ForEach(std::function<bool(const KeyType&, const MappedType&
         return false;
 
     while (_pf_on_item && it != values_map_.end()) {
-        if (_pf_on_item(StringToKey_(it->first), it->second))
+        if (_pf_on_item(AtomToKey_(it->first), values_time_.Get(it->second)))
             break;
 
         ++it;
@@ -32,9 +45,10 @@ bool XContainerMap::ForEach(std::function<bool(const KeyType&, const MappedType&
 }
 
 // Return 'false' if empty or key not found
-bool XContainerMap::ForEach(std::function<OnEachRes(const KeyType&, MappedType&)>&& _pf_on_each,
-                            const std::optional<KeyType>&                           _from_key,
-                            const OnChangePF&                                       _pf_on_change)
+template <class TStored>
+bool XContainerMap<TStored>::ForEach(std::function<OnEachRes(const KeyType&, MappedType&)>&& _pf_on_each,
+                                     const std::optional<KeyType>&                           _from_key,
+                                     const OnChangePF&                                       _pf_on_change)
 {
     auto it = values_map_.begin();
     if (_from_key.has_value())
@@ -44,22 +58,26 @@ bool XContainerMap::ForEach(std::function<OnEachRes(const KeyType&, MappedType&)
         return false;
 
     if (_pf_on_each) {
+        // Values timestamp is changed after loop (the same for all items in loop)
+        bool changed = false;
         while (it != values_map_.end()) {
-            MappedType val = it->second; // For detect chnaging
-            auto       res = _pf_on_each(StringToKey_(it->first), val);
+            MappedType val = values_time_.Get(it->second); // For detect chnaging
+            auto       res = _pf_on_each(AtomToKey_(it->first), val);
             if (res == OnEachRes::Erase || res == OnEachRes::EraseStop) {
-                if (!_pf_on_change || _pf_on_change(StringToKey_(it->first), it->second, MappedType())) {
+                if (!_pf_on_change || _pf_on_change(AtomToKey_(it->first), ValueAt_(it), MappedType())) {
                     assert(val == it->second);
-                    it = values_map_.erase(it);
+                    it      = values_map_.erase(it);
+                    changed = true;
                 }
                 else {
                     ++it;
                 }
             }
             else {
-                if (val != it->second && (!_pf_on_change || _pf_on_change(StringToKey_(it->first), it->second, val))) {
-
+                if (val != it->second &&
+                    (!_pf_on_change || _pf_on_change(AtomToKey_(it->first), ValueAt_(it), val))) {
                     it->second = val;
+                    changed    = true;
                 }
 
                 ++it;
@@ -68,29 +86,34 @@ bool XContainerMap::ForEach(std::function<OnEachRes(const KeyType&, MappedType&)
             if (res == OnEachRes::Stop || res == OnEachRes::EraseStop)
                 break;
         }
+
+        if (changed)
+            values_time_.Changed();
     }
 
     return true;
 }
 
-std::optional<IContainer::MappedType> XContainerMap::At(const KeyType& _key) const
+template <class TStored>
+std::optional<IContainer::MappedType> XContainerMap<TStored>::At(const KeyType& _key) const
 {
     auto it = MapFind_(_key);
     if (it == values_map_.end())
         return std::nullopt;
 
-    return it->second;
+    return values_time_.Get(it->second);
 }
 
-std::pair<bool, IContainer::MappedType> XContainerMap::Set(const KeyType&    _key,
-                                                           const MappedType& _val,
-                                                           const OnChangePF& _pf_on_change)
+template <class TStored>
+std::pair<bool, IContainer::MappedType> XContainerMap<TStored>::Set(const KeyType&    _key,
+                                                                    const MappedType& _val,
+                                                                    const OnChangePF& _pf_on_change)
 {
     auto [it, key] = MapFind_(_key);
     if (it == values_map_.end() && key.empty())
         return {false, MappedType()}; // 2think about res
 
-    if (ValueAt_(it) == _val)
+    if (StoredAt_(it) == _val)
         return {false, ValueAt_(it)}; // 2think about res
 
     if (_pf_on_change && !_pf_on_change(_key, ValueAt_(it), _val))
@@ -98,37 +121,41 @@ std::pair<bool, IContainer::MappedType> XContainerMap::Set(const KeyType&    _ke
 
     if (it == values_map_.end()) {
         values_map_.emplace(key, _val);
+        values_time_.Changed();
         return {true, MappedType()};
     }
 
-    return {true, std::exchange(it->second, _val)};
+    return {true, values_time_.Exchange(it->second, _val)};
 }
 
-std::pair<bool, IContainer::MappedType> XContainerMap::Set(const KeyType&    _key,
-                                                           MappedType&&      _val,
-                                                           const OnChangePF& _pf_on_change)
+template <class TStored>
+std::pair<bool, IContainer::MappedType> XContainerMap<TStored>::Set(const KeyType&    _key,
+                                                                    MappedType&&      _val,
+                                                                    const OnChangePF& _pf_on_change)
 {
     auto [it, key] = MapFind_(_key);
     if (it == values_map_.end() && key.empty())
         return {false, MappedType()}; // 2think about res
 
-    if (ValueAt_(it) == _val)
+    if (StoredAt_(it) == _val)
         return {false, ValueAt_(it)}; // 2think about res
 
     if (_pf_on_change && !_pf_on_change(_key, ValueAt_(it), _val))
         return {false, ValueAt_(it)}; // 2think about res
 
     if (it == values_map_.end()) {
-        values_map_.emplace(key, _val);
+        values_map_.emplace(key, std::move(_val));
+        values_time_.Changed();
         return {true, MappedType()};
     }
 
-    return {true, std::exchange(it->second, std::move(_val))};
+    return {true, values_time_.Exchange(it->second, std::move(_val))};
 }
 
-IContainer::EmplaceRes XContainerMap::Emplace(const KeyType&    _key,
-                                              const MappedType& _val,
-                                              const OnChangePF& _pf_on_change)
+template <class TStored>
+IContainer::EmplaceRes XContainerMap<TStored>::Emplace(const KeyType&    _key,
+                                                       const MappedType& _val,
+                                                       const OnChangePF& _pf_on_change)
 {
     auto [it, key] = MapFind_(_key);
     if (key.empty() || it != values_map_.end())
@@ -138,10 +165,14 @@ IContainer::EmplaceRes XContainerMap::Emplace(const KeyType&    _key,
         return {false, _key, MappedType()}; // Add result description
 
     values_map_.emplace(key, _val);
-    return {true, StringToKey_(key), MappedType() /*_val*/};
+    values_time_.Changed();
+    return {true, AtomToKey_(key), MappedType() /*_val*/};
 }
 
-IContainer::EmplaceRes XContainerMap::Emplace(const KeyType& _key, MappedType&& _val, const OnChangePF& _pf_on_change)
+template <class TStored>
+IContainer::EmplaceRes XContainerMap<TStored>::Emplace(const KeyType&    _key,
+                                                       MappedType&&      _val,
+                                                       const OnChangePF& _pf_on_change)
 {
     auto [it, key] = MapFind_(_key);
     if (key.empty() || it != values_map_.end())
@@ -151,29 +182,53 @@ IContainer::EmplaceRes XContainerMap::Emplace(const KeyType& _key, MappedType&&
         return {false, _key, MappedType()}; // Add result description
 
     it = values_map_.emplace(key, std::move(_val)).first;
-    return {true, StringToKey_(key), MappedType() /*it->second*/};
+    values_time_.Changed();
+    return {true, AtomToKey_(key), MappedType() /*it->second*/};
 }
 
-std::optional<IContainer::MappedType> XContainerMap::Erase(const KeyType& _key, const OnChangePF& _pf_on_change)
+template <class TStored>
+std::optional<IContainer::MappedType> XContainerMap<TStored>::Erase(const KeyType&    _key,
+                                                                    const OnChangePF& _pf_on_change)
 {
     auto [it, key] = MapFind_(_key);
     if (it == values_map_.end())
         return std::nullopt;
 
-    if (_pf_on_change && !_pf_on_change(_key, it->second, MappedType()))
+    if (_pf_on_change && !_pf_on_change(_key, ValueAt_(it), MappedType()))
         return std::nullopt; // 2think about res
 
-    auto nh = values_map_.extract(it);
-    return nh.mapped();
+    auto nh     = values_map_.extract(it);
+    auto erased = values_time_.Take(nh.mapped());
+    values_time_.Changed();
+    return erased;
 }
 
-void XContainerMap::Clear() { values_map_.clear(); }
+template <class TStored>
+void XContainerMap<TStored>::Clear()
+{
+    values_map_.clear();
+    values_time_.Changed();
+}
 
-inline const IContainer::MappedType& XContainerMap::ValueAt_(
-    const typename std::map<std::string, MappedType>::const_iterator& _it) const
+template <class TStored>
+inline const XValue& XContainerMap<TStored>::StoredAt_(const typename ValuesMap::const_iterator& _it) const
 {
-    static const MappedType empty;
+    static const XValue empty;
     return _it != values_map_.end() ? _it->second : empty;
 }
 
+template <class TStored>
+inline auto XContainerMap<TStored>::ValueAt_(const typename ValuesMap::const_iterator& _it) const ->
+    typename ValuesTime::ValueRef
+{
+    static const MappedType empty;
+    if (_it == values_map_.end())
+        return empty;
+
+    return values_time_.Get(_it->second);
+}
+
+template class XContainerMap<IContainer::MappedType>;
+template class XContainerMap<XValue>;
+
 } // namespace xsdk::impl
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../xcontainer.h"
+#include "xcontainer_values.h"
 
 #include <functional>
 #include <map>
@@ -10,22 +11,28 @@
 
 namespace xsdk::impl {
 
+// TStored - MappedType or XValue (values w/o own timestamps, see XValuesTime)
+template <class TStored = IContainer::MappedType>
 class XContainerMap: public IContainer {
 
-    std::map<std::string, MappedType> values_map_;
+    using ValuesTime = XValuesTime<TStored>;
+    using ValuesMap  = std::map<xnode::StringAtom, TStored>;
 
-    static const std::string& KeyToString_(const KeyType& _key)
+    ValuesMap  values_map_;
+    ValuesTime values_time_;
+
+    static const xnode::StringAtom& KeyToAtom_(const KeyType& _key)
     {
-        static const std::string empty;
-        const auto*              str_p = std::get_if<std::string>(&_key);
-        return str_p ? *str_p : empty;
+        static const xnode::StringAtom empty;
+        const auto*                    atom_p = std::get_if<xnode::StringAtom>(&_key);
+        return atom_p ? *atom_p : empty;
     }
 
-    static KeyType StringToKey_(const std::string& _str) { return {_str}; }
-
-    static KeyType StringToKey_(std::string&& _str) { return {std::move(_str)}; }
+    static KeyType AtomToKey_(const xnode::StringAtom& _atom) { return {_atom}; }
 
 public:
+    using StoredType = TStored;
+
     XContainerMap()                         = default;
     XContainerMap(XContainerMap&&) noexcept = default;
     XContainerMap(const XContainerMap&)     = default;
@@ -66,25 +73,31 @@ public:
 
     virtual void Clear() override;
 
+    virtual bool ValuesTimed() const override { return ValuesTime::kTimed; }
+
 protected:
-    const MappedType& ValueAt_(const typename std::map<std::string, MappedType>::const_iterator& _it) const;
+    // Stored value (w/o timestamp for XValue storage) for compare
+    const XValue& StoredAt_(const typename ValuesMap::const_iterator& _it) const;
+    // Value with timestamp for callbacks and results
+    typename ValuesTime::ValueRef ValueAt_(const typename ValuesMap::const_iterator& _it) const;
 
     auto MapFind_(const KeyType& _key) const -> auto
     {
-        const auto& key = KeyToString_(_key);
+        const auto& key = KeyToAtom_(_key);
         if (key.empty())
             return values_map_.end();
 
         return values_map_.find(key);
     }
 
-    auto MapFind_(const KeyType& _key) -> auto
+    // Returns iterator and key atom (reference to atom of _key, no reference counting for lookups)
+    auto MapFind_(const KeyType& _key) -> std::pair<typename ValuesMap::iterator, const xnode::StringAtom&>
     {
-        const auto& key = KeyToString_(_key);
+        const auto& key = KeyToAtom_(_key);
         if (key.empty())
-            return std::make_pair(values_map_.end(), std::string());
+            return {values_map_.end(), key};
 
-        return std::make_pair(values_map_.find(key), key);
+        return {values_map_.find(key), key};
     }
 };
 
@@ -1,30 +1,37 @@
 #include "xcontainer_map_w_erase.h"
 
+#include "xcontainer_flat_map.h"
+#include "xcontainer_hash_map.h"
+
 namespace xsdk::impl {
 
 // 2Think: Check erased values ?
-bool XContainerMapWithErase::Empty() const { return Size() == 0; }
+template <class TMap>
+bool XContainerMapWithErase<TMap>::Empty() const { return Size() == 0; }
 
-size_t XContainerMapWithErase::Size() const
+template <class TMap>
+size_t XContainerMapWithErase<TMap>::Size() const
 {
-    assert(erased_values_ <= XContainerMap::Size());
-    return XContainerMap::Size() - erased_values_;
+    assert(erased_values_ <= TMap::Size());
+    return TMap::Size() - erased_values_;
 }
 
 // Method: return 'false' if empty or key not found
 // Callback: return 'true' for stop enumeration
-bool XContainerMapWithErase::ForPatch(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
-                                      const std::optional<KeyType>&                            _from_key) const
+template <class TMap>
+bool XContainerMapWithErase<TMap>::ForPatch(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
+                                            const std::optional<KeyType>&                            _from_key) const
 {
-    return XContainerMap::ForEach(std::move(_pf_on_item), _from_key);
+    return TMap::ForEach(std::move(_pf_on_item), _from_key);
 }
 
 // Method: return 'false' if empty or key not found
 // Callback: return 'true' for stop enumeration
-bool XContainerMapWithErase::ForEach(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
-                                     const std::optional<KeyType>&                            _from_key) const
+template <class TMap>
+bool XContainerMapWithErase<TMap>::ForEach(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
+                                           const std::optional<KeyType>&                            _from_key) const
 {
-    return XContainerMap::ForEach(
+    return TMap::ForEach(
         [&_pf_on_item](const KeyType& key, const MappedType& val) {
             if (IsErasedValue_(val))
                 return false;
@@ -38,12 +45,14 @@ bool XContainerMapWithErase::ForEach(std::function<bool(const KeyType&, const Ma
 }
 
 // Return 'false' if empty or key not found
-bool XContainerMapWithErase::ForEach(std::function<OnEachRes(const KeyType&, MappedType&)>&& _pf_on_each,
-                                     const std::optional<KeyType>&                           _from_key,
-                                     const OnChangePF&                                       _pf_on_change)
+template <class TMap>
+bool XContainerMapWithErase<TMap>::ForEach(std::function<OnEachRes(const KeyType&, MappedType&)>&& _pf_on_each,
+                                           const std::optional<KeyType>&                           _from_key,
+                                           const OnChangePF&                                       _pf_on_change)
 {
-    bool found = false;
-    XContainerMap::ForEach(
+    bool found          = false;
+    auto erased_initial = erased_values_;
+    TMap::ForEach(
         [&](const KeyType& key, MappedType& val) {
             if (IsErasedValue_(val)) {
                 // Check for erased lookup value
@@ -73,69 +82,251 @@ bool XContainerMapWithErase::ForEach(std::function<OnEachRes(const KeyType&, Map
         },
         _from_key,
         DetectErase_(_pf_on_change));
+    KeysIndexUpdate_();
+
+    if (erased_values_ > erased_initial)
+        CompactCheck_(MappedType::ClockTimestamp());
 
     return found;
 }
 
-std::pair<bool, IContainer::MappedType> XContainerMapWithErase::Set(const KeyType&    _key,
-                                                                    const MappedType& _val,
-                                                                    const OnChangePF& _pf_on_change)
+template <class TMap>
+std::optional<IContainer::KeyType> XContainerMapWithErase<TMap>::KeyAt(size_t _index) const
 {
-    return XContainerMap::Set(_key, _val, DetectErase_(_pf_on_change));
+    auto keys_index_p = std::atomic_load(&keys_index_p_);
+    if (!keys_index_p) {
+        // Erased items are kept: the items are not moved by erasing, so the erased keys could be restored in place
+        keys_index_p = std::make_shared<XKeysIndex>();
+        TMap::ForEach(
+            [&keys_index_p](const KeyType& key, const MappedType& val) {
+                keys_index_p->Insert(key, nullptr, !IsErasedValue_(val));
+                return false;
+            },
+            std::nullopt);
+
+        std::atomic_store(&keys_index_p_, keys_index_p);
+    }
+
+    assert(keys_index_p->Size() == Size());
+    return keys_index_p->KeyAt(_index);
 }
 
-std::pair<bool, IContainer::MappedType> XContainerMapWithErase::Set(const KeyType&    _key,
-                                                                    MappedType&&      _val,
-                                                                    const OnChangePF& _pf_on_change)
+template <class TMap>
+std::pair<bool, IContainer::MappedType> XContainerMapWithErase<TMap>::Set(const KeyType&    _key,
+                                                                          const MappedType& _val,
+                                                                          const OnChangePF& _pf_on_change)
 {
-    return XContainerMap::Set(_key, std::move(_val), DetectErase_(_pf_on_change));
+    auto res = TMap::Set(_key, _val, DetectErase_(_pf_on_change));
+    KeysIndexUpdate_();
+    return res;
 }
 
-IContainer::EmplaceRes XContainerMapWithErase::Emplace(const KeyType&    _key,
-                                                       const MappedType& _val,
-                                                       const OnChangePF& _pf_on_change)
+template <class TMap>
+std::pair<bool, IContainer::MappedType> XContainerMapWithErase<TMap>::Set(const KeyType&    _key,
+                                                                          MappedType&&      _val,
+                                                                          const OnChangePF& _pf_on_change)
 {
-    return XContainerMap::Emplace(_key, _val, DetectErase_(_pf_on_change));
+    auto res = TMap::Set(_key, std::move(_val), DetectErase_(_pf_on_change));
+    KeysIndexUpdate_();
+    return res;
 }
 
-IContainer::EmplaceRes XContainerMapWithErase::Emplace(const KeyType&    _key,
-                                                       MappedType&&      _val,
-                                                       const OnChangePF& _pf_on_change)
+template <class TMap>
+IContainer::EmplaceRes XContainerMapWithErase<TMap>::Emplace(const KeyType&    _key,
+                                                             const MappedType& _val,
+                                                             const OnChangePF& _pf_on_change)
 {
-    return XContainerMap::Emplace(_key, std::move(_val), DetectErase_(_pf_on_change));
+    auto res = TMap::Emplace(_key, _val, DetectErase_(_pf_on_change));
+    KeysIndexUpdate_();
+    return res;
 }
 
-std::optional<IContainer::MappedType> XContainerMapWithErase::Erase(const KeyType&    _key,
-                                                                    const OnChangePF& _pf_on_change)
+template <class TMap>
+IContainer::EmplaceRes XContainerMapWithErase<TMap>::Emplace(const KeyType&    _key,
+                                                             MappedType&&      _val,
+                                                             const OnChangePF& _pf_on_change)
 {
-    auto [success, value] = XContainerMap::Set(_key, ErasedValue_(), DetectErase_(_pf_on_change));
+    auto res = TMap::Emplace(_key, std::move(_val), DetectErase_(_pf_on_change));
+    KeysIndexUpdate_();
+    return res;
+}
+
+template <class TMap>
+std::optional<IContainer::MappedType> XContainerMapWithErase<TMap>::Erase(const KeyType&    _key,
+                                                                          const OnChangePF& _pf_on_change)
+{
+    auto erased_value     = ErasedValue_();
+    auto timestamp        = erased_value.Timestamp();
+    auto [success, value] = TMap::Set(_key, std::move(erased_value), DetectErase_(_pf_on_change));
+    KeysIndexUpdate_();
     if (!success)
         return std::nullopt;
 
+    CompactCheck_(timestamp);
     return value;
 }
 
-void XContainerMapWithErase::Clear()
+template <class TMap>
+std::optional<IContainer::MappedType> XContainerMapWithErase<TMap>::Remove(const KeyType&    _key,
+                                                                           const OnChangePF& _pf_on_change)
+{
+    // Erased item (if any) is removed too, other items could be moved
+    auto res = TMap::Erase(_key, DetectErase_(_pf_on_change));
+    keys_changed_.clear();
+    if (res.has_value())
+        KeysIndexReset_();
+    return res;
+}
+
+template <class TMap>
+void XContainerMapWithErase<TMap>::Clear()
 {
-    XContainerMap::Clear();
-    erased_values_ = 0;
+    TMap::Clear();
+    KeysIndexReset_();
+    erased_times_.clear();
+    erased_values_  = 0;
+    compact_erased_ = kErasedCompactMin;
 }
 
-IContainer::OnChangePF XContainerMapWithErase::DetectErase_(const OnChangePF& _pf_on_change)
+template <class TMap>
+void XContainerMapWithErase<TMap>::ErasedCompactionSet(double _ratio_max, double _keep_msec)
+{
+    erased_ratio_max_  = _ratio_max;
+    erased_keep_ticks_ = _keep_msec < 0 ? -1 : MappedType::MsecToTicks(_keep_msec);
+    compact_timestamp_ = MappedType::ClockTimestamp();
+}
+
+template <class TMap>
+size_t XContainerMapWithErase<TMap>::ErasedCompact(double _keep_msec)
+{
+    return Compact_(MappedType::ClockTimestamp(), MappedType::MsecToTicks(std::max(_keep_msec, 0.0)));
+}
+
+template <class TMap>
+IContainer::OnChangePF XContainerMapWithErase<TMap>::DetectErase_(const OnChangePF& _pf_on_change)
 {
     return [&](const KeyType& key, const MappedType& from, const MappedType& to) {
         bool allowed = !_pf_on_change || _pf_on_change(key, from, to);
+        if (allowed && !to.TimeIsAbsent())
+            timestamp_last_ = std::max(timestamp_last_, to.Timestamp());
+        // Key inserted or erased: the index is updated after change
+        if (allowed && keys_index_p_ && from.IsEmpty() != to.IsEmpty())
+            keys_changed_.emplace_back(key, !to.IsEmpty());
+
         if (allowed && !IsErasedValue_(from) && IsErasedValue_(to)) {
             ++erased_values_;
+            if (!TMap::ValuesTimed())
+                erased_times_[key] = to.TimeIsAbsent() ? MappedType::ClockTimestamp() : to.Timestamp();
         }
         // VVB: orignaly check !from.TimeIsAbsent() - not remember why...
         // if (allowed && !from && !from.TimeIsAbsent() && to) {
         else if (allowed && IsErasedValue_(from) && !IsErasedValue_(to)) {
             assert(erased_values_ > 0);
             --erased_values_;
+            erased_times_.erase(key);
         }
         return allowed;
     };
 }
 
+template <class TMap>
+void XContainerMapWithErase<TMap>::CompactCheck_(int64_t _timestamp)
+{
+    // Amortization: next check after erased items count doubled (from the rest of previous compaction)
+    bool ratio_enabled = erased_ratio_max_ > 0;
+    bool age_enabled   = erased_keep_ticks_ >= 0;
+    if ((!ratio_enabled && !age_enabled) || erased_values_ < compact_erased_)
+        return;
+
+    bool by_ratio = ratio_enabled && erased_values_ > erased_ratio_max_ * Size();
+    bool by_age   = age_enabled && _timestamp - compact_timestamp_ >= erased_keep_ticks_;
+    if (by_ratio || by_age)
+        Compact_(_timestamp, std::max<int64_t>(erased_keep_ticks_, 0));
+}
+
+template <class TMap>
+size_t XContainerMapWithErase<TMap>::Compact_(int64_t _timestamp, int64_t _keep_ticks)
+{
+    size_t removed = 0;
+    if (erased_values_ > 0) {
+        // Erased items are already approved -> no callback
+        bool values_timed = TMap::ValuesTimed();
+        TMap::ForEach(
+            [&](const KeyType& key, MappedType& val) {
+                if (!IsErasedValue_(val))
+                    return OnEachRes::Next;
+
+                auto it_time = values_timed ? erased_times_.end() : erased_times_.find(key);
+                auto erased  = it_time != erased_times_.end() ? it_time->second : val.Timestamp();
+                if (_timestamp - erased < _keep_ticks)
+                    return OnEachRes::Next;
+
+                if (it_time != erased_times_.end())
+                    erased_times_.erase(it_time);
+                ++removed;
+                return OnEachRes::Erase;
+            },
+            std::nullopt,
+            nullptr);
+    }
+
+    // Unordered containers could move items on erase
+    if (removed > 0)
+        KeysIndexReset_();
+
+    assert(removed <= erased_values_);
+    erased_values_ -= removed;
+    compact_timestamp_ = _timestamp;
+    compact_erased_    = std::max(kErasedCompactMin, erased_values_ * 2);
+    return removed;
+}
+
+template <class TMap>
+void XContainerMapWithErase<TMap>::KeysIndexUpdate_()
+{
+    // Called under exclusive lock, so no concurrent KeyAt() calls. Index shared with copy of container is dropped.
+    if (keys_index_p_ && keys_index_p_.use_count() > 1)
+        KeysIndexReset_();
+
+    for (const auto& change : keys_changed_) {
+        if (!keys_index_p_ || keys_index_p_->LiveSet(change.first, change.second))
+            continue;
+
+        // New key: inserted before the next item of container (the erased items are in index too)
+        std::optional<KeyType> key_next;
+        TMap::ForEach(
+            [&](const KeyType& key, const MappedType&) {
+                if (key == change.first)
+                    return false;
+
+                key_next = key;
+                return true;
+            },
+            change.first);
+
+        if (!keys_index_p_->Insert(change.first, key_next ? &key_next.value() : nullptr, change.second))
+            KeysIndexReset_();
+    }
+    keys_changed_.clear();
+}
+
+template <class TMap>
+void XContainerMapWithErase<TMap>::KeysIndexReset_()
+{
+    // Called under exclusive lock, so no concurrent KeyAt() calls
+    if (keys_index_p_)
+        std::atomic_store(&keys_index_p_, std::shared_ptr<XKeysIndex>());
+}
+
+template class XContainerMapWithErase<XContainerMap<>>;
+template class XContainerMapWithErase<XContainerHashMap<false>>;
+template class XContainerMapWithErase<XContainerHashMap<true>>;
+template class XContainerMapWithErase<XContainerFlatMap<XContainerMap<>>>;
+template class XContainerMapWithErase<XContainerFlatMap<XContainerHashMap<false>>>;
+template class XContainerMapWithErase<XContainerMap<XValue>>;
+template class XContainerMapWithErase<XContainerHashMap<false, XValue>>;
+template class XContainerMapWithErase<XContainerHashMap<true, XValue>>;
+template class XContainerMapWithErase<XContainerFlatMap<XContainerMap<XValue>>>;
+template class XContainerMapWithErase<XContainerFlatMap<XContainerHashMap<false, XValue>>>;
+
 } // namespace xsdk::impl
\ No newline at end of file
@@ -1,19 +1,52 @@
 #pragma once
 
+#include "xcontainer_keys_index.h"
 #include "xcontainer_map.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
 #include <optional>
+#include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 namespace xsdk::impl {
 
-class XContainerMapWithErase: public XContainerMap {
+// Keep erased items as empty values with timestamp (for ForPatch), TMap - underlying map container
+template <class TMap = XContainerMap<>>
+class XContainerMapWithErase: public TMap {
 
-    size_t erased_values_ = 0;
+    using KeyType    = IContainer::KeyType;
+    using MappedType = IContainer::MappedType;
+    using OnChangePF = IContainer::OnChangePF;
+    using EmplaceRes = IContainer::EmplaceRes;
+    using KeyHash    = XKeysIndex::KeyHash;
+
+    static constexpr size_t kErasedCompactMin = 16;
+
+    size_t  erased_values_  = 0;
+    int64_t timestamp_last_ = kAbsentRT; // Last timestamp of stored values
+
+    // Compaction policy and state
+    double  erased_ratio_max_  = 0.0;
+    int64_t erased_keep_ticks_ = -1;
+    int64_t compact_timestamp_ = 0;
+    size_t  compact_erased_    = kErasedCompactMin; // Erased items count for next compaction check
+
+    // Erase times of erased items for containers w/o values timestamps (common container timestamp is the time
+    // of last change, so it could not be used for age of erased items)
+    std::unordered_map<KeyType, int64_t, KeyHash> erased_times_;
+
+    // Keys in enumeration order (for access by index), built on demand and updated on keys insertion or erasing
+    // (under exclusive lock), reset if container items are moved (compaction). Accessed via std::atomic_load/store:
+    // could be built by concurrent readers (KeyAt() is const)
+    mutable std::shared_ptr<XKeysIndex>   keys_index_p_;
+    std::vector<std::pair<KeyType, bool>> keys_changed_; // Inserted or erased keys (live flag) of current change
 
     static bool IsErasedValue_(const MappedType& _value)
     {
@@ -21,10 +54,11 @@ class XContainerMapWithErase: public XContainerMap {
         return _value.IsEmpty() && !_value.TimeIsAbsent();
     }
 
-    static MappedType ErasedValue_()
+    MappedType ErasedValue_()
     {
-        // For have timestamp
-        return MappedType::EmptyWithTime();
+        // For have timestamp, greater than timestamps of previous changes (if clock is not advanced meanwhile)
+        timestamp_last_ = std::max(MappedType::ClockTimestamp(), timestamp_last_ + 1);
+        return MappedType(XValue(), timestamp_last_);
     }
 
 public:
@@ -41,12 +75,12 @@ public:
     // Method: return 'false' if empty or key not found
     // Callback: return 'true' for stop enumeration
     virtual bool ForPatch(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
-                           const std::optional<KeyType>& _from_key = std::nullopt) const override;
+                          const std::optional<KeyType>& _from_key = std::nullopt) const override;
 
     // Method: return 'false' if empty or key not found
     // Callback: return 'true' for stop enumeration
     virtual bool ForEach(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
-                          const std::optional<KeyType>& _from_key = std::nullopt) const override;
+                         const std::optional<KeyType>& _from_key = std::nullopt) const override;
 
     // Return 'false' if empty or key not found
     virtual bool ForEach( // NOLINT(readability-function-cognitive-complexity)
@@ -54,6 +88,9 @@ public:
         const std::optional<KeyType>&                           _from_key,
         const OnChangePF&                                       _pf_on_change) override;
 
+    // O(log n): keys index is built on first call and updated on keys insertion or erasing
+    virtual std::optional<KeyType> KeyAt(size_t _index) const override;
+
     virtual std::pair<bool, MappedType> Set(const KeyType&    _key,
                                             const MappedType& _val,
                                             const OnChangePF& _pf_on_change) override;
@@ -68,10 +105,23 @@ public:
 
     virtual std::optional<MappedType> Erase(const KeyType& _key, const OnChangePF& _pf_on_change) override;
 
+    virtual std::optional<MappedType> Remove(const KeyType& _key, const OnChangePF& _pf_on_change) override;
+
     virtual void Clear() override;
 
+    virtual void ErasedCompactionSet(double _ratio_max, double _keep_msec) override;
+
+    virtual size_t ErasedCompact(double _keep_msec) override;
+
 protected:
     OnChangePF DetectErase_(const OnChangePF& _pf_on_change);
+
+    // Check compaction policy after new erased items (_timestamp - time of last erase)
+    void   CompactCheck_(int64_t _timestamp);
+    size_t Compact_(int64_t _timestamp, int64_t _keep_ticks);
+
+    void KeysIndexUpdate_();
+    void KeysIndexReset_();
 };
 
 } // namespace xsdk::impl
\ No newline at end of file
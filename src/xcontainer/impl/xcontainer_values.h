@@ -0,0 +1,99 @@
+#pragma once
+
+#include "../xcontainer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace xsdk::impl {
+
+// Values timestamps policy for containers, TStored - type of stored values:
+// IContainer::MappedType - each value keep own timestamp (taken on value creation)
+// XValue                 - values stored w/o timestamps (8 bytes and clock call less per value), all values have
+//                          common container timestamp, which is taken lazily: on first read after a change
+template <class TStored>
+class XValuesTime;
+
+template <>
+class XValuesTime<IContainer::MappedType> {
+public:
+    using MappedType = IContainer::MappedType;
+    using ValueRef   = const MappedType&;
+
+    static constexpr bool kTimed = true;
+
+    static const MappedType& Get(const MappedType& _stored) { return _stored; }
+
+    static MappedType Take(MappedType& _stored) { return std::move(_stored); }
+
+    template <class TValue>
+    static MappedType Exchange(MappedType& _stored, TValue&& _val)
+    {
+        return std::exchange(_stored, std::forward<TValue>(_val));
+    }
+
+    static void Changed() {}
+};
+
+template <>
+class XValuesTime<XValue> {
+
+    using MappedType = IContainer::MappedType;
+
+    // kAbsentRT - changed after last read
+    mutable std::atomic_int64_t timestamp_      = kAbsentRT;
+    int64_t                     timestamp_prev_ = kAbsentRT; // Timestamp before last change (changed under lock)
+
+public:
+    using ValueRef = MappedType;
+
+    static constexpr bool kTimed = false;
+
+    XValuesTime() = default;
+    XValuesTime(const XValuesTime& _other) noexcept
+        : timestamp_(_other.timestamp_.load()), timestamp_prev_(_other.timestamp_prev_)
+    {
+    }
+    XValuesTime& operator=(const XValuesTime& _other) noexcept
+    {
+        timestamp_      = _other.timestamp_.load();
+        timestamp_prev_ = _other.timestamp_prev_;
+        return *this;
+    }
+
+    // Called under shared lock -> could be called concurrently.
+    // Timestamp of change is greater than previous one even if clock is not advanced meanwhile.
+    int64_t Timestamp() const
+    {
+        auto timestamp = timestamp_.load(std::memory_order_acquire);
+        if (timestamp != kAbsentRT)
+            return timestamp;
+
+        auto now = std::max(MappedType::ClockTimestamp(), timestamp_prev_ + 1);
+        return timestamp_.compare_exchange_strong(timestamp, now) ? now : timestamp;
+    }
+
+    MappedType Get(const XValue& _stored) const { return MappedType(_stored, Timestamp()); }
+
+    MappedType Take(XValue& _stored) const { return MappedType(std::move(_stored), Timestamp()); }
+
+    template <class TValue>
+    MappedType Exchange(XValue& _stored, TValue&& _val)
+    {
+        MappedType prev(std::move(_stored), Timestamp());
+        _stored = std::forward<TValue>(_val);
+        Changed();
+        return prev;
+    }
+
+    void Changed()
+    {
+        auto timestamp = timestamp_.exchange(kAbsentRT, std::memory_order_acq_rel);
+        if (timestamp != kAbsentRT)
+            timestamp_prev_ = timestamp;
+    }
+};
+
+} // namespace xsdk::impl
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "xconstant.h" // For OnEachRes
+#include "xstring.h"
 #include "xvalue/xvalue_rt.h"
 
 #include "xbase.h"
@@ -17,7 +18,8 @@ class IContainer: public xbase::PtrBase<IContainer> {
 public:
     
     // For std::map etc. partial interoperability (e.g. for tests)
-    using KeyType    = std::variant<std::monostate, size_t, std::string>;
+    // Strings keys are interned: copied w/o allocations and compared by pointer
+    using KeyType    = std::variant<std::monostate, size_t, xnode::StringAtom>;
     using MappedType = XValueRT;
 
     // If return 'false' changing prohibited
@@ -38,6 +40,49 @@ public:
     // Return nullopt if not found
     virtual std::optional<MappedType> At(const KeyType& _key) const = 0;
 
+    // Return count of items equal to _val
+    // Default implementation is O(n), could be overridden by containers with values index
+    virtual size_t ValueCount(const MappedType& _val) const
+    {
+        size_t count = 0;
+        ForEach([&](const KeyType&, const MappedType& val) {
+            if (val == _val)
+                ++count;
+            return false;
+        });
+        return count;
+    }
+
+    // Return key of item with object value (e.g. child node), nullopt if not found
+    // Default implementation is O(n), could be overridden by containers with values index
+    virtual std::optional<KeyType> ObjectKey(const IObject* _object_p) const
+    {
+        std::optional<KeyType> key_res;
+        ForEach([&](const KeyType& key, const MappedType& val) {
+            if (!val.IsObject() || val.ObjectPtrC().get() != _object_p)
+                return false;
+
+            key_res = key;
+            return true;
+        });
+        return key_res;
+    }
+
+    // Return key of item at _index position in enumeration order (nullopt if out of range)
+    // Default implementation is O(n), could be overridden by indexed containers
+    virtual std::optional<KeyType> KeyAt(size_t _index) const
+    {
+        std::optional<KeyType> key_res;
+        ForEach([&](const KeyType& key, const MappedType&) {
+            if (_index-- > 0)
+                return false;
+
+            key_res = key;
+            return true;
+        });
+        return key_res;
+    }
+
     // Method: return 'false' if empty or key not found
     // Callback: return 'true' for stop enumeration
     virtual bool ForPatch(std::function<bool(const KeyType&, const MappedType&)>&& _pf_on_item,
@@ -80,8 +125,27 @@ public:
     }
     // Return 'nullopt' if key not found or failed callback
     virtual std::optional<MappedType> Erase(const KeyType& _key, const OnChangePF& _pf_on_change = nullptr) = 0;
+    // Erase w/o keeping of erased item for ForPatch (e.g. for revert of insert)
+    virtual std::optional<MappedType> Remove(const KeyType& _key, const OnChangePF& _pf_on_change = nullptr)
+    {
+        return Erase(_key, _pf_on_change);
+    }
     // Remove all items
     virtual void Clear() = 0;
+
+    // Hint for bulk operations: prepare storage for _size items (could be ignored by container)
+    virtual void Reserve(size_t /*_size*/) {}
+
+    // Return 'false' if values stored w/o own timestamps (values timestamp is the time of container change),
+    // so values could be passed w/o timestamp (kAbsentRT)
+    virtual bool ValuesTimed() const { return true; }
+
+    // Erased items (kept for ForPatch) auto compaction policy (could be ignored by container):
+    // compact when erased items more than _ratio_max * Size() (0 - disabled) or after _keep_msec from previous
+    // compaction (negative - disabled), erased items younger than _keep_msec are kept
+    virtual void ErasedCompactionSet(double /*_ratio_max*/, double /*_keep_msec*/) {}
+    // Remove erased items older than _keep_msec, return removed items count
+    virtual size_t ErasedCompact(double /*_keep_msec*/) { return 0; }
 };
 
 } // namespace xsdk
\ No newline at end of file
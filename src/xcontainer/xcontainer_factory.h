@@ -11,7 +11,12 @@ class IContainerFactory
 {
 public:
     // 2Think: use custom container type + type match ?
-    virtual std::unique_ptr<IContainer> ContainerCreate(IContainer::ContainerType _type, bool _erase_detection) = 0;
+    virtual std::unique_ptr<IContainer> ContainerCreate(
+        IContainer::ContainerType _type,
+        bool                      _erase_detection,
+        MapLayout                 _map_layout   = MapLayout::Tree,
+        ArrayLayout               _array_layout = ArrayLayout::Vector,
+        bool                      _values_timed = true) = 0;
 };
 
 
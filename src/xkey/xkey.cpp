@@ -29,11 +29,31 @@ std::optional<size_t> XKey::IndexGet() const { return xnode::impl::VariantGet<si
 
 std::optional<std::string_view> XKey::StringGet() const { return xnode::impl::VariantGet<std::string_view>(this); }
 
-void XKey::InitHolder_()
+void XKey::InitHolder_(const xnode::String::SPtrC& _str_hold_p)
 {
     const auto* p_sv = std::get_if<std::string_view>(this);
     if (p_sv) {
-        str_hold_p_          = std::make_shared<const std::string>(*p_sv);
+        if (p_sv->size() <= xnode::StringShort::kSizeMax) {
+            str_short_           = xnode::StringShort(*p_sv);
+            (XKeyVariant&)* this = str_short_.view();
+        }
+        else if (_str_hold_p)
+            str_hold_p_ = _str_hold_p;
+        else {
+            str_hold_p_          = std::make_shared<const std::string>(*p_sv);
+            (XKeyVariant&)* this = std::string_view(*str_hold_p_);
+        }
+    }
+}
+
+void XKey::InitHolder_(std::string&& _str)
+{
+    if (_str.size() <= xnode::StringShort::kSizeMax) {
+        str_short_           = xnode::StringShort(_str);
+        (XKeyVariant&)* this = str_short_.view();
+    }
+    else {
+        str_hold_p_          = std::make_shared<const std::string>(std::move(_str));
         (XKeyVariant&)* this = std::string_view(*str_hold_p_);
     }
 }
@@ -0,0 +1,253 @@
+#include "xstring.h"
+
+#include "../xnode/impl/xepoch.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace xsdk::xnode {
+
+// Sharded open-addressing (linear probing) table of entries pointers.
+// Readers are lock-free (in epoch critical section): slots are changed by filling empty slots and by marking
+// removed entries slots (via atomic store), on growth or cleanup new table is published. Removed entries and
+// replaced tables are retired and deleted when no reader could access them (@see impl::XEpoch).
+class StringAtom::Table {
+
+    static constexpr size_t kShardsBits = 6;
+    static constexpr size_t kShards     = 1 << kShardsBits;
+    static constexpr size_t kSlotsMin   = 16;
+
+    struct Slots {
+        explicit Slots(size_t _count) : mask(_count - 1), slots(new std::atomic<const Entry*>[_count]()) {}
+
+        size_t                                       mask;
+        std::unique_ptr<std::atomic<const Entry*>[]> slots;
+    };
+
+    struct alignas(64) Shard {
+        std::atomic<const Slots*> slots_p = nullptr;
+        std::mutex                mutex; // For insertion and removal
+        size_t                    count = 0; // Entries in table
+        size_t                    used  = 0; // Not empty slots (entries and removed marks)
+    };
+
+    Shard shards_[kShards];
+
+    // Mark of slot of removed entry (the probing continues after it)
+    static const Entry* Removed_()
+    {
+        static const Entry removed;
+        return &removed;
+    }
+
+    static const Entry* SlotsFind_(const Slots* _slots_p, std::string_view _str, size_t _hash)
+    {
+        if (!_slots_p)
+            return nullptr;
+
+        for (size_t idx = (_hash >> kShardsBits) & _slots_p->mask;; idx = (idx + 1) & _slots_p->mask) {
+            const auto* entry_p = _slots_p->slots[idx].load(std::memory_order_acquire);
+            if (!entry_p || (entry_p != Removed_() && entry_p->hash == _hash && entry_p->str == _str))
+                return entry_p;
+        }
+    }
+
+    static void SlotsPut_(const Slots* _slots_p, const Entry* _entry_p)
+    {
+        auto idx = (_entry_p->hash >> kShardsBits) & _slots_p->mask;
+        while (_slots_p->slots[idx].load(std::memory_order_relaxed))
+            idx = (idx + 1) & _slots_p->mask;
+
+        _slots_p->slots[idx].store(_entry_p, std::memory_order_release);
+    }
+
+    // Add reference if the entry is not released (the released entry could be removed by other thread)
+    static bool AcquireAlive_(const Entry* _entry_p)
+    {
+        auto refs = _entry_p->refs.load(std::memory_order_relaxed);
+        while (refs > 0) {
+            if (_entry_p->refs.compare_exchange_weak(refs, refs + 1, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+public:
+    static Table& Get()
+    {
+        // Never destroyed: atoms could be used by static objects destructors
+        static auto* table_p = new Table();
+        return *table_p;
+    }
+
+    // Find w/o reference: the caller should be in epoch critical section
+    const Entry* Lookup(std::string_view _str)
+    {
+        auto        hash    = std::hash<std::string_view> {}(_str);
+        const auto* slots_p = shards_[hash & (kShards - 1)].slots_p.load(std::memory_order_acquire);
+        const auto* entry_p = SlotsFind_(slots_p, _str, hash);
+        return entry_p && entry_p->refs.load(std::memory_order_relaxed) > 0 ? entry_p : nullptr;
+    }
+
+    // Add reference to entry, released entry (could be removed from table) is replaced by entry of the same string
+    const Entry* Acquire(const Entry* _entry_p)
+    {
+        return AcquireAlive_(_entry_p) ? _entry_p : Intern(_entry_p->str, true);
+    }
+
+    const Entry* Intern(std::string_view _str, bool _insert)
+    {
+        auto  hash  = std::hash<std::string_view> {}(_str);
+        auto& shard = shards_[hash & (kShards - 1)];
+        {
+            impl::XEpoch::Guard guard;
+            const auto*         entry_p = SlotsFind_(shard.slots_p.load(std::memory_order_acquire), _str, hash);
+            if (entry_p && AcquireAlive_(entry_p))
+                return entry_p;
+        }
+        if (!_insert)
+            return nullptr;
+
+        const Slots* slots_retired_p = nullptr;
+        const Entry* entry_p         = nullptr;
+        {
+            std::lock_guard lock(shard.mutex);
+            // Could be inserted by other thread, released entry is not removed yet (removal is under lock)
+            const auto* slots_p = shard.slots_p.load(std::memory_order_relaxed);
+            entry_p             = SlotsFind_(slots_p, _str, hash);
+            if (entry_p) {
+                entry_p->refs.fetch_add(1, std::memory_order_relaxed);
+                return entry_p;
+            }
+
+            // Keep load factor (including removed marks) <= 0.5, new table w/o removed marks
+            if (!slots_p || (shard.used + 1) * 2 > slots_p->mask + 1) {
+                size_t size = kSlotsMin;
+                while (size < (shard.count + 1) * 4)
+                    size *= 2;
+
+                auto slots_new_p = std::make_unique<Slots>(size);
+                for (size_t idx = 0; slots_p && idx <= slots_p->mask; ++idx) {
+                    const auto* slot_entry_p = slots_p->slots[idx].load(std::memory_order_relaxed);
+                    if (slot_entry_p && slot_entry_p != Removed_())
+                        SlotsPut_(slots_new_p.get(), slot_entry_p);
+                }
+
+                slots_retired_p = slots_p;
+                slots_p         = slots_new_p.release();
+                shard.used      = shard.count;
+                shard.slots_p.store(slots_p, std::memory_order_release);
+            }
+
+            entry_p = new Entry {hash, std::string(_str)};
+            SlotsPut_(slots_p, entry_p);
+            ++shard.count;
+            ++shard.used;
+        }
+
+        impl::XEpoch::Retire(slots_retired_p);
+        return entry_p;
+    }
+
+    void Release(const Entry* _entry_p)
+    {
+        // The entry could be removed by other thread after the last reference release (e.g. if it was
+        // acquired and released again meanwhile): it is not deleted until the end of critical section
+        impl::XEpoch::Guard guard;
+        if (_entry_p->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+
+        auto& shard = shards_[_entry_p->hash & (kShards - 1)];
+        {
+            std::lock_guard lock(shard.mutex);
+            // Acquired again or already removed
+            if (_entry_p->refs.load(std::memory_order_relaxed) > 0)
+                return;
+
+            const auto* slots_p = shard.slots_p.load(std::memory_order_relaxed);
+            auto        idx     = (_entry_p->hash >> kShardsBits) & slots_p->mask;
+            const Entry* slot_entry_p = nullptr;
+            while ((slot_entry_p = slots_p->slots[idx].load(std::memory_order_relaxed)) && slot_entry_p != _entry_p)
+                idx = (idx + 1) & slots_p->mask;
+            if (!slot_entry_p)
+                return;
+
+            slots_p->slots[idx].store(Removed_(), std::memory_order_release);
+            --shard.count;
+        }
+
+        impl::XEpoch::Retire(_entry_p);
+    }
+
+    size_t Count()
+    {
+        size_t count = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            count += shard.count;
+        }
+        return count;
+    }
+};
+
+/*static*/ const StringAtom::Entry* StringAtom::Intern_(std::string_view _str, bool _insert)
+{
+    if (_str.empty())
+        return nullptr;
+
+    return Table::Get().Intern(_str, _insert);
+}
+
+/*static*/ StringAtom StringAtom::Borrow(std::string_view _str)
+{
+    if (_str.empty())
+        return {};
+
+    // Critical section is kept by borrowed atom
+    impl::XEpoch::Enter();
+    const auto* entry_p = Table::Get().Lookup(_str);
+    if (!entry_p) {
+        impl::XEpoch::Leave();
+        return {};
+    }
+
+    StringAtom atom;
+    atom.bits_ = reinterpret_cast<uintptr_t>(entry_p) | kBorrowed;
+    return atom;
+}
+
+/*static*/ StringAtom StringAtom::Borrow(const StringAtom& _atom)
+{
+    if (_atom.empty())
+        return {};
+
+    impl::XEpoch::Enter();
+    StringAtom atom;
+    atom.bits_ = reinterpret_cast<uintptr_t>(_atom.Entry_()) | kBorrowed;
+    return atom;
+}
+
+/*static*/ const StringAtom::Entry* StringAtom::Acquire_(const Entry* _entry_p)
+{
+    return Table::Get().Acquire(_entry_p);
+}
+
+/*static*/ void StringAtom::Leave_() { impl::XEpoch::Leave(); }
+
+/*static*/ void StringAtom::Release_(const Entry* _entry_p)
+{
+    // Not the last reference: the entry is not removed while the reference is held
+    auto refs = _entry_p->refs.load(std::memory_order_relaxed);
+    while (refs > 1) {
+        if (_entry_p->refs.compare_exchange_weak(refs, refs - 1, std::memory_order_release, std::memory_order_relaxed))
+            return;
+    }
+
+    Table::Get().Release(_entry_p);
+}
+
+/*static*/ size_t StringAtom::Count() { return Table::Get().Count(); }
+
+} // namespace xsdk::xnode
@@ -0,0 +1,64 @@
+#include "xnode_builder.h"
+#include "xnode_factory_impl.h"
+
+#include "../impl/xnode_impl.h"
+
+#include <cassert>
+#include <utility>
+
+namespace xsdk::impl {
+
+XNodeBuilder::XNodeBuilder(const std::optional<INodeFactory::Options>& _options)
+    : options_(_options.has_value() ? _options.value() : XNodeFactoryGet()->OptionsDefaultGet())
+{
+}
+
+XNodeBuilder::~XNodeBuilder()
+{
+    // Nodes not ended (e.g. by parse error) are published as is
+    while (NodeEnd())
+        ;
+}
+
+bool XNodeBuilder::NodeStart(INode::NodeType _type, const XKey& _key, std::string_view _name, uint64_t _uid)
+{
+    // Map key is the name of child (set on creation, not by put)
+    bool in_map = !nodes_.empty() && nodes_.back()->Type() == INode::NodeType::Map;
+    auto node_p = XNodeFactory::XNodeCreate(_type, in_map ? _key.StringGet().value_or("") : _name, _uid, options_);
+    if (!node_p)
+        return false;
+
+    if (nodes_.empty()) {
+        assert(root_.IsEmpty());
+        root_ = XValue(std::static_pointer_cast<INode>(node_p));
+    }
+    else if (!nodes_.back()->BuildPut(_key, std::static_pointer_cast<INode>(node_p), node_p.get())) {
+        return false;
+    }
+
+    nodes_.push_back(std::move(node_p));
+    return true;
+}
+
+bool XNodeBuilder::NodeEnd()
+{
+    if (nodes_.empty())
+        return false;
+
+    nodes_.back()->BuildEnd();
+    nodes_.pop_back();
+    return true;
+}
+
+bool XNodeBuilder::ValuePut(const XKey& _key, XValue&& _val)
+{
+    if (nodes_.empty()) {
+        assert(root_.IsEmpty());
+        root_ = std::move(_val);
+        return true;
+    }
+
+    return nodes_.back()->BuildPut(_key, std::move(_val));
+}
+
+} // namespace xsdk::impl
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "xnode_factory.h"
+
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace xsdk::impl {
+
+class XNode;
+
+// Direct builder of new tree (e.g. by parsers): nodes are filled w/o INode::Insert() overhead (locks, callbacks,
+// parents validation), parent link of child is set once on put, each node is published on its end.
+// The tree is private until Root() is taken, the object itself is not thread safe.
+class XNodeBuilder {
+public:
+    // Nodes are created with given options (factory defaults if not specified)
+    explicit XNodeBuilder(const std::optional<INodeFactory::Options>& _options = std::nullopt);
+    // Not ended nodes are ended
+    ~XNodeBuilder();
+
+    // Start node: root (with name and uid) or child put into current node by key
+    bool NodeStart(INode::NodeType _type, const XKey& _key, std::string_view _name = {}, uint64_t _uid = 0);
+    // End current node, return false if there is no started node
+    bool NodeEnd();
+    // Put value into current node or set root value, return false for duplicated key
+    bool ValuePut(const XKey& _key, XValue&& _val);
+
+    // Count of started (not ended) nodes
+    size_t        Depth() const { return nodes_.size(); }
+    const XValue& Root() const { return root_; }
+
+private:
+    INodeFactory::Options               options_;
+    std::vector<std::shared_ptr<XNode>> nodes_; // Started nodes, the last one is current
+    XValue                              root_;
+};
+
+} // namespace xsdk::impl
@@ -21,17 +21,35 @@ namespace impl {
 
 std::shared_ptr<INodeFactory> XNodeFactory::create() { return std::shared_ptr<INodeFactory> {new XNodeFactory()}; }
 
-/*virtual*/ INode::SPtr XNodeFactory::NodeCreate(INode::NodeType _type, std::string_view _name, uint64_t _uid)
+/*virtual*/ INode::SPtr XNodeFactory::NodeCreate(INode::NodeType               _type,
+                                                 std::string_view              _name,
+                                                 uint64_t                      _uid,
+                                                 const std::optional<Options>& _options)
+{
+    return XNodeCreate(_type, _name, _uid, _options.has_value() ? _options.value() : OptionsDefaultGet());
+}
+
+/*static*/ std::shared_ptr<XNode> XNodeFactory::XNodeCreate(INode::NodeType  _type,
+                                                          std::string_view _name,
+                                                          uint64_t         _uid,
+                                                          const Options&   _options)
 {
     IContainer::ContainerType containter_type = _type == INode::NodeType::Array ? IContainer::ContainerType::Array :
                                                                                   IContainer::ContainerType::Map;
 
     // Create container
-    auto container_p = XContainerFactoryGet()->ContainerCreate(containter_type, _type == INode::NodeType::Map);
+    auto container_p = XContainerFactoryGet()->ContainerCreate(containter_type,
+                                                               _type == INode::NodeType::Map,
+                                                               _options.map_layout,
+                                                               _options.array_layout,
+                                                               _options.values_timed);
     assert(container_p);
     if (!container_p)
         return nullptr;
 
+    if (containter_type == IContainer::ContainerType::Map)
+        container_p->ErasedCompactionSet(_options.erased_ratio_max, _options.erased_keep_msec);
+
     // Create container match
     std::unique_ptr<IContainerMatch>  container_match;
     std::unique_ptr<IParentValidator> parent_validator;
@@ -45,10 +63,27 @@ std::shared_ptr<INodeFactory> XNodeFactory::create() { return std::shared_ptr<IN
         parent_validator = std::make_unique<XParentValidatorMap>();
     }
 
-    auto node = XNode::Create(std::move(container_match), std::move(parent_validator), _uid, _name);
+    auto node = XNode::Create(std::move(container_match),
+                              std::move(parent_validator),
+                              _uid,
+                              _name,
+                              _options.read_snapshots,
+                              _options.scalar_slots);
     assert(node);
     return node;
 }
 
+/*virtual*/ void XNodeFactory::OptionsDefaultSet(const Options& _options)
+{
+    std::unique_lock lck(options_rw_);
+    options_default_ = _options;
+}
+
+/*virtual*/ INodeFactory::Options XNodeFactory::OptionsDefaultGet() const
+{
+    std::shared_lock lck(options_rw_);
+    return options_default_;
+}
+
 } // namespace impl
 } // namespace xsdk
\ No newline at end of file
@@ -3,20 +3,38 @@
 #include "xnode_factory.h"
 
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <cassert>
 
 namespace xsdk::impl {
 
+class XNode;
+
 class XNodeFactory final: public INodeFactory, public std::enable_shared_from_this<XNodeFactory> {
 
+    mutable std::shared_mutex options_rw_;
+    Options                   options_default_;
+
     XNodeFactory() = default;
 
 public:
     static std::shared_ptr<INodeFactory> create();
 
+    // Create node implementation with given options (e.g. for direct build of tree, @see XNodeBuilder)
+    static std::shared_ptr<XNode> XNodeCreate(INode::NodeType  _type,
+                                              std::string_view _name,
+                                              uint64_t         _uid,
+                                              const Options&   _options);
+
 public:
-    virtual INode::SPtr NodeCreate(INode::NodeType _type, std::string_view _name, uint64_t _uid) override;
+    virtual INode::SPtr NodeCreate(INode::NodeType               _type,
+                                   std::string_view              _name,
+                                   uint64_t                      _uid,
+                                   const std::optional<Options>& _options) override;
+
+    virtual void    OptionsDefaultSet(const Options& _options) override;
+    virtual Options OptionsDefaultGet() const override;
 };
 
 } // namespace xsdk::impl
\ No newline at end of file
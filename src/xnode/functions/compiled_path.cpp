@@ -0,0 +1,102 @@
+#include "xnode_functions.h"
+#include "xnode_path.h"
+
+namespace xsdk::xnode {
+
+namespace {
+
+// Intern string keys once (the compiled paths are expected to be reused)
+XPath PathIntern(XPath&& _path)
+{
+    for (auto& key : _path) {
+        auto str = key.StringGet();
+        if (str.has_value() && !str->empty())
+            key = XKey(xnode::StringAtom(*str));
+    }
+    return std::move(_path);
+}
+
+} // namespace
+
+CompiledPath::CompiledPath(XPath _path, bool _cache_nodes)
+    : path_(PathIntern(std::move(_path))), cache_nodes_(_cache_nodes)
+{
+}
+
+void CompiledPath::CacheReset()
+{
+    root_wp_.reset();
+    levels_.clear();
+}
+
+INode::SPtr CompiledPath::NodeGet(const INode::SPtr& _root) { return Resolve_(_root, path_.size()); }
+
+XValueRT CompiledPath::At(const INode::SPtr& _root)
+{
+    if (path_.empty())
+        return {};
+
+    auto node_dest = Resolve_(_root, path_.size() - 1);
+    if (!node_dest)
+        return {};
+
+    return node_dest->At(path_.back());
+}
+
+std::pair<bool, XValueRT> CompiledPath::Set(const INode::SPtr& _root, XValue&& _val)
+{
+    if (path_.empty())
+        return {};
+
+    auto node_dest = Resolve_(_root, path_.size() - 1);
+    if (!node_dest)
+        return xnode::Set(_root, XPath(path_), std::move(_val)); // Create missed nodes
+
+    return node_dest->Set(path_.back(), std::move(_val));
+}
+
+XValueRT CompiledPath::Erase(const INode::SPtr& _root)
+{
+    if (path_.empty())
+        return {};
+
+    auto node_dest = Resolve_(_root, path_.size() - 1);
+    if (!node_dest)
+        return {};
+
+    return node_dest->Erase(path_.back());
+}
+
+INode::SPtr CompiledPath::Resolve_(const INode::SPtr& _root, size_t _depth)
+{
+    // Compare control blocks: cheaper than lock(), and block can't be reused while root_wp_ is alive
+    if (root_wp_.owner_before(_root) || _root.owner_before(root_wp_)) {
+        levels_.clear();
+        root_wp_ = _root;
+    }
+
+    INode::SPtr node_dest = _root;
+    for (size_t idx = 0; node_dest && idx < _depth; ++idx) {
+        // Read generation before lookup: the change after read would invalidate cached node
+        auto generation = node_dest->Generation();
+        if (idx < levels_.size()) {
+            if (levels_[idx].parent_generation == generation) {
+                auto node_cached = levels_[idx].node_wp.lock();
+                if (node_cached) {
+                    node_dest = std::move(node_cached);
+                    continue;
+                }
+            }
+
+            levels_.resize(idx);
+        }
+
+        node_dest = node_dest->At(path_[idx]).QueryPtr<INode>();
+        if (node_dest && cache_nodes_)
+            levels_.push_back({node_dest, generation});
+    }
+
+    return node_dest;
+}
+
+} // namespace xsdk::xnode
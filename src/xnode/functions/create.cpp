@@ -4,9 +4,12 @@
 
 namespace xsdk {
 
-INode::SPtr xnode::Create(INode::NodeType _type, std::string_view _name /*= {}*/, uint64_t _uid /*= 0*/)
+INode::SPtr xnode::Create(INode::NodeType                             _type,
+                          std::string_view                            _name /*= {}*/,
+                          uint64_t                                    _uid /*= 0*/,
+                          const std::optional<INodeFactory::Options>& _options /*= std::nullopt*/)
 {
-    return XNodeFactoryGet()->NodeCreate(_type, _name, _uid);
+    return XNodeFactoryGet()->NodeCreate(_type, _name, _uid, _options);
 }
 
 INode::SPtr xnode::CreateArray(std::vector<XValue>&& _values,
@@ -0,0 +1,161 @@
+#include "../impl/xnode_impl.h"
+#include "../xkey_type_match.h"
+#include "xnode_functions.h"
+#include "xnode_transaction.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace xsdk::xnode {
+
+Transaction::Transaction(INode::SPtr _root) : root_p_(std::move(_root)) { assert(root_p_); }
+
+bool Transaction::Set(XPath _path, XValue&& _val)
+{
+    if (_path.empty() || _val.IsObject())
+        return false;
+
+    writes_.emplace_back(std::move(_path), std::move(_val));
+    return true;
+}
+
+bool Transaction::Erase(XPath _path)
+{
+    if (_path.empty())
+        return false;
+
+    writes_.emplace_back(std::move(_path), XValue());
+    return true;
+}
+
+bool Transaction::Commit()
+{
+    struct NodeChanges {
+        INode::SPtr                                    node_p;
+        std::shared_ptr<impl::INodePrivate>            private_p;
+        std::vector<impl::INodePrivate::PrivateChange> changes;
+    };
+
+    // Changes grouped by nodes, nodes are ordered by address: the locks order for all transactions
+    std::map<const INode*, NodeChanges> nodes;
+
+    // Missed intermediate nodes are created before locks: the top created nodes {parent, node} are removed
+    // if the transaction is aborted
+    std::vector<std::pair<INode::SPtr, INode::SPtr>> created;
+    auto                                             pf_abort = [&created] {
+        for (auto it = created.rbegin(); it != created.rend(); ++it) {
+            const auto& node_p    = it->second;
+            auto        private_p = xobject::PtrQuery<impl::INodePrivate>(it->first.get());
+            auto        key       = private_p ? private_p->PrivateChildKey(node_p) : XKey();
+            if (!key)
+                continue;
+
+            // Not removed if the node was replaced meanwhile
+            it->first->ForEach(
+                [&](const XKey&, XValueRT& _val) {
+                    return _val.QueryPtr<INode>() == node_p ? OnEachRes::EraseStop : OnEachRes::Stop;
+                },
+                key);
+        }
+        return false;
+    };
+
+    // Nodes are resolved once for subsequent writes into the same node
+    auto         writes      = std::exchange(writes_, {});
+    const XPath* path_prev_p = nullptr;
+    INode::SPtr  node_prev_p;
+    bool         node_prev_created = false;
+    for (auto& [path, val] : writes) {
+        auto key         = path.pop_back();
+        bool create_node = !val.IsEmpty();
+        if (!path_prev_p || path != *path_prev_p || (create_node && !node_prev_created)) {
+            node_prev_p = root_p_;
+            if (!create_node) {
+                // W/o nodes creation
+                for (size_t i = 0; node_prev_p && i < path.size(); ++i)
+                    node_prev_p = node_prev_p->At(path[i]).QueryPtr<INode>();
+            }
+            else if (!path.empty()) {
+                // The deepest existing node of path
+                INode::SPtr parent_p = root_p_;
+                for (size_t i = 0; i < path.size(); ++i) {
+                    auto child_p = parent_p->At(path[i]).QueryPtr<INode>();
+                    if (!child_p)
+                        break;
+                    parent_p = std::move(child_p);
+                }
+
+                node_prev_p = xnode::NodeGet(root_p_, XPath(path), XKeyToNodeType::Match(key));
+                auto top_p  = node_prev_p;
+                while (top_p && top_p != parent_p && top_p->ParentGet() != parent_p)
+                    top_p = top_p->ParentGet();
+                if (top_p && top_p != parent_p)
+                    created.emplace_back(std::move(parent_p), std::move(top_p));
+            }
+            path_prev_p       = &path;
+            node_prev_created = create_node;
+        }
+
+        auto node_p = node_prev_p;
+
+        // Nothing to erase
+        if (!node_p && val.IsEmpty())
+            continue;
+
+        auto& node_changes = nodes[node_p.get()];
+        if (!node_changes.private_p) {
+            node_changes.private_p = xobject::PtrQuery<impl::INodePrivate>(node_p.get());
+            if (!node_changes.private_p)
+                return pf_abort();
+
+            node_changes.node_p = std::move(node_p);
+        }
+
+        // Changes of the same map key are merged, array changes are applied in order (indexes are shifted by erases)
+        auto& changes = node_changes.changes;
+        auto  it      = changes.end();
+        if (node_changes.node_p->Type() == INode::NodeType::Map)
+            it = std::find_if(changes.begin(), changes.end(), [&](const auto& _change) { return _change.key == key; });
+        if (it != changes.end())
+            it->to = std::move(val);
+        else
+            changes.push_back({std::move(key), std::move(val), XValueRT(), false, XKey(), 0});
+    }
+
+    for (auto& node_item : nodes)
+        node_item.second.private_p->PrivateLock();
+
+    auto it_failed = nodes.end();
+    for (auto it = nodes.begin(); it != nodes.end(); ++it) {
+        if (!it->second.private_p->PrivateApply(it->second.changes)) {
+            it_failed = it;
+            break;
+        }
+    }
+
+    if (it_failed != nodes.end()) {
+        for (auto it = nodes.begin(); it != it_failed; ++it)
+            it->second.private_p->PrivateRevert(it->second.changes);
+    }
+
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
+        it->second.private_p->PrivateUnlock();
+
+    if (it_failed != nodes.end())
+        return pf_abort();
+
+    // Replaced and erased nodes are detached after unlock (as by regular changes)
+    for (const auto& node_item : nodes) {
+        for (const auto& change : node_item.second.changes) {
+            auto node_removed_p = change.applied ? change.from.QueryPtr<INode>() : nullptr;
+            auto private_p      = xobject::PtrQuery<impl::INodePrivate>(node_removed_p.get());
+            if (private_p)
+                private_p->PrivateParentSet(nullptr);
+        }
+    }
+
+    return true;
+}
+
+} // namespace xsdk::xnode
@@ -0,0 +1,253 @@
+#include "xasync_dispatcher.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <utility>
+
+namespace xsdk::impl {
+
+namespace {
+// Queue drained by current thread (for async callbacks posting notifications)
+thread_local const void* g_thread_queue_p = nullptr;
+
+template <class T>
+void AtomicMax(std::atomic<T>& _max, T _val)
+{
+    auto max = _max.load(std::memory_order_relaxed);
+    while (max < _val && !_max.compare_exchange_weak(max, _val, std::memory_order_relaxed))
+        ;
+}
+} // namespace
+
+XAsyncDispatcher::Queue::Queue(size_t _size) : mask(_size - 1), cells_p(new Cell[_size])
+{
+    for (size_t idx = 0; idx < _size; ++idx)
+        cells_p[idx].sequence.store(idx, std::memory_order_relaxed);
+}
+
+bool XAsyncDispatcher::Queue::Push(Event&& _event)
+{
+    // Cell is free for position if its sequence equals the position, writers reserve position by CAS of tail
+    auto  pos    = tail.load(std::memory_order_relaxed);
+    Cell* cell_p = nullptr;
+    for (;;) {
+        cell_p        = &cells_p[pos & mask];
+        auto sequence = cell_p->sequence.load(std::memory_order_acquire);
+        auto diff     = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0) {
+            return false; // Full: the cell is not read yet
+        }
+        else {
+            pos = tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell_p->event = std::move(_event);
+    cell_p->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool XAsyncDispatcher::Queue::Pop(Event& _event)
+{
+    auto& cell = cells_p[head & mask];
+    if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+        return false;
+
+    // Cell is released w/o references to nodes and values
+    _event = std::exchange(cell.event, Event());
+    cell.sequence.store(head + mask + 1, std::memory_order_release);
+    ++head;
+    return true;
+}
+
+bool XAsyncDispatcher::Queue::Empty() const
+{
+    return cells_p[head & mask].sequence.load(std::memory_order_acquire) != head + 1;
+}
+
+/*static*/ XAsyncDispatcher& XAsyncDispatcher::Get()
+{
+    // Never destroyed: nodes could be changed by static objects destructors
+    static auto* dispatcher_p = new XAsyncDispatcher();
+    return *dispatcher_p;
+}
+
+bool XAsyncDispatcher::Configure(const xnode::AsyncOptions& _options)
+{
+    std::lock_guard lck(start_mutex_);
+    if (started_.load(std::memory_order_relaxed))
+        return false;
+
+    options_ = _options;
+    return true;
+}
+
+xnode::AsyncMetrics XAsyncDispatcher::Metrics() const
+{
+    xnode::AsyncMetrics metrics;
+    if (!started_.load(std::memory_order_acquire))
+        return metrics;
+
+    int64_t latency_max = 0;
+    for (const auto& queue_p : queues_) {
+        auto delivered = queue_p->delivered.load(std::memory_order_relaxed);
+        auto enqueued  = std::max(queue_p->enqueued.load(std::memory_order_relaxed), delivered);
+
+        metrics.depth += enqueued - delivered;
+        metrics.depth_max = std::max(metrics.depth_max, queue_p->depth_max.load(std::memory_order_relaxed));
+        metrics.enqueued += enqueued;
+        metrics.delivered += delivered;
+        metrics.dropped += queue_p->dropped.load(std::memory_order_relaxed);
+        metrics.blocked += queue_p->blocked.load(std::memory_order_relaxed);
+        metrics.latency_avg_usec += queue_p->latency_sum.load(std::memory_order_relaxed) / 1000.0;
+        latency_max = std::max(latency_max, queue_p->latency_max.load(std::memory_order_relaxed));
+    }
+    if (metrics.delivered)
+        metrics.latency_avg_usec /= metrics.delivered;
+    metrics.latency_max_usec = latency_max / 1000.0;
+    return metrics;
+}
+
+void XAsyncDispatcher::Flush()
+{
+    assert(!g_thread_queue_p && "flush from async callback");
+    if (g_thread_queue_p || !started_.load(std::memory_order_acquire))
+        return;
+
+    // All reserved positions are written (and then delivered) by writers in progress
+    for (const auto& queue_p : queues_) {
+        auto target = queue_p->tail.load(std::memory_order_acquire);
+        while (queue_p->delivered.load(std::memory_order_acquire) < target && !stopped_.load())
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+std::shared_ptr<XAsyncDispatcher::Subscriber> XAsyncDispatcher::SubscriberMake(INode::OnChangePF&& _pf)
+{
+    if (!started_.load(std::memory_order_acquire))
+        Start_();
+
+    auto queue_idx = subscribers_next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    return std::make_shared<Subscriber>(std::move(_pf), queue_idx);
+}
+
+void XAsyncDispatcher::Post(Event&& _event)
+{
+    assert(_event.subscriber_p && started_);
+    auto& queue = *queues_[_event.subscriber_p->queue_idx];
+    if (stopped_.load(std::memory_order_relaxed)) {
+        queue.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Writer of async callback can't wait for own queue
+    bool drop = options_.overflow == xnode::AsyncOptions::Overflow::Drop || g_thread_queue_p == &queue;
+
+    _event.posted_ns = NowNs_();
+    for (bool waited = false; !queue.Push(std::move(_event)); waited = true) {
+        if (drop || stopped_.load(std::memory_order_relaxed)) {
+            queue.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (!waited)
+            queue.blocked.fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::yield();
+    }
+
+    auto enqueued = queue.enqueued.fetch_add(1, std::memory_order_relaxed) + 1;
+    AtomicMax(queue.depth_max, static_cast<size_t>(enqueued - queue.delivered.load(std::memory_order_relaxed)));
+
+    // Pushed cell is ordered before check of sleeping flag (paired with fence in Run_())
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (queue.sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard lck(queue.wake_mutex);
+        queue.wake_cv.notify_one();
+    }
+}
+
+void XAsyncDispatcher::Start_()
+{
+    std::lock_guard lck(start_mutex_);
+    if (started_.load(std::memory_order_relaxed))
+        return;
+
+    size_t queue_size = 2;
+    while (queue_size < options_.queue_size)
+        queue_size *= 2;
+
+    for (size_t idx = 0; idx < std::max<size_t>(options_.threads, 1); ++idx)
+        queues_.push_back(std::make_unique<Queue>(queue_size));
+    for (const auto& queue_p : queues_)
+        threads_.emplace_back([this, queue_p = queue_p.get()] { Run_(queue_p); });
+
+    std::atexit([] { Get().Stop_(); });
+    started_.store(true, std::memory_order_release);
+}
+
+void XAsyncDispatcher::Stop_()
+{
+    stopped_.store(true);
+    for (const auto& queue_p : queues_) {
+        std::lock_guard lck(queue_p->wake_mutex);
+        queue_p->wake_cv.notify_one();
+    }
+    for (auto& thread : threads_)
+        thread.join();
+}
+
+void XAsyncDispatcher::Run_(Queue* _queue_p)
+{
+    g_thread_queue_p = _queue_p;
+
+    Event event;
+    while (!stopped_.load(std::memory_order_relaxed)) {
+        if (!_queue_p->Pop(event)) {
+            std::unique_lock lck(_queue_p->wake_mutex);
+            _queue_p->sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_queue_p->Empty() && !stopped_.load())
+                _queue_p->wake_cv.wait_for(lck, std::chrono::milliseconds(100));
+            _queue_p->sleeping.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        auto latency = NowNs_() - event.posted_ns;
+        _queue_p->latency_sum.fetch_add(latency, std::memory_order_relaxed);
+        AtomicMax(_queue_p->latency_max, latency);
+
+        auto& subscriber = *event.subscriber_p;
+        if (!subscriber.expired.load(std::memory_order_relaxed)) {
+            auto res_opt = subscriber.pf(event.reason, event.node_p, event.key, event.from, event.to);
+            if (!res_opt.has_value())
+                subscriber.expired.store(true, std::memory_order_relaxed);
+        }
+
+        event = Event();
+        _queue_p->delivered.fetch_add(1, std::memory_order_release);
+    }
+}
+
+/*static*/ int64_t XAsyncDispatcher::NowNs_()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace xsdk::impl
+
+namespace xsdk::xnode {
+
+bool AsyncConfigure(const AsyncOptions& _options) { return impl::XAsyncDispatcher::Get().Configure(_options); }
+
+AsyncMetrics AsyncMetricsGet() { return impl::XAsyncDispatcher::Get().Metrics(); }
+
+void AsyncFlush() { impl::XAsyncDispatcher::Get().Flush(); }
+
+} // namespace xsdk::xnode
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "xnode_async.h"
+#include "xnode_interfaces.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xsdk::impl {
+
+// Dispatcher of async callbacks (notifications of applied changes called w/o node lock).
+// Each thread drains own bounded MPSC queue (cells with sequence numbers, writers reserve cell by CAS of tail),
+// subscriber is bound to one queue - so its notifications are called in order of posting.
+// Thread sleeps on empty queue, writers wake it up only if it is sleeping.
+// The dispatcher is never destroyed (nodes could be changed by static objects destructors), threads are stopped
+// on exit and later notifications are dropped.
+class XAsyncDispatcher {
+public:
+    struct Subscriber {
+        Subscriber(INode::OnChangePF&& _pf, size_t _queue_idx) : pf(std::move(_pf)), queue_idx(_queue_idx) {}
+
+        const INode::OnChangePF pf;
+        const size_t            queue_idx;
+        std::atomic_bool        expired = false; // Removed or callback returned std::nullopt
+    };
+
+    struct Event {
+        std::shared_ptr<Subscriber> subscriber_p;
+        INode::SPtrC                node_p;
+        XKey                        key;
+        XValueRT                    from;
+        XValueRT                    to;
+        INode::CallbackReason       reason    = INode::CallbackReason::ChangesNoDiscard;
+        int64_t                     posted_ns = 0;
+    };
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence = 0;
+        Event               event;
+    };
+
+    struct Queue {
+        explicit Queue(size_t _size);
+
+        bool Push(Event&& _event);
+        bool Pop(Event& _event);
+        bool Empty() const;
+
+        const size_t                  mask;
+        const std::unique_ptr<Cell[]> cells_p;
+
+        alignas(64) std::atomic<size_t> tail = 0; // Writers
+        alignas(64) size_t head = 0;              // Reader only
+
+        std::mutex              wake_mutex;
+        std::condition_variable wake_cv;
+        std::atomic_bool        sleeping = false;
+
+        // Metrics
+        std::atomic<uint64_t> enqueued    = 0;
+        std::atomic<uint64_t> delivered   = 0;
+        std::atomic<uint64_t> dropped     = 0;
+        std::atomic<uint64_t> blocked     = 0;
+        std::atomic<size_t>   depth_max   = 0;
+        std::atomic<uint64_t> latency_sum = 0;
+        std::atomic<int64_t>  latency_max = 0;
+    };
+
+public:
+    static XAsyncDispatcher& Get();
+
+    bool                Configure(const xnode::AsyncOptions& _options);
+    xnode::AsyncMetrics Metrics() const;
+    void                Flush();
+
+    // Make subscriber (starts threads on first call)
+    std::shared_ptr<Subscriber> SubscriberMake(INode::OnChangePF&& _pf);
+    // Post notification to queue of subscriber (called w/o nodes locks, when the writer thread released all
+    // write locks, so waiting for queue space could not block async callbacks reading the changed nodes)
+    void                        Post(Event&& _event);
+
+private:
+    XAsyncDispatcher() = default;
+
+    void Start_();
+    void Stop_();
+    void Run_(Queue* _queue_p);
+
+    static int64_t NowNs_();
+
+    std::mutex                          start_mutex_;
+    xnode::AsyncOptions                 options_; // Immutable after start
+    std::atomic_bool                    started_          = false;
+    std::atomic_bool                    stopped_          = false;
+    std::atomic<size_t>                 subscribers_next_ = 0;
+    std::vector<std::unique_ptr<Queue>> queues_; // Immutable after start
+    std::vector<std::thread>            threads_;
+};
+
+} // namespace xsdk::impl
@@ -7,48 +7,62 @@ XKey XContainerMatchBase::NodeKey_(const IContainer::KeyType& _key)
     return std::visit([](const auto& _elem) -> auto { return XKey(_elem); }, _key);
 }
 
-IContainer::KeyType XContainerMatchBase::ContainerKey_(const XKey& _key)
+IContainer::KeyType XContainerMatchBase::ContainerKey_(const XKey& _key, bool _intern)
 {
-    return std::visit(
-        [](const auto& elem) -> auto {
-            // expicit conversion for std::string_view -> string
-            if constexpr (std::is_same_v<std::decay_t<decltype(elem)>, std::string_view>)
-                return IContainer::KeyType(std::string(elem));
-            else
-                return IContainer::KeyType(elem);
-        },
-        _key);
+    switch (_key.Type()) {
+        case XKey::KeyType::Index:
+            return _key.IndexGet().value();
+        case XKey::KeyType::String: {
+            // Key from interned string -> no allocation and no interning table lookup
+            const auto& atom = _key.AtomGet();
+            if (!atom.empty())
+                return _intern ? atom : xnode::StringAtom::Borrow(atom);
+
+            // Lookups borrow interned string (w/o reference counting), not interned string is not stored in
+            // any container
+            auto str = _key.StringGet().value();
+            return _intern ? xnode::StringAtom(str) : xnode::StringAtom::Borrow(str);
+        }
+        default:
+            return {};
+    }
 }
 
-IContainer::KeyType XContainerMatchMap::ContainerKey(const XKey& _key, bool _sequntial_index) const
+std::optional<IContainer::KeyType> XContainerMatchMap::IndexKey_(const XKey& _key, bool _sequntial_index) const
 {
-    auto* container_p = ContainerGet();
-    assert(container_p);
     // Check for map access by index
     // (index key, index access enabled, container is not indexed by nature)
-    if (_sequntial_index && _key.Type() == XKey::KeyType::Index) {
+    if (!_sequntial_index || _key.Type() != XKey::KeyType::Index)
+        return std::nullopt;
 
-        size_t index = _key.IndexGet().value();
-        if (index == kIdxLast && !container_p->Empty())
-            index = container_p->Size() - 1;
-        else if (index >= container_p->Size())
-            return {};
+    const auto* container_p = ContainerGet();
+    assert(container_p);
 
-        IContainer::KeyType key_res = {};
-        container_p->ForEach([&index, &key_res](const IContainer::KeyType& key, const IContainer::MappedType&) {
-            if (index == 0) {
-                key_res = key;
-                return true;
-            }
+    size_t index = _key.IndexGet().value();
+    if (index == kIdxLast && !container_p->Empty())
+        index = container_p->Size() - 1;
+    else if (index >= container_p->Size())
+        return IContainer::KeyType();
 
-            --index;
-            return false;
-        });
+    return container_p->KeyAt(index).value_or(IContainer::KeyType());
+}
 
-        return key_res;
-    }
+IContainer::KeyType XContainerMatchMap::ContainerKey(const XKey& _key, bool _sequntial_index) const
+{
+    auto index_key = IndexKey_(_key, _sequntial_index);
+    if (index_key.has_value())
+        return std::move(index_key.value());
 
     return XContainerMatchBase::ContainerKey(_key, _sequntial_index);
 }
 
+IContainer::KeyType XContainerMatchMap::ContainerKeyFind(const XKey& _key, bool _sequntial_index) const
+{
+    auto index_key = IndexKey_(_key, _sequntial_index);
+    if (index_key.has_value())
+        return std::move(index_key.value());
+
+    return XContainerMatchBase::ContainerKeyFind(_key, _sequntial_index);
+}
+
 } // namespace xsdk::impl
\ No newline at end of file
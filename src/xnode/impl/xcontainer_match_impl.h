@@ -21,7 +21,12 @@ public:
 public:
     virtual IContainer::KeyType ContainerKey(const XKey& _key, bool _sequntial_index) const override
     {
-        return ContainerKey_(_key);
+        return ContainerKey_(_key, true);
+    }
+
+    virtual IContainer::KeyType ContainerKeyFind(const XKey& _key, bool _sequntial_index) const override
+    {
+        return ContainerKey_(_key, false);
     }
 
     virtual XKey NodeKey(const IContainer::KeyType& _key) const override { return NodeKey_(_key); }
@@ -33,7 +38,7 @@ public:
 private:
     static XKey NodeKey_(const IContainer::KeyType& _key);
 
-    static IContainer::KeyType ContainerKey_(const XKey& _key);
+    static IContainer::KeyType ContainerKey_(const XKey& _key, bool _intern);
 };
 
 // Map mathching
@@ -43,6 +48,12 @@ public:
 
 public:
     virtual IContainer::KeyType ContainerKey(const XKey& _key, bool _sequntial_index) const override;
+
+    virtual IContainer::KeyType ContainerKeyFind(const XKey& _key, bool _sequntial_index) const override;
+
+private:
+    // Return key for map access by index or nullopt if not index access
+    std::optional<IContainer::KeyType> IndexKey_(const XKey& _key, bool _sequntial_index) const;
 };
 
 // Array mathching (copy of XContainerMatchBase)
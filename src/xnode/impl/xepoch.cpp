@@ -0,0 +1,103 @@
+#include "xepoch.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace xsdk::impl {
+
+XEpoch::Guard::Guard() : record_p_(ThreadRecord_())
+{
+    // Announce (seq_cst) must be ordered before the load of published object
+    if (record_p_->nesting++ == 0)
+        record_p_->epoch.store(Get_().epoch_global_.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+}
+
+XEpoch::Guard::~Guard()
+{
+    if (--record_p_->nesting == 0)
+        record_p_->epoch.store(0, std::memory_order_release);
+}
+
+/*static*/ void XEpoch::Enter()
+{
+    auto* record_p = ThreadRecord_();
+    if (record_p->nesting++ == 0)
+        record_p->epoch.store(Get_().epoch_global_.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+}
+
+/*static*/ void XEpoch::Leave()
+{
+    auto* record_p = ThreadRecord_();
+    if (--record_p->nesting == 0)
+        record_p->epoch.store(0, std::memory_order_release);
+}
+
+/*static*/ XEpoch& XEpoch::Get_()
+{
+    // Never destroyed: nodes could be released by static objects destructors
+    static auto* epoch_p = new XEpoch();
+    return *epoch_p;
+}
+
+/*static*/ XEpoch::Record* XEpoch::ThreadRecord_()
+{
+    // Record is released for reuse by other threads on thread exit
+    struct RecordHolder {
+        Record* record_p = Get_().RecordAcquire_();
+        ~RecordHolder() { record_p->used.store(false, std::memory_order_release); }
+    };
+
+    thread_local RecordHolder holder;
+    return holder.record_p;
+}
+
+XEpoch::Record* XEpoch::RecordAcquire_()
+{
+    for (auto* record_p = records_head_p_.load(std::memory_order_acquire); record_p; record_p = record_p->next_p) {
+        bool used = false;
+        if (!record_p->used.load(std::memory_order_relaxed) &&
+            record_p->used.compare_exchange_strong(used, true, std::memory_order_acquire))
+            return record_p;
+    }
+
+    // Records are never deleted (scanned w/o locks)
+    auto* record_p = new Record();
+    record_p->used.store(true, std::memory_order_relaxed);
+    record_p->next_p = records_head_p_.load(std::memory_order_relaxed);
+    while (!records_head_p_.compare_exchange_weak(record_p->next_p, record_p, std::memory_order_release))
+        ;
+
+    return record_p;
+}
+
+void XEpoch::Retire_(const void* _object_p, Deleter _deleter)
+{
+    std::vector<Retired> reclaimed;
+    {
+        std::lock_guard lock(retired_mutex_);
+
+        // Readers with announced epoch greater than retire one got the object after it was unlinked
+        auto epoch = epoch_global_.fetch_add(1, std::memory_order_seq_cst);
+        if (_object_p)
+            retired_.push_back({epoch, _object_p, _deleter});
+
+        auto epoch_min = std::numeric_limits<uint64_t>::max();
+        for (auto* record_p = records_head_p_.load(std::memory_order_acquire); record_p; record_p = record_p->next_p) {
+            auto record_epoch = record_p->epoch.load(std::memory_order_seq_cst);
+            if (record_epoch)
+                epoch_min = std::min(epoch_min, record_epoch);
+        }
+
+        auto it_keep = std::partition(retired_.begin(), retired_.end(), [&](const Retired& _retired) {
+            return _retired.epoch >= epoch_min;
+        });
+        reclaimed.assign(it_keep, retired_.end());
+        retired_.erase(it_keep, retired_.end());
+    }
+
+    // Outside of lock: deleted objects could retire others (e.g. released child nodes)
+    for (const auto& retired : reclaimed)
+        retired.deleter(retired.object_p);
+}
+
+} // namespace xsdk::impl
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace xsdk::impl {
+
+// Epoch based reclamation for lock-free readers of published (immutable) objects.
+// Reader announces global epoch in own (cache line aligned) thread record, so readers do not write shared memory.
+// Writer unlinks object, advances global epoch and retires object with previous epoch: the object is deleted
+// when all readers that could see it (announced epoch not greater than retire one) left critical section.
+class XEpoch {
+    struct alignas(64) Record {
+        std::atomic<uint64_t> epoch   = 0;       // Zero - not in critical section
+        size_t                nesting = 0;       // Owner thread only
+        std::atomic_bool      used    = false;   // Record is bound to thread
+        Record*               next_p  = nullptr; // Immutable after record publishing
+    };
+
+    using Deleter = void (*)(const void*);
+
+    struct Retired {
+        uint64_t    epoch    = 0;
+        const void* object_p = nullptr;
+        Deleter     deleter  = nullptr;
+    };
+
+public:
+    // Reader critical section, could be nested (e.g. read of other node from BulkGetAll() callback)
+    class Guard {
+    public:
+        Guard();
+        ~Guard();
+
+        Guard(const Guard&)            = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        Record* record_p_;
+    };
+
+    // Enter / leave reader critical section w/o guard object (e.g. for lifetime of borrowed string atom),
+    // should be paired by the same thread
+    static void Enter();
+    static void Leave();
+
+    // Retire object unlinked from readers, object is deleted now or on subsequent Retire() / Reclaim() calls
+    template <class T>
+    static void Retire(const T* _object_p)
+    {
+        if (_object_p)
+            Get_().Retire_(_object_p, [](const void* _p) { delete static_cast<const T*>(_p); });
+    }
+
+    // Delete retired objects not accessible by readers
+    static void Reclaim() { Get_().Retire_(nullptr, nullptr); }
+
+private:
+    static XEpoch& Get_();
+    static Record* ThreadRecord_();
+
+    Record* RecordAcquire_();
+    void    Retire_(const void* _object_p, Deleter _deleter);
+
+    std::atomic<uint64_t> epoch_global_   = 1;
+    std::atomic<Record*>  records_head_p_ = nullptr;
+
+    std::mutex           retired_mutex_;
+    std::vector<Retired> retired_;
+};
+
+} // namespace xsdk::impl
@@ -1,7 +1,16 @@
 #include "xnode_callbacks.h"
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+
 namespace xsdk::impl {
 
+XNodeCallbacks::~XNodeCallbacks()
+{
+    subtree_callbacks_total_.fetch_sub(subtree_callbacks_map_.size(), std::memory_order_relaxed);
+}
+
 uint64_t XNodeCallbacks::OnChangeAdd(INode::OnChangePF&& _pf_on_change, const uint64_t _id)
 {
     if (!_pf_on_change)
@@ -9,13 +18,76 @@ uint64_t XNodeCallbacks::OnChangeAdd(INode::OnChangePF&& _pf_on_change, const ui
 
     std::unique_lock lck(map_rw_);
 
-    auto id = _id;
-    if (id == 0 && !callbacks_map_.empty())
-        id = std::max(callbacks_map_.rbegin()->first + 1, xbase::NextUid());
-    else if (id == 0)
-        id = xbase::NextUid();
-
+    auto id = IdNext_(_id);
+    IdErase_(id);
     callbacks_map_[id] = _pf_on_change;
+    CountsUpdate_();
+    return id;
+}
+
+uint64_t XNodeCallbacks::OnChangeKeysAdd(INode::OnChangePF&& _pf_on_change,
+                                         INode::KeysFilter&& _filter,
+                                         const uint64_t      _id)
+{
+    if (!_pf_on_change || (_filter.keys.empty() && _filter.prefixes.empty()))
+        return 0;
+
+    std::unique_lock lck(map_rw_);
+
+    auto id = IdNext_(_id);
+    IdErase_(id);
+    for (const auto& key : _filter.keys)
+        keys_index_[key].push_back(id);
+    for (const auto& prefix : _filter.prefixes) {
+        prefixes_index_[prefix].push_back(id);
+        ++prefixes_lengths_[prefix.size()];
+    }
+    filtered_map_[id] = {std::move(_pf_on_change), std::move(_filter)};
+    CountsUpdate_();
+    return id;
+}
+
+uint64_t XNodeCallbacks::OnChangeBatchAdd(INode::OnChangeBatchPF&& _pf_on_batch, const uint64_t _id)
+{
+    if (!_pf_on_batch)
+        return 0;
+
+    std::unique_lock lck(map_rw_);
+
+    auto id = IdNext_(_id);
+    IdErase_(id);
+    batch_callbacks_map_[id] = std::move(_pf_on_batch);
+    CountsUpdate_();
+    return id;
+}
+
+uint64_t XNodeCallbacks::OnChangeAsyncAdd(INode::OnChangePF&& _pf_on_change, const uint64_t _id)
+{
+    if (!_pf_on_change)
+        return 0;
+
+    auto subscriber_p = XAsyncDispatcher::Get().SubscriberMake(std::move(_pf_on_change));
+
+    std::unique_lock lck(map_rw_);
+
+    auto id = IdNext_(_id);
+    IdErase_(id);
+    async_callbacks_map_[id] = std::move(subscriber_p);
+    CountsUpdate_();
+    return id;
+}
+
+uint64_t XNodeCallbacks::OnChangeSubtreeAdd(INode::OnSubtreeChangePF&& _pf_on_change, const uint64_t _id)
+{
+    if (!_pf_on_change)
+        return 0;
+
+    std::unique_lock lck(map_rw_);
+
+    auto id = IdNext_(_id);
+    IdErase_(id);
+    subtree_callbacks_map_[id] = std::move(_pf_on_change);
+    CountsUpdate_();
     return id;
 }
 
@@ -23,14 +95,31 @@ bool XNodeCallbacks::OnChangeRemove(uint64_t _id)
 {
     std::unique_lock lck(map_rw_);
 
-    return callbacks_map_.erase(_id) > 0;
+    bool removed = callbacks_map_.count(_id) + filtered_map_.count(_id) + batch_callbacks_map_.count(_id) +
+                       async_callbacks_map_.count(_id) + subtree_callbacks_map_.count(_id) >
+                   0;
+    IdErase_(_id);
+    CountsUpdate_();
+    return removed;
 }
 
 size_t XNodeCallbacks::OnChangeReset()
 {
     std::unique_lock lck(map_rw_);
 
-    return std::exchange(callbacks_map_, {}).size();
+    // Queued notifications of async callbacks are skipped
+    for (const auto& [uid, subscriber_p] : async_callbacks_map_)
+        subscriber_p->expired.store(true, std::memory_order_relaxed);
+
+    keys_index_.clear();
+    prefixes_index_.clear();
+    prefixes_lengths_.clear();
+
+    auto removed = std::exchange(callbacks_map_, {}).size() + std::exchange(filtered_map_, {}).size() +
+                   std::exchange(batch_callbacks_map_, {}).size() + std::exchange(async_callbacks_map_, {}).size() +
+                   std::exchange(subtree_callbacks_map_, {}).size();
+    CountsUpdate_();
+    return removed;
 }
 
 bool XNodeCallbacks::DoCallbacks(const INode::SPtrC& _node,
@@ -39,17 +128,88 @@ bool XNodeCallbacks::DoCallbacks(const INode::SPtrC& _node,
                                    const XValueRT&    _to,
                                    bool                _no_discard)
 {
+    if (!Has())
+        return true;
+
     std::shared_lock lck(map_rw_);
 
     std::vector<uint64_t> expired;
     uint64_t              failed_uid = 0;
-    for (const auto& [uid, callback] : callbacks_map_) {
-        assert(callback);
+    CallbacksFor_(_key, [&](uint64_t _uid, const INode::OnChangePF& _callback) {
+        assert(_callback);
+        auto res_opt = _callback(_no_discard ? INode::CallbackReason::ChangesNoDiscard : INode::CallbackReason::Changes,
+                                 _node,
+                                 _key,
+                                 _from,
+                                 _to);
+        if (!res_opt.has_value()) {
+            expired.push_back(_uid);
+        }
+        else if (!_no_discard && !res_opt.value()) {
+            failed_uid = _uid;
+            return false;
+        }
+        return true;
+    });
+
+    if (failed_uid != 0) {
+        assert(!_no_discard);
+        // Rollback changes
+        CallbacksFor_(_key, [&](uint64_t _uid, const INode::OnChangePF& _callback) {
+            if (_uid == failed_uid)
+                return false;
+
+            _callback(INode::CallbackReason::Rollback, _node, _key, _to, _from);
+            return true;
+        });
+    }
+
+    lck.unlock();
+
+    if (!expired.empty()) {
+        // Remove expired
+        std::unique_lock lck(map_rw_);
+        for (auto uid : expired) {
+            callbacks_map_.erase(uid);
+            FilteredErase_(uid);
+        }
+        CountsUpdate_();
+    }
+
+    return failed_uid ? false : true;
+}
+
+void XNodeCallbacks::DoRollback(const INode::SPtrC& _node,
+                                const XKey&         _key,
+                                const XValueRT&     _from,
+                                const XValueRT&     _to)
+{
+    if (!Has())
+        return;
+
+    std::shared_lock lck(map_rw_);
+
+    CallbacksFor_(_key, [&](uint64_t, const INode::OnChangePF& _callback) {
+        _callback(INode::CallbackReason::Rollback, _node, _key, _from, _to);
+        return true;
+    });
+}
+
+bool XNodeCallbacks::DoBatchCallbacks(const INode::SPtrC&               _node,
+                                      const std::vector<INode::Change>& _changes,
+                                      bool                              _no_discard)
+{
+    if (!HasBatch() || _changes.empty())
+        return true;
+
+    std::shared_lock lck(map_rw_);
+
+    std::vector<uint64_t> expired;
+    uint64_t              failed_uid = 0;
+    for (const auto& [uid, callback] : batch_callbacks_map_) {
         auto res_opt = callback(_no_discard ? INode::CallbackReason::ChangesNoDiscard : INode::CallbackReason::Changes,
                                 _node,
-                                _key,
-                                _from,
-                                _to);
+                                _changes);
         if (!res_opt.has_value()) {
             expired.push_back(uid);
         }
@@ -60,22 +220,236 @@ bool XNodeCallbacks::DoCallbacks(const INode::SPtrC& _node,
     }
 
     if (failed_uid != 0) {
-        assert(!_no_discard);
-        // Rollback changes
-        for (auto it = callbacks_map_.begin(); it != callbacks_map_.end() && it->first != failed_uid; ++it)
-            it->second(INode::CallbackReason::Rollback, _node, _key, _to, _from);
+        // Rollback batch for callbacks approved it
+        std::vector<INode::Change> rollback;
+        for (auto it = batch_callbacks_map_.begin(); it != batch_callbacks_map_.end() && it->first != failed_uid;
+             ++it) {
+            if (rollback.empty()) {
+                for (const auto& change : _changes)
+                    rollback.push_back({change.key, change.to, change.from});
+            }
+            it->second(INode::CallbackReason::Rollback, _node, rollback);
+        }
     }
 
     lck.unlock();
 
     if (!expired.empty()) {
-        // Remove expired
         std::unique_lock lck(map_rw_);
         for (auto uid : expired)
-            callbacks_map_.erase(uid);
+            batch_callbacks_map_.erase(uid);
+        CountsUpdate_();
     }
 
     return failed_uid ? false : true;
 }
 
-} // namespace xsdk::impl
\ No newline at end of file
+void XNodeCallbacks::DoBatchRollback(const INode::SPtrC& _node, const std::vector<INode::Change>& _changes)
+{
+    if (!HasBatch() || _changes.empty())
+        return;
+
+    std::vector<INode::Change> rollback;
+    rollback.reserve(_changes.size());
+    for (const auto& change : _changes)
+        rollback.push_back({change.key, change.to, change.from});
+
+    std::shared_lock lck(map_rw_);
+
+    for (const auto& [uid, callback] : batch_callbacks_map_)
+        callback(INode::CallbackReason::Rollback, _node, rollback);
+}
+
+void XNodeCallbacks::DoAsync(const INode::SPtrC&   _node,
+                             const XKey&           _key,
+                             const XValueRT&       _from,
+                             const XValueRT&       _to,
+                             INode::CallbackReason _reason)
+{
+    if (!HasAsync())
+        return;
+
+    std::shared_lock lck(map_rw_);
+
+    // Posted w/o callbacks lock: writer could wait for queue space while async callback removes itself
+    std::vector<uint64_t>           expired;
+    std::vector<AsyncSubscriberPtr> subscribers;
+    subscribers.reserve(async_callbacks_map_.size());
+    for (const auto& [uid, subscriber_p] : async_callbacks_map_) {
+        if (subscriber_p->expired.load(std::memory_order_relaxed))
+            expired.push_back(uid);
+        else
+            subscribers.push_back(subscriber_p);
+    }
+
+    lck.unlock();
+
+    for (auto& subscriber_p : subscribers)
+        XAsyncDispatcher::Get().Post({std::move(subscriber_p), _node, _key, _from, _to, _reason});
+
+    if (!expired.empty()) {
+        // Remove callbacks returned std::nullopt
+        std::unique_lock lck(map_rw_);
+        for (auto uid : expired)
+            async_callbacks_map_.erase(uid);
+        CountsUpdate_();
+    }
+}
+
+void XNodeCallbacks::DoSubtree(const INode::SPtrC&   _node,
+                               const XPath&          _path,
+                               const XValueRT&       _from,
+                               const XValueRT&       _to,
+                               INode::CallbackReason _reason)
+{
+    if (!HasSubtree())
+        return;
+
+    std::shared_lock lck(map_rw_);
+
+    std::vector<uint64_t> expired;
+    for (const auto& [uid, callback] : subtree_callbacks_map_) {
+        if (!callback(_reason, _node, _path, _from, _to).has_value())
+            expired.push_back(uid);
+    }
+
+    lck.unlock();
+
+    if (!expired.empty()) {
+        // Remove expired
+        std::unique_lock lck(map_rw_);
+        for (auto uid : expired)
+            subtree_callbacks_map_.erase(uid);
+        CountsUpdate_();
+    }
+}
+
+template <class TPf>
+void XNodeCallbacks::CallbacksFor_(const XKey& _key, TPf&& _pf) const
+{
+    if (filtered_map_.empty()) {
+        for (const auto& [uid, callback] : callbacks_map_) {
+            if (!_pf(uid, callback))
+                return;
+        }
+        return;
+    }
+
+    // Merge of not filtered and matched callbacks by ids
+    auto matched    = FilteredFind_(_key);
+    auto it_matched = matched.begin();
+    auto pf_matched = [&](uint64_t _uid_before) {
+        for (; it_matched != matched.end() && *it_matched < _uid_before; ++it_matched) {
+            if (!_pf(*it_matched, filtered_map_.at(*it_matched).first))
+                return false;
+        }
+        return true;
+    };
+    for (const auto& [uid, callback] : callbacks_map_) {
+        if (!pf_matched(uid) || !_pf(uid, callback))
+            return;
+    }
+    pf_matched(std::numeric_limits<uint64_t>::max());
+}
+
+std::vector<uint64_t> XNodeCallbacks::FilteredFind_(const XKey& _key) const
+{
+    std::vector<uint64_t> matched;
+    auto                  it_key = keys_index_.find(_key);
+    if (it_key != keys_index_.end())
+        matched = it_key->second;
+
+    auto key_str = _key.StringGet();
+    if (key_str) {
+        for (auto [length, count] : prefixes_lengths_) {
+            if (length > key_str->size())
+                break;
+
+            auto it_prefix = prefixes_index_.find(key_str->substr(0, length));
+            if (it_prefix != prefixes_index_.end())
+                matched.insert(matched.end(), it_prefix->second.begin(), it_prefix->second.end());
+        }
+    }
+
+    // Callback could match several keys or prefixes
+    std::sort(matched.begin(), matched.end());
+    matched.erase(std::unique(matched.begin(), matched.end()), matched.end());
+    return matched;
+}
+
+void XNodeCallbacks::FilteredErase_(uint64_t _id)
+{
+    auto it = filtered_map_.find(_id);
+    if (it == filtered_map_.end())
+        return;
+
+    auto pf_erase = [_id](auto& _index, const auto& _key) {
+        auto it_index = _index.find(_key);
+        if (it_index == _index.end())
+            return;
+
+        auto& ids = it_index->second;
+        ids.erase(std::remove(ids.begin(), ids.end(), _id), ids.end());
+        if (ids.empty())
+            _index.erase(it_index);
+    };
+
+    const auto& filter = it->second.second;
+    for (const auto& key : filter.keys)
+        pf_erase(keys_index_, key);
+    for (const auto& prefix : filter.prefixes) {
+        pf_erase(prefixes_index_, prefix);
+        if (--prefixes_lengths_[prefix.size()] == 0)
+            prefixes_lengths_.erase(prefix.size());
+    }
+    filtered_map_.erase(it);
+}
+
+uint64_t XNodeCallbacks::IdNext_(uint64_t _id) const
+{
+    if (_id != 0)
+        return _id;
+
+    // Ids are increased for keep callbacks order
+    uint64_t id_last = 0;
+    if (!callbacks_map_.empty())
+        id_last = callbacks_map_.rbegin()->first;
+    if (!filtered_map_.empty())
+        id_last = std::max(id_last, filtered_map_.rbegin()->first);
+    if (!batch_callbacks_map_.empty())
+        id_last = std::max(id_last, batch_callbacks_map_.rbegin()->first);
+    if (!async_callbacks_map_.empty())
+        id_last = std::max(id_last, async_callbacks_map_.rbegin()->first);
+    if (!subtree_callbacks_map_.empty())
+        id_last = std::max(id_last, subtree_callbacks_map_.rbegin()->first);
+
+    return std::max(id_last + 1, xbase::NextUid());
+}
+
+void XNodeCallbacks::IdErase_(uint64_t _id)
+{
+    callbacks_map_.erase(_id);
+    FilteredErase_(_id);
+    batch_callbacks_map_.erase(_id);
+    subtree_callbacks_map_.erase(_id);
+
+    auto it = async_callbacks_map_.find(_id);
+    if (it != async_callbacks_map_.end()) {
+        it->second->expired.store(true, std::memory_order_relaxed);
+        async_callbacks_map_.erase(it);
+    }
+}
+
+void XNodeCallbacks::CountsUpdate_()
+{
+    callbacks_count_.store(callbacks_map_.size() + filtered_map_.size(), std::memory_order_relaxed);
+    batch_callbacks_count_.store(batch_callbacks_map_.size(), std::memory_order_relaxed);
+    async_callbacks_count_.store(async_callbacks_map_.size(), std::memory_order_relaxed);
+
+    // Total is changed by difference with previous count of node
+    auto subtree_count = subtree_callbacks_map_.size();
+    auto subtree_prev  = subtree_callbacks_count_.exchange(subtree_count, std::memory_order_relaxed);
+    subtree_callbacks_total_.fetch_add(subtree_count - subtree_prev, std::memory_order_relaxed);
+}
+
+} // namespace xsdk::impl
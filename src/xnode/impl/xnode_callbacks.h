@@ -1,29 +1,104 @@
 #pragma once
 
+#include "xasync_dispatcher.h"
 #include "xnode_interfaces.h"
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <mutex>
 #include <shared_mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace xsdk::impl {
 
 class XNodeCallbacks {
-    std::shared_mutex                     map_rw_;
-    std::map<uint64_t, INode::OnChangePF> callbacks_map_;
+    std::shared_mutex                          map_rw_;
+    std::map<uint64_t, INode::OnChangePF>      callbacks_map_;
+    std::map<uint64_t, INode::OnChangeBatchPF> batch_callbacks_map_;
+
+    using AsyncSubscriberPtr = std::shared_ptr<XAsyncDispatcher::Subscriber>;
+    std::map<uint64_t, AsyncSubscriberPtr> async_callbacks_map_;
+
+    // Callbacks filtered by keys, changed key is matched by index of keys and index of keys prefixes
+    struct KeyHash {
+        size_t operator()(const XKey& _key) const { return std::hash<XKeyVariant>()(_key); }
+    };
+    using FilteredCallback = std::pair<INode::OnChangePF, INode::KeysFilter>;
+    std::map<uint64_t, FilteredCallback>                      filtered_map_;
+    std::unordered_map<XKey, std::vector<uint64_t>, KeyHash>  keys_index_;
+    std::map<std::string, std::vector<uint64_t>, std::less<>> prefixes_index_;
+    std::map<size_t, size_t>                                  prefixes_lengths_; // Length -> prefixes count
+
+    std::map<uint64_t, INode::OnSubtreeChangePF> subtree_callbacks_map_;
+
+    // Callbacks counts (changed under unique lock), for skip of callbacks calls w/o lock
+    std::atomic<size_t> callbacks_count_         = 0;
+    std::atomic<size_t> batch_callbacks_count_   = 0;
+    std::atomic<size_t> async_callbacks_count_   = 0;
+    std::atomic<size_t> subtree_callbacks_count_ = 0;
+
+    // Subtree callbacks of all nodes, for skip of ancestors walk if none
+    inline static std::atomic<size_t> subtree_callbacks_total_ = 0;
 
 public:
+    XNodeCallbacks() = default;
+    ~XNodeCallbacks();
+
     uint64_t OnChangeAdd(INode::OnChangePF&& _pf_on_change, const uint64_t _id = 0);
+    uint64_t OnChangeKeysAdd(INode::OnChangePF&& _pf_on_change, INode::KeysFilter&& _filter, const uint64_t _id = 0);
+    uint64_t OnChangeBatchAdd(INode::OnChangeBatchPF&& _pf_on_batch, const uint64_t _id = 0);
+    uint64_t OnChangeAsyncAdd(INode::OnChangePF&& _pf_on_change, const uint64_t _id = 0);
+    uint64_t OnChangeSubtreeAdd(INode::OnSubtreeChangePF&& _pf_on_change, const uint64_t _id = 0);
     bool     OnChangeRemove(uint64_t _id);
     size_t   OnChangeReset();
 
+    bool Has() const { return callbacks_count_.load(std::memory_order_relaxed) > 0; }
     bool DoCallbacks(const INode::SPtrC& _node,
                       const XKey&         _key,
                       const XValueRT&    _from,
                       const XValueRT&    _to,
                       bool                _no_discard);
+
+    // Notify about reverted change (already approved by DoCallbacks())
+    void DoRollback(const INode::SPtrC& _node, const XKey& _key, const XValueRT& _from, const XValueRT& _to);
+
+    // Batch callbacks: the batch is approved or vetoed as a whole
+    bool HasBatch() const { return batch_callbacks_count_.load(std::memory_order_relaxed) > 0; }
+    bool DoBatchCallbacks(const INode::SPtrC& _node, const std::vector<INode::Change>& _changes, bool _no_discard);
+    // Notify about approved changes not applied (e.g. vetoed by other callbacks), passed as from/to of rollback
+    void DoBatchRollback(const INode::SPtrC& _node, const std::vector<INode::Change>& _changes);
+
+    // Async callbacks: applied (or reverted) changes are posted to dispatcher after unlock of node (@see
+    // XNode::Unlocked_()), called by dispatcher thread w/o node lock
+    bool HasAsync() const { return async_callbacks_count_.load(std::memory_order_relaxed) > 0; }
+    void DoAsync(const INode::SPtrC&   _node,
+                 const XKey&           _key,
+                 const XValueRT&       _from,
+                 const XValueRT&       _to,
+                 INode::CallbackReason _reason);
+
+    // Subtree callbacks: changes of node and descendants with path relative to node, called w/o nodes locks
+    static bool HasSubtreeAny() { return subtree_callbacks_total_.load(std::memory_order_relaxed) > 0; }
+    bool        HasSubtree() const { return subtree_callbacks_count_.load(std::memory_order_relaxed) > 0; }
+    void        DoSubtree(const INode::SPtrC&   _node,
+                          const XPath&          _path,
+                          const XValueRT&       _from,
+                          const XValueRT&       _to,
+                          INode::CallbackReason _reason);
+
+private:
+    // Call (under shared lock) not filtered and matched by key callbacks in ids order, while _pf returns true
+    template <class TPf>
+    void                  CallbacksFor_(const XKey& _key, TPf&& _pf) const;
+    std::vector<uint64_t> FilteredFind_(const XKey& _key) const;
+    void                  FilteredErase_(uint64_t _id);
+
+    uint64_t IdNext_(uint64_t _id) const;
+    void     IdErase_(uint64_t _id);
+    void     CountsUpdate_();
 };
 
-} // namespace xsdk::impl
\ No newline at end of file
+} // namespace xsdk::impl
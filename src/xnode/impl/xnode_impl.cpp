@@ -1,23 +1,55 @@
 #include "xnode_impl.h"
+#include "xepoch.h"
 
+#include <algorithm>
 #include <deque>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <variant>
 #include <vector>
 
 namespace xsdk::impl {
 
+namespace {
+
+// Move not processed item to the kept (front) part of bulk vector: processed items are removed
+// at once after loop, instead of O(n) erase for each item
+template <class TIterator>
+void BulkKeep(TIterator& _it_keep, TIterator _it)
+{
+    if (_it_keep != _it)
+        *_it_keep = std::move(*_it);
+    ++_it_keep;
+}
+
+// Index of array item (as resolved by array container), kIdxEnd - not an item
+size_t ArrayIndex(const IContainer::KeyType& _key, size_t _size)
+{
+    const auto* idx_p = std::get_if<size_t>(&_key);
+    if (!idx_p)
+        return kIdxEnd;
+
+    return *idx_p == kIdxLast ? (_size > 1 ? _size - 1 : 0) : *idx_p;
+}
+
+} // namespace
+
 XNode::XNode(std::unique_ptr<IContainerMatch>&&  _container_match,
              std::unique_ptr<IParentValidator>&& _parent_validator,
              uint64_t                            _uid,
-             std::string_view                    _name)
+             std::string_view                    _name,
+             bool                                _read_snapshots,
+             bool                                _scalar_slots)
     : object_uid_(_uid),
       container_match_p_(std::move(_container_match)),
-      parent_validator_p_(std::move(_parent_validator))
+      parent_validator_p_(std::move(_parent_validator)),
+      values_timed_(ContainerGet_()->ValuesTimed()),
+      read_snapshots_(_read_snapshots),
+      scalar_slots_p_(_scalar_slots && Type() == NodeType::Map ? std::make_unique<XScalarSlots>() : nullptr)
 {
     assert(parent_validator_p_.get());
     assert(container_match_p_.get());
@@ -25,11 +57,24 @@ XNode::XNode(std::unique_ptr<IContainerMatch>&&  _container_match,
     if (!_name.empty())
         name_p_ = std::make_unique<std::string>(_name);
 
+    if (read_snapshots_)
+        snapshot_p_ = new XNodeSnapshot({}, 0, Type() == NodeType::Map);
+
 #ifdef _DEBUG
     nodes_counter_.fetch_add(1);
 #endif
 }
 
+XNode::~XNode()
+{
+    // No readers: each reader holds node pointer
+    delete snapshot_p_.load(std::memory_order_relaxed);
+
+#ifdef _DEBUG
+    nodes_counter_.fetch_sub(1);
+#endif
+}
+
 //-------------------------------------------------------------------------------
 // IObject override
 
@@ -165,13 +210,13 @@ bool XNode::KeyChange(const XKey& _from, const XKey& _to)
     if (!_from || !_to || _from.Type() != _to.Type())
         return false;
 
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
     auto key_to = ContainerKey_(_to, false);
     if (ContainerGet_()->At(key_to).has_value())
         return false;
 
-    auto moved_val = ContainerGet_()->Erase(ContainerKey_(_from, true), OnChangePF_());
+    auto moved_val = ContainerGet_()->Erase(ContainerKeyFind_(_from, true), OnChangePF_());
     if (!moved_val.has_value())
         return false;
 
@@ -196,23 +241,45 @@ uint64_t XNode::OnChangeAdd(OnChangePF&& _pf_on_change, uint64_t _id /*= 0*/) co
 {
     return node_callbacks_.OnChangeAdd(std::move(_pf_on_change), _id);
 }
+uint64_t XNode::OnChangeKeysAdd(OnChangePF&& _pf_on_change, KeysFilter _filter, uint64_t _id /*= 0*/) const
+{
+    return node_callbacks_.OnChangeKeysAdd(std::move(_pf_on_change), std::move(_filter), _id);
+}
+uint64_t XNode::OnChangeBatchAdd(OnChangeBatchPF&& _pf_on_batch, uint64_t _id /*= 0*/) const
+{
+    return node_callbacks_.OnChangeBatchAdd(std::move(_pf_on_batch), _id);
+}
+uint64_t XNode::OnChangeAsyncAdd(OnChangePF&& _pf_on_change, uint64_t _id /*= 0*/) const
+{
+    return node_callbacks_.OnChangeAsyncAdd(std::move(_pf_on_change), _id);
+}
+uint64_t XNode::OnChangeSubtreeAdd(OnSubtreeChangePF&& _pf_on_change, uint64_t _id /*= 0*/) const
+{
+    return node_callbacks_.OnChangeSubtreeAdd(std::move(_pf_on_change), _id);
+}
 bool   XNode::OnChangeRemove(uint64_t _id) const { return node_callbacks_.OnChangeRemove(_id); }
 size_t XNode::OnChangeReset() const { return node_callbacks_.OnChangeReset(); }
 
 //-------------------------------------------------------------------------------
 bool XNode::IsKeyValid(bool _map_access_by_index, const XKey& _key) const
 {
+    // String key is checked by type (w/o interning table lookup): any not empty string is valid key for map
+    if (_key.Type() == XKey::KeyType::String && _key.AtomGet().empty()) {
+        auto str = _key.StringGet();
+        return ContainerGet_()->Type() == IContainer::ContainerType::Map && str && !str->empty();
+    }
+
     if (_map_access_by_index) {
         std::shared_lock lck(container_rw_);
-        return ContainerGet_()->IsKeyValid(ContainerKey_(_key, true));
+        return ContainerGet_()->IsKeyValid(ContainerKeyFind_(_key, true));
     }
 
-    return ContainerGet_()->IsKeyValid(ContainerKey_(_key, false));
+    return ContainerGet_()->IsKeyValid(ContainerKeyFind_(_key, false));
 }
 
 void XNode::Clear()
 {
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
     std::vector<INode::SPtr> vec_removed_nodes;
 
@@ -225,6 +292,9 @@ void XNode::Clear()
     });
 
     ContainerGet_()->Clear();
+    GenerationNext_();
+    if (scalar_slots_p_)
+        scalar_slots_p_->Reset();
 
     lck.unlock();
 
@@ -232,17 +302,45 @@ void XNode::Clear()
         node_remove_p->ParentDetach();
 }
 
-size_t   XNode::Size() const { return ContainerGet_()->Size(); }
-bool     XNode::Empty() const { return ContainerGet_()->Empty(); }
+size_t XNode::Size() const
+{
+    if (read_snapshots_) {
+        XEpoch::Guard guard;
+        return SnapshotGet_()->Size();
+    }
+
+    return ContainerGet_()->Size();
+}
+bool     XNode::Empty() const { return read_snapshots_ ? Size() == 0 : ContainerGet_()->Empty(); }
+uint64_t XNode::Generation() const { return generation_.load(std::memory_order_acquire); }
 XValueRT XNode::At(const XKey& _key) const
 {
     return MakeConst_(const_cast<XNode*>(this)->At(_key));
 }
 XValueRT XNode::At(const XKey& _key)
 {
+    if (read_snapshots_) {
+        XEpoch::Guard guard;
+        const auto*   snapshot_p = SnapshotGet_();
+        auto          pos        = snapshot_p->Find(_key);
+        return pos < snapshot_p->Items().size() ? snapshot_p->Items()[pos].second : XValueRT();
+    }
+
     std::shared_lock lck(container_rw_);
 
-    return ContainerGet_()->At(ContainerKey_(_key, true)).value_or(XValueRT());
+    return ContainerGet_()->At(ContainerKeyFind_(_key, true)).value_or(XValueRT());
+}
+
+XValueRT XNode::AtScalar(const XKey& _key) const
+{
+    if (scalar_slots_p_ && _key.Type() == XKey::KeyType::String) {
+        // Not interned string could not be a key of any item
+        const auto& atom = _key.AtomGet();
+        return scalar_slots_p_->Get(atom.empty() ? xnode::StringAtom::Borrow(_key.StringGet().value()) : atom);
+    }
+
+    auto val = At(_key);
+    return XScalarSlots::IsScalar(val) ? val : XValueRT();
 }
 
 bool XNode::ForPatch(std::function<bool(const XKey&, const XValueRT&)>&& _pf_on_item,
@@ -259,7 +357,47 @@ bool XNode::ForPatch(std::function<bool(const XKey&, const XValueRT&)>&& _pf_on_
 
     return ContainerGet_()->ForPatch(
         std::move(pf_on_item),
-        _from_key ? std::optional<IContainer::KeyType>(ContainerKey_(_from_key, true)) : std::nullopt);
+        _from_key ? std::optional<IContainer::KeyType>(ContainerKeyFind_(_from_key, true)) : std::nullopt);
+}
+
+bool XNode::Visit(std::function<bool(const XKey&, const XValueRT&)>&& _pf_on_item,
+                  const XKey&                                         _from_key /*= XKey()*/) const
+{
+    assert(_pf_on_item);
+    if (read_snapshots_) {
+        XEpoch::Guard guard;
+        const auto*   snapshot_p = SnapshotGet_();
+        const auto&   items      = snapshot_p->Items();
+        auto          pos        = _from_key ? snapshot_p->Find(_from_key) : 0;
+        if (pos >= snapshot_p->Size())
+            return false;
+
+        for (; pos < snapshot_p->Size(); ++pos) {
+            if (_pf_on_item(NodeKey_(items[pos].first), items[pos].second))
+                break;
+        }
+        return true;
+    }
+
+    std::shared_lock lck(container_rw_);
+
+    return ContainerGet_()->ForEach(
+        [&](const IContainer::KeyType& _key, const IContainer::MappedType& _val) {
+            return _pf_on_item(NodeKey_(_key), _val);
+        },
+        _from_key ? std::optional<IContainer::KeyType>(ContainerKeyFind_(_from_key, true)) : std::nullopt);
+}
+
+size_t XNode::ErasedCompact(double _keep_msec /*= 0*/)
+{
+    WriteLock lck(this);
+
+    // Erased items affect access by index
+    auto removed = ContainerGet_()->ErasedCompact(_keep_msec);
+    if (removed)
+        GenerationNext_();
+
+    return removed;
 }
 
 // Method for take, Erase, change items via callback
@@ -297,11 +435,11 @@ bool XNode::ForEach(std::function<OnEachRes(const XKey&, XValueRT&)>&& _pf_on_it
         };
     }
 
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
     auto result = ContainerGet_()->ForEach(
         std::move(pf_on_item),
-        _from_key ? std::optional<IContainer::KeyType>(ContainerKey_(_from_key, true)) : std::nullopt,
+        _from_key ? std::optional<IContainer::KeyType>(ContainerKeyFind_(_from_key, true)) : std::nullopt,
         OnChangePF_());
 
     // Remove duplicated nodes for array
@@ -325,10 +463,10 @@ std::pair<bool, XValueRT> XNode::Set(const XKey& _key, XValue&& _val)
     if (!is_valid)
         return {false, {}};
 
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
     auto key_set             = ContainerKey_(_key, true);
-    auto [success, replaced] = ContainerGet_()->Set(key_set, std::move(_val), OnChangePF_());
+    auto [success, replaced] = ContainerGet_()->Set(key_set, ValueRT_(std::move(_val)), OnChangePF_());
     if (!success)
         return {false, replaced};
 
@@ -356,7 +494,7 @@ INode::InsertRes XNode::Insert(const XKey& _key, XValue&& _val)
     if (!is_valid)
         return {false, {}};
 
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
     if (child_node) {
         auto [key_existed, val_existed] = parent_validator_p_->FindDuplicates(ContainerGet_(), child_node);
@@ -365,7 +503,7 @@ INode::InsertRes XNode::Insert(const XKey& _key, XValue&& _val)
     }
 
     auto [success, key, existed] = ContainerGet_()->Emplace(ContainerKey_(_key, false),
-                                                           XValueRT(std::move(_val)),
+                                                           ValueRT_(std::move(_val)),
                                                            OnChangePF_());
     if (!success)
         return {success, NodeKey_(key), existed};
@@ -382,9 +520,9 @@ INode::InsertRes XNode::Insert(const XKey& _key, XValue&& _val)
 
 XValueRT XNode::Erase(const XKey& _key)
 {
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
-    auto erased_val = ContainerGet_()->Erase(ContainerKey_(_key, true), OnChangePF_()).value_or(XValueRT());
+    auto erased_val = ContainerGet_()->Erase(ContainerKeyFind_(_key, true), OnChangePF_()).value_or(XValueRT());
 
     lck.unlock();
 
@@ -397,7 +535,7 @@ XValueRT XNode::Erase(const XKey& _key)
 
 XValueRT XNode::Append(const XKey& _key, std::string_view _append_str)
 {
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
     XValue appended;
     if (ContainerGet_()->ForEach(
@@ -419,7 +557,7 @@ XValueRT XNode::Append(const XKey& _key, std::string_view _append_str)
 
 XValueRT XNode::Increment(const XKey& _key, const XValue& _increment_val)
 {
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
     XValue appended;
     if (ContainerGet_()->ForEach(
@@ -440,7 +578,7 @@ XValueRT XNode::Increment(const XKey& _key, const XValue& _increment_val)
     }
 
     auto [success, key_res, val] = ContainerGet_()->Emplace(ContainerKey_(_key, false),
-                                                           XValueRT(_increment_val),
+                                                           ValueRT_(_increment_val),
                                                            OnChangePF_());
     assert(success);
     return success ? val : XValueRT();
@@ -448,7 +586,7 @@ XValueRT XNode::Increment(const XKey& _key, const XValue& _increment_val)
 
 std::pair<bool, XValueRT> XNode::CompareExchange(const XKey& _key, const XValue& _expected, XValue&& _exchange_to)
 {
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
     auto node_set_p = _exchange_to.QueryPtr<INode>();
 
@@ -522,21 +660,41 @@ size_t XNode::BulkSet(std::vector<std::pair<XKey, XValue>>&& _values)
             invalid_childs.emplace(val);
     }
 
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
+
+    // All values are approved by batch callbacks before changes (container keys are resolved once)
+    ChangesBatch                     batch(this);
+    std::vector<IContainer::KeyType> batch_keys;
+    if (batch.Enabled()) {
+        batch_keys.reserve(_values.size());
+        for (const auto& [key, val] : _values) {
+            if (invalid_childs.count(val))
+                continue;
+
+            batch_keys.push_back(ContainerKey_(key, true));
+            batch.Add(key, ContainerGet_()->At(batch_keys.back()).value_or(XValueRT()), ValueRT_(val));
+        }
+        if (!batch.Approve())
+            return 0;
+    }
+
+    ContainerGet_()->Reserve(ContainerGet_()->Size() + _values.size());
 
     std::vector<INode::SPtr>                   vec_replaced_nodes;
     std::map<INode::SPtr, IContainer::KeyType> map_set_nodes;
 
     size_t succeeded = 0;
-    auto   it        = _values.begin();
-    while (it != _values.end()) {
+    size_t batch_pos = 0;
+    auto   it_keep   = _values.begin();
+    for (auto it = _values.begin(); it != _values.end(); ++it) {
         // Check what child is valid (not cicled)
         if (invalid_childs.count(it->second)) {
-            ++it;
+            BulkKeep(it_keep, it);
             continue;
         }
 
-        auto node_set_p = it->second.QueryPtr<INode>();
+        auto pos_in_batch = batch_pos++;
+        auto node_set_p   = it->second.QueryPtr<INode>();
         if (node_set_p) {
             // Check duplicates in already set nodes
             auto it_dup = map_set_nodes.find(node_set_p);
@@ -547,16 +705,20 @@ size_t XNode::BulkSet(std::vector<std::pair<XKey, XValue>>&& _values)
                 }
                 else {
                     // Skip this node as can't remove previously setted
-                    ++it;
+                    batch.Failed(pos_in_batch);
+                    BulkKeep(it_keep, it);
+                    continue;
                 }
             }
         }
 
         // Do not call std::move(it->second) - for keep value in case of failed set
-        auto key                 = ContainerKey_(it->first, true);
-        auto [success, replaced] = ContainerGet_()->Set(key, it->second, OnChangePF_());
+        auto key                 = batch.Enabled() ? batch_keys[pos_in_batch] : ContainerKey_(it->first, true);
+        auto val                 = batch.Enabled() ? batch.To(pos_in_batch) : ValueRT_(it->second);
+        auto [success, replaced] = ContainerGet_()->Set(key, std::move(val), OnChangePF_(false, batch.Enabled()));
         if (!success) {
-            ++it;
+            batch.Failed(pos_in_batch);
+            BulkKeep(it_keep, it);
             continue;
         }
 
@@ -567,9 +729,10 @@ size_t XNode::BulkSet(std::vector<std::pair<XKey, XValue>>&& _values)
         if (node_set_p)
             map_set_nodes.emplace(std::move(node_set_p), std::move(key));
 
-        it = _values.erase(it);
         ++succeeded;
     }
+    _values.erase(it_keep, _values.end());
+    batch.Rollback();
 
     // Remove duplicated nodes for array
     for (const auto& [node_set_p, key] : map_set_nodes)
@@ -595,24 +758,45 @@ size_t XNode::BulkInsert(std::vector<std::pair<XKey, XValue>>&& _values)
             invalid_childs.emplace(val);
     }
 
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
+
+    // All values are approved by batch callbacks before changes (existed keys are not changed)
+    ChangesBatch                     batch(this);
+    std::vector<IContainer::KeyType> batch_keys;
+    if (batch.Enabled()) {
+        batch_keys.reserve(_values.size());
+        for (const auto& [key, val] : _values) {
+            if (invalid_childs.count(val))
+                continue;
+
+            batch_keys.push_back(ContainerKey_(key, false));
+            batch.Add(key, ContainerGet_()->At(batch_keys.back()).value_or(XValueRT()), ValueRT_(val));
+        }
+        if (!batch.Approve())
+            return 0;
+    }
+
+    ContainerGet_()->Reserve(ContainerGet_()->Size() + _values.size());
 
     std::map<INode::SPtr, IContainer::KeyType> map_inserted_nodes;
 
     size_t succeeded = 0;
-    auto   it        = _values.begin();
-    while (it != _values.end()) {
+    size_t batch_pos = 0;
+    auto   it_keep   = _values.begin();
+    for (auto it = _values.begin(); it != _values.end(); ++it) {
         // Check what child is valid (not cicled)
         if (invalid_childs.count(it->second)) {
-            ++it;
+            BulkKeep(it_keep, it);
             continue;
         }
 
+        auto pos_in_batch  = batch_pos++;
         auto node_insert_p = it->second.QueryPtr<INode>();
         if (node_insert_p) {
             // Check duplicates in already inserted nodes
             if (map_inserted_nodes.count(node_insert_p)) {
-                ++it;
+                batch.Failed(pos_in_batch);
+                BulkKeep(it_keep, it);
                 continue;
             }
 
@@ -620,26 +804,31 @@ size_t XNode::BulkInsert(std::vector<std::pair<XKey, XValue>>&& _values)
             auto [key_dup, duplicated] = parent_validator_p_->FindDuplicates(ContainerGet_(), node_insert_p);
             if (!duplicated.IsEmpty()) {
                 it->first = NodeKey_(key_dup);
-                ++it;
+                batch.Failed(pos_in_batch);
+                BulkKeep(it_keep, it);
                 continue;
             }
         }
 
-        auto [success, key, existed] = ContainerGet_()->Emplace(ContainerKey_(it->first, false),
-                                                               std::move(it->second),
-                                                               OnChangePF_());
+        auto key_insert = batch.Enabled() ? batch_keys[pos_in_batch] : ContainerKey_(it->first, false);
+        auto val        = batch.Enabled() ? batch.To(pos_in_batch) : ValueRT_(std::move(it->second));
+        auto [success, key, existed] = ContainerGet_()->Emplace(std::move(key_insert),
+                                                               std::move(val),
+                                                               OnChangePF_(false, batch.Enabled()));
         if (!success) {
             it->second = existed;
-            ++it;
+            batch.Failed(pos_in_batch);
+            BulkKeep(it_keep, it);
             continue;
         }
 
         if (node_insert_p)
             map_inserted_nodes.emplace(std::move(node_insert_p), std::move(key));
 
-        it = _values.erase(it);
         ++succeeded;
     }
+    _values.erase(it_keep, _values.end());
+    batch.Rollback();
 
     lck.unlock();
 
@@ -666,34 +855,52 @@ std::pair<size_t, XKey> XNode::BulkInsert(XKey _insert_pos, std::vector<XValue>&
             invalid_childs.emplace(val);
     }
 
-    std::unique_lock lck(container_rw_);
-
-    std::vector<INode::SPtr> vec_inserted_nodes;
+    WriteLock lck(this);
 
     size_t inserted   = 0;
     size_t insert_pos = _insert_pos.IndexGet().value_or(kIdxEnd);
 
+    // All values are approved by batch callbacks before changes (as inserted in a row)
+    ChangesBatch batch(this);
+    if (batch.Enabled()) {
+        auto pos = std::min(insert_pos, ContainerGet_()->Size());
+        for (const auto& val : _values) {
+            if (!invalid_childs.count(val))
+                batch.Add(XKey(pos++), XValueRT(), ValueRT_(val));
+        }
+        if (!batch.Approve())
+            return {0, XKey()};
+    }
+
+    ContainerGet_()->Reserve(ContainerGet_()->Size() + _values.size());
+
+    std::vector<INode::SPtr> vec_inserted_nodes;
+
     IContainer::EmplaceRes EmplaceRes;
-    auto                   it = _values.begin();
-    while (it != _values.end()) {
+    size_t                 batch_pos = 0;
+    auto                   it_keep   = _values.begin();
+    for (auto it = _values.begin(); it != _values.end(); ++it) {
         // Check what child is valid (not cicled)
         if (invalid_childs.count(*it)) {
-            ++it;
+            BulkKeep(it_keep, it);
             continue;
         }
 
-        // Check duplicated nodes for array
-        auto node_insert_p         = it->QueryPtr<INode>();
-        auto [key_dup, duplicated] = parent_validator_p_->FindDuplicates(ContainerGet_(), node_insert_p);
-        if (!duplicated.IsEmpty()) {
-            ++it;
+        // Check duplicated nodes for array (not nodes values could be duplicated, e.g. nulls)
+        auto pos_in_batch  = batch_pos++;
+        auto node_insert_p = it->QueryPtr<INode>();
+        if (node_insert_p && !parent_validator_p_->FindDuplicates(ContainerGet_(), node_insert_p).second.IsEmpty()) {
+            batch.Failed(pos_in_batch);
+            BulkKeep(it_keep, it);
             continue;
         }
 
         // Do not call std::move(*it) - for keep value in case of failed emplace (e.g. cb canceled)
-        EmplaceRes = ContainerGet_()->Emplace(insert_pos, *it, OnChangePF_());
+        auto val   = batch.Enabled() ? batch.To(pos_in_batch) : ValueRT_(*it);
+        EmplaceRes = ContainerGet_()->Emplace(insert_pos, std::move(val), OnChangePF_(false, batch.Enabled()));
         if (!EmplaceRes.succeeded) {
-            ++it;
+            batch.Failed(pos_in_batch);
+            BulkKeep(it_keep, it);
             continue;
         }
 
@@ -704,8 +911,9 @@ std::pair<size_t, XKey> XNode::BulkInsert(XKey _insert_pos, std::vector<XValue>&
             ++insert_pos;
 
         ++inserted;
-        it = _values.erase(it);
     }
+    _values.erase(it_keep, _values.end());
+    batch.Rollback();
 
     lck.unlock();
 
@@ -717,17 +925,17 @@ std::pair<size_t, XKey> XNode::BulkInsert(XKey _insert_pos, std::vector<XValue>&
 
 std::vector<std::pair<XKey, XValueRT>> XNode::BulkErase(const std::vector<XKey>& _keys)
 {
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
     // Convert to container keys (for keep index)
     std::vector<std::pair<XKey, IContainer::KeyType>> keys;
     for (const auto& key : _keys)
-        keys.emplace_back(key, ContainerKey_(key, true));
+        keys.emplace_back(key, ContainerKeyFind_(key, true));
 
-    // Remove from container
+    // Remove from container (w/o callbacks)
     std::vector<std::pair<XKey, XValueRT>> extracted;
     for (const auto& [node_key, container_key] : keys) {
-        auto val_op = ContainerGet_()->Erase(container_key);
+        auto val_op = ContainerGet_()->Erase(container_key, OnChangeSilentPF_());
         if (val_op.has_value()) {
             extracted.emplace_back(node_key, val_op.value());
         }
@@ -800,11 +1008,13 @@ XKey XNode::PrivateErase(const INode::SPtr& _node_p)
 {
     assert(_node_p);
 
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
-    auto name = _node_p->NameGet();
-    if (!name.empty() && ContainerGet_()->Erase(name).has_value())
+    auto name = xnode::StringAtom(_node_p->NameGet());
+    if (!name.empty() && ContainerGet_()->Erase(name).has_value()) {
+        GenerationNext_();
         return name;
+    }
 
     XKey erased_key;
     ContainerGet_()->ForEach([&](const auto& key, auto& val) {
@@ -814,18 +1024,20 @@ XKey XNode::PrivateErase(const INode::SPtr& _node_p)
         }
         return OnEachRes::Next;
     });
+    if (erased_key)
+        GenerationNext_();
 
     return erased_key;
 }
 
 std::pair<bool, XValueRT> XNode::PrivateSet(const XKey& _key, XValue&& _val)
 {
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
     auto node_set_p = _val.QueryPtr<INode>();
 
     auto key_set             = ContainerKey_(_key, true);
-    auto [success, replaced] = ContainerGet_()->Set(key_set, std::move(_val), OnChangePF_());
+    auto [success, replaced] = ContainerGet_()->Set(key_set, ValueRT_(std::move(_val)), OnChangePF_());
     if (!success)
         return {success, replaced};
 
@@ -838,7 +1050,7 @@ INode::InsertRes XNode::PrivateInsert(const XKey& _key, XValue&& _val)
 {
     auto node_insert_p = _val.QueryPtr<INode>();
 
-    std::unique_lock lck(container_rw_);
+    WriteLock lck(this);
 
     if (node_insert_p) {
         auto [key_existed, val_existed] = parent_validator_p_->FindDuplicates(ContainerGet_(), node_insert_p);
@@ -847,11 +1059,210 @@ INode::InsertRes XNode::PrivateInsert(const XKey& _key, XValue&& _val)
     }
 
     auto [success, key, existed] = ContainerGet_()->Emplace(ContainerKey_(_key, false),
-                                                           XValueRT(std::move(_val)),
+                                                           ValueRT_(std::move(_val)),
                                                            OnChangePF_());
     return {success, NodeKey_(key), existed};
 }
 
+void XNode::PrivateLock()
+{
+    container_rw_.lock();
+    ++write_locks_;
+}
+
+void XNode::PrivateUnlock()
+{
+    // Publish snapshot on unlock
+    WriteLock lck(this, std::adopt_lock);
+}
+
+bool XNode::PrivateApply(std::vector<PrivateChange>& _changes)
+{
+    for (auto& change : _changes)
+        change.applied = false;
+
+    // Batch callbacks approve all changes of node before apply
+    bool batched = node_callbacks_.HasBatch();
+    if (batched) {
+        PrivateChangesFrom_(_changes);
+
+        std::vector<INode::Change> batch;
+        for (auto& change : _changes) {
+            if (!change.to.IsEmpty() || !change.from.IsEmpty())
+                batch.push_back({change.key, change.from, ValueRT_(change.to)});
+        }
+        if (!node_callbacks_.DoBatchCallbacks(NodeThis_(), batch, false))
+            return false;
+    }
+
+    bool is_array = Type() == NodeType::Array;
+    for (auto it = _changes.begin(); it != _changes.end(); ++it) {
+        bool ok       = true;
+        auto key_at   = it->to.IsEmpty() ? ContainerKeyFind_(it->key, true) : ContainerKey_(it->key, true);
+        it->size_from = ContainerGet_()->Size();
+        if (it->to.IsEmpty()) {
+            it->from = ContainerGet_()->At(key_at).value_or(XValueRT());
+            if (it->from.IsEmpty())
+                continue;
+
+            ok = ContainerGet_()->Erase(key_at, OnChangePF_(false, batched)).has_value();
+        }
+        else {
+            std::tie(ok, it->from) = ContainerGet_()->Set(key_at, ValueRT_(it->to), OnChangePF_(false, batched));
+        }
+
+        if (!ok) {
+            PrivateRevert(_changes);
+            return false;
+        }
+        it->key_at  = NodeKey_(is_array ? IContainer::KeyType(ArrayIndex(key_at, it->size_from)) : key_at);
+        it->applied = true;
+    }
+    return true;
+}
+
+void XNode::PrivateRevert(const std::vector<PrivateChange>& _changes)
+{
+    // Previous values (with own timestamps) are restored w/o callbacks, in reverse order: array items erased by
+    // change are inserted back at their index, array increased by change is truncated
+    bool is_array = Type() == NodeType::Array;
+    for (auto it = _changes.rbegin(); it != _changes.rend(); ++it) {
+        if (!it->applied)
+            continue;
+
+        // Previous value could be empty item of array or erased item of map (with timestamp)
+        auto key_at = ContainerKey_(it->key_at, false);
+        if (is_array && it->to.IsEmpty())
+            ContainerGet_()->Emplace(key_at, it->from, OnChangeSilentPF_());
+        else if (is_array || !it->from.IsEmpty() || !it->from.TimeIsAbsent())
+            ContainerGet_()->Set(key_at, it->from, OnChangeSilentPF_());
+        else
+            ContainerGet_()->Remove(key_at, OnChangeSilentPF_());
+
+        while (is_array && ContainerGet_()->Size() > it->size_from)
+            ContainerGet_()->Erase(IContainer::KeyType(ContainerGet_()->Size() - 1), OnChangeSilentPF_());
+
+        node_callbacks_.DoRollback(NodeThis_(), it->key, ValueRT_(it->to), it->from);
+        if (node_callbacks_.HasAsync())
+            async_changes_.push_back({CallbackReason::Rollback, it->key, ValueRT_(it->to), it->from});
+        if (XNodeCallbacks::HasSubtreeAny())
+            subtree_changes_.push_back({CallbackReason::Rollback, it->key, ValueRT_(it->to), it->from});
+    }
+
+    // Whole batch was approved
+    if (node_callbacks_.HasBatch()) {
+        std::vector<INode::Change> batch;
+        for (const auto& change : _changes) {
+            if (!change.to.IsEmpty() || !change.from.IsEmpty())
+                batch.push_back({change.key, change.from, ValueRT_(change.to)});
+        }
+        node_callbacks_.DoBatchRollback(NodeThis_(), batch);
+    }
+}
+
+void XNode::PrivateChangesFrom_(std::vector<PrivateChange>& _changes)
+{
+    if (Type() != NodeType::Array) {
+        for (auto& change : _changes)
+            change.from = ContainerGet_()->At(ContainerKeyFind_(change.key, true)).value_or(XValueRT());
+        return;
+    }
+
+    // Array changes are not applied yet: the index is mapped through previous changes (in reverse order) to the
+    // index before changes, items after increase of array (by set) are mapped beyond the array
+    auto                size = ContainerGet_()->Size();
+    std::vector<size_t> indexes; // Indexes of previous changes, kIdxEnd - not changed
+    for (auto& change : _changes) {
+        auto idx  = ArrayIndex(ContainerKeyFind_(change.key, true), size);
+        auto pos  = idx;
+        bool done = false;
+        for (auto prev = indexes.size(); prev-- > 0 && !done && pos != kIdxEnd;) {
+            if (indexes[prev] == kIdxEnd)
+                continue;
+
+            if (_changes[prev].to.IsEmpty() && pos >= indexes[prev]) {
+                ++pos;
+            }
+            else if (!_changes[prev].to.IsEmpty() && pos == indexes[prev]) {
+                change.from = ValueRT_(_changes[prev].to);
+                done        = true;
+            }
+        }
+        if (!done)
+            change.from = pos != kIdxEnd ? ContainerGet_()->At(IContainer::KeyType(pos)).value_or(XValueRT()) :
+                                           XValueRT();
+
+        bool changed = change.to.IsEmpty() ? idx < size : idx != kIdxEnd;
+        if (changed)
+            size = change.to.IsEmpty() ? size - 1 : std::max(size, idx + 1);
+        indexes.push_back(changed ? idx : kIdxEnd);
+    }
+}
+
+XKey XNode::PrivateChildKey(const INode::SPtrC& _child) const
+{
+    if (Type() == NodeType::Map)
+        return _child->NameGet();
+
+    std::shared_lock lck(container_rw_);
+
+    auto key = ContainerGet_()->ObjectKey(_child.get());
+    return key ? NodeKey_(*key) : XKey();
+}
+
+void XNode::PrivateSubtreeNotify(const INode::SPtrC&                      _node,
+                                 const XPath&                             _path,
+                                 const std::vector<PrivateSubtreeChange>& _changes) const
+{
+    if (!node_callbacks_.HasSubtree())
+        return;
+
+    XPath path(_path);
+    for (const auto& change : _changes) {
+        path.push_back(change.key);
+        node_callbacks_.DoSubtree(_node, path, change.from, change.to, change.reason);
+        path.pop_back();
+    }
+}
+
+//---------------------------------------------------------------------------------------------
+// Direct build
+
+bool XNode::BuildPut(const XKey& _key, XValue&& _val, XNode* _child_p)
+{
+    // Scalar slots are updated by change callback, other node state is published on build end
+    auto [success, key, existed] = ContainerGet_()->Emplace(ContainerKey_(_key, false),
+                                                           ValueRT_(std::move(_val)),
+                                                           scalar_slots_p_ ? OnChangeSilentPF_() : nullptr);
+    if (!success)
+        return false;
+
+    snapshot_dirty_ = true;
+    if (!_child_p)
+        return true;
+
+    // As for Insert(): map key is the name of child, child w/o name is not linked to map
+    auto name = Type() == NodeType::Map ? _key.StringGet() : std::nullopt;
+    if (name && name->empty())
+        return true;
+
+    if (name && (!_child_p->name_p_ || *_child_p->name_p_ != *name))
+        _child_p->name_p_ = std::make_unique<std::string>(*name);
+    _child_p->parent_wp_ = std::static_pointer_cast<INode>(shared_from_this());
+    return true;
+}
+
+void XNode::BuildEnd()
+{
+    if (!snapshot_dirty_)
+        return;
+
+    GenerationNext_();
+
+    // No readers of previous snapshot yet
+    delete SnapshotPublish_();
+}
+
 //---------------------------------------------------------------------------------------------
 // Private helpers
 
@@ -870,10 +1281,104 @@ INode::InsertRes XNode::PrivateInsert(const XKey& _key, XValue&& _val)
     return _val;
 }
 
-inline IContainer::OnChangePF XNode::OnChangePF_(bool _no_discard)
+// Containers w/o values timestamps take timestamp on read -> no clock call for values passed to them
+// (except empty values: those are erased items for maps with erase detection)
+inline XValueRT XNode::ValueRT_(XValue&& _val)
+{
+    if (values_timed_ || _val.IsEmpty())
+        return XValueRT(std::move(_val), Timestamp_());
+
+    return XValueRT(std::move(_val), kAbsentRT);
+}
+
+inline XValueRT XNode::ValueRT_(const XValue& _val)
+{
+    if (values_timed_ || _val.IsEmpty())
+        return XValueRT(_val, Timestamp_());
+
+    return XValueRT(_val, kAbsentRT);
+}
+
+inline int64_t XNode::Timestamp_()
+{
+    timestamp_last_ = std::max(XValueRT::ClockTimestamp(), timestamp_last_ + 1);
+    return timestamp_last_;
+}
+
+inline IContainer::OnChangePF XNode::OnChangePF_(bool _no_discard, bool _batched)
 {
     return [=](const IContainer::KeyType& _key, const IContainer::MappedType& _from, const IContainer::MappedType& _to)
-               -> auto { return node_callbacks_.DoCallbacks(NodeThis_(), NodeKey_(_key), _from, _to, _no_discard); };
+               -> auto {
+        // Single change is passed to batch callbacks if operation has no own batch
+        bool batch   = !_batched && node_callbacks_.HasBatch();
+        bool subtree = XNodeCallbacks::HasSubtreeAny();
+        if (batch || subtree || node_callbacks_.Has() || node_callbacks_.HasAsync()) {
+            auto key       = NodeKey_(_key);
+            auto node_this = NodeThis_();
+            if (!node_callbacks_.DoCallbacks(node_this, key, _from, _to, _no_discard))
+                return false;
+
+            if (batch && !node_callbacks_.DoBatchCallbacks(node_this, {{key, _from, _to}}, _no_discard)) {
+                node_callbacks_.DoRollback(node_this, key, _to, _from);
+                return false;
+            }
+
+            // Approved change is posted to async callbacks (can't veto) on unlock
+            if (node_callbacks_.HasAsync())
+                async_changes_.push_back({CallbackReason::ChangesNoDiscard, key, _from, _to});
+
+            // Passed to subtree callbacks of node and ancestors on unlock
+            if (subtree)
+                subtree_changes_.push_back({CallbackReason::ChangesNoDiscard, std::move(key), _from, _to});
+        }
+
+        Changed_(_key, _from, _to);
+        return true;
+    };
+}
+
+inline IContainer::OnChangePF XNode::OnChangeSilentPF_()
+{
+    return [this](const IContainer::KeyType&    _key,
+                  const IContainer::MappedType& _from,
+                  const IContainer::MappedType& _to) {
+        Changed_(_key, _from, _to);
+        return true;
+    };
+}
+
+void XNode::Changed_(const IContainer::KeyType& _key, const XValueRT& _from, const XValueRT& _to)
+{
+    // Called (under unique lock) just before change, values could be stamped by container (e.g. erased items)
+    snapshot_dirty_ = true;
+    if (!_to.TimeIsAbsent())
+        timestamp_last_ = std::max(timestamp_last_, _to.Timestamp());
+    ScalarSlotSet_(_key, _to);
+    if (_from.IsEmpty() != _to.IsEmpty() || _from.IsObject() || _to.IsObject())
+        GenerationNext_();
+}
+
+inline void XNode::ScalarSlotSet_(const IContainer::KeyType& _key, const XValueRT& _val)
+{
+    if (!scalar_slots_p_)
+        return;
+
+    const auto* atom_p = std::get_if<xnode::StringAtom>(&_key);
+    if (atom_p) {
+        scalar_slots_p_->Set(*atom_p, _val);
+        return;
+    }
+
+    // Map item accessed by index: called before change, so index still points to the item
+    if (std::holds_alternative<size_t>(_key)) {
+        ContainerGet_()->ForEach(
+            [&](const IContainer::KeyType& _item_key, const IContainer::MappedType&) {
+                if (const auto* item_atom_p = std::get_if<xnode::StringAtom>(&_item_key))
+                    scalar_slots_p_->Set(*item_atom_p, _val);
+                return true;
+            },
+            _key);
+    }
 }
 
 inline IContainer::KeyType XNode::ContainerKey_(const XKey& _key, bool _use_index) const
@@ -881,6 +1386,11 @@ inline IContainer::KeyType XNode::ContainerKey_(const XKey& _key, bool _use_inde
     return container_match_p_->ContainerKey(_key, _use_index);
 }
 
+inline IContainer::KeyType XNode::ContainerKeyFind_(const XKey& _key, bool _use_index) const
+{
+    return container_match_p_->ContainerKeyFind(_key, _use_index);
+}
+
 inline XKey XNode::NodeKey_(const IContainer::KeyType& _key) const { return container_match_p_->NodeKey(_key); }
 
 bool XNode::IsValidParent_(const INode::SPtrC& _node_parent) const
@@ -946,11 +1456,24 @@ bool XNode::SetAsChild_(const INode::SPtr& _node_child, std::optional<std::strin
 
 std::vector<std::pair<XKey, XValueRT>> XNode::BulkGet_(bool _read_only, const std::vector<XKey>& _keys) const
 {
+    std::vector<std::pair<XKey, XValueRT>> values;
+    if (read_snapshots_) {
+        XEpoch::Guard guard;
+        const auto*   snapshot_p = SnapshotGet_();
+        for (const auto& key : _keys) {
+            auto pos = snapshot_p->Find(key);
+            if (pos < snapshot_p->Items().size()) {
+                const auto& val = snapshot_p->Items()[pos].second;
+                values.emplace_back(key, _read_only ? MakeConst_(val) : val);
+            }
+        }
+        return values;
+    }
+
     std::shared_lock lck(container_rw_);
 
-    std::vector<std::pair<XKey, XValueRT>> values;
     for (const auto& key : _keys) {
-        auto val_op = ContainerGet_()->At(ContainerKey_(key, true));
+        auto val_op = ContainerGet_()->At(ContainerKeyFind_(key, true));
         if (val_op.has_value())
             values.emplace_back(key, _read_only ? MakeConst_(val_op.value()) : val_op.value());
     }
@@ -963,22 +1486,161 @@ std::vector<std::pair<XKey, XValueRT>> XNode::BulkGet_(
     const XKey&                                              _key_begin,
     std::function<OnCopyRes(const XKey&, const XValueRT&)>&& _pf_on_item) const
 {
+    std::vector<std::pair<XKey, XValueRT>> values;
+    auto pf_on_item = [&](const IContainer::KeyType& key, const IContainer::MappedType& value) {
+        XValueRT value_take = _read_only ? MakeConst_(value) : value;
+        auto     cb_res     = _pf_on_item ? _pf_on_item(NodeKey_(key), value_take) : OnCopyRes::Take;
+
+        if (cb_res == OnCopyRes::TakeStop || cb_res == OnCopyRes::Take)
+            values.emplace_back(NodeKey_(key), value_take);
+
+        return (cb_res == OnCopyRes::TakeStop || cb_res == OnCopyRes::Stop) ? true : false;
+    };
+
+    if (read_snapshots_) {
+        XEpoch::Guard guard;
+        const auto*   snapshot_p = SnapshotGet_();
+        const auto&   items      = snapshot_p->Items();
+        for (auto pos = _key_begin ? snapshot_p->Find(_key_begin) : 0; pos < snapshot_p->Size(); ++pos) {
+            if (pf_on_item(items[pos].first, items[pos].second))
+                break;
+        }
+        return values;
+    }
+
     std::shared_lock lck(container_rw_);
 
-    std::vector<std::pair<XKey, XValueRT>> values;
     ContainerGet_()->ForEach(
-        [&](const auto& key, const auto& value) {
-            XValueRT value_take = _read_only ? MakeConst_(value) : value;
-            auto     cb_res     = _pf_on_item ? _pf_on_item(NodeKey_(key), value_take) : OnCopyRes::Take;
+        std::move(pf_on_item),
+        _key_begin ? std::optional<IContainer::KeyType>(ContainerKeyFind_(_key_begin, true)) : std::nullopt);
+
+    return values;
+}
 
-            if (cb_res == OnCopyRes::TakeStop || cb_res == OnCopyRes::Take)
-                values.emplace_back(NodeKey_(key), value_take);
+const XNodeSnapshot* XNode::SnapshotPublish_()
+{
+    if (!read_snapshots_ || !snapshot_dirty_)
+        return nullptr;
 
-            return (cb_res == OnCopyRes::TakeStop || cb_res == OnCopyRes::Stop) ? true : false;
-        },
-        _key_begin ? std::optional<IContainer::KeyType>(ContainerKey_(_key_begin, true)) : std::nullopt);
+    snapshot_dirty_ = false;
 
-    return values;
+    std::vector<XNodeSnapshot::Item> items;
+    items.reserve(ContainerGet_()->Size());
+    ContainerGet_()->ForEach([&](const IContainer::KeyType& _key, const IContainer::MappedType& _val) {
+        items.emplace_back(_key, _val);
+        return false;
+    });
+
+    // Erased map items are visible for At() as empty values with erase timestamp
+    auto size   = items.size();
+    bool is_map = Type() == NodeType::Map;
+    if (is_map) {
+        ContainerGet_()->ForPatch(
+            [&](const IContainer::KeyType& _key, const IContainer::MappedType& _val) {
+                if (_val.IsEmpty())
+                    items.emplace_back(_key, _val);
+                return false;
+            },
+            std::nullopt);
+    }
+
+    return snapshot_p_.exchange(new XNodeSnapshot(std::move(items), size, is_map), std::memory_order_seq_cst);
+}
+
+void XNode::SubtreeNotify_(const std::vector<PrivateSubtreeChange>& _changes)
+{
+    // Walk by parents, path of changed node is prepended by key of each node in its parent
+    INode::SPtrC node_changed = NodeThis_();
+    INode::SPtrC node_p       = node_changed;
+    XPath        path;
+    for (;;) {
+        auto private_p = xobject::PtrQuery<INodePrivate>(node_p.get());
+        if (!private_p)
+            break;
+
+        private_p->PrivateSubtreeNotify(node_changed, path, _changes);
+
+        auto parent_p         = node_p->ParentGet();
+        auto parent_private_p = xobject::PtrQuery<INodePrivate>(parent_p.get());
+        auto key              = parent_private_p ? parent_private_p->PrivateChildKey(node_p) : XKey();
+        if (!key)
+            break; // No parent or node is detached concurrently
+
+        path.push_front(std::move(key));
+        node_p = std::move(parent_p);
+    }
+}
+
+void XNode::AsyncPost_()
+{
+    // Changes appended by other writers while posting are posted by this thread, so the order is kept
+    auto node_this = NodeThis_();
+    for (;;) {
+        std::vector<PrivateSubtreeChange> changes;
+        {
+            std::unique_lock lck(container_rw_);
+            changes = std::exchange(async_changes_, {});
+            if (changes.empty()) {
+                async_posting_ = false;
+                return;
+            }
+        }
+
+        for (const auto& change : changes)
+            node_callbacks_.DoAsync(node_this, change.key, change.from, change.to, change.reason);
+    }
+}
+
+/*static*/ void XNode::Unlocked_(XNode*                              _node_p,
+                                 std::vector<PrivateSubtreeChange>&& _subtree_changes,
+                                 bool                                _async_post)
+{
+    // Changes of nodes in order of unlocks, passed when thread holds no write locks (e.g. after all nodes of
+    // transaction or after node which callback changed other nodes), so callbacks could access the tree and
+    // posting could wait for dispatcher queue space (async callbacks could read the changed nodes)
+    struct Pending {
+        std::weak_ptr<XNode>              node_wp;
+        std::vector<PrivateSubtreeChange> subtree_changes;
+        bool                              async_post;
+    };
+    thread_local std::vector<Pending> pending;
+    thread_local bool                 notifying = false;
+
+    assert(write_locks_ > 0);
+    --write_locks_;
+    if (!_subtree_changes.empty() || _async_post)
+        pending.push_back({_node_p->weak_from_this(), std::move(_subtree_changes), _async_post});
+
+    if (write_locks_ > 0 || notifying)
+        return;
+
+    // Changes of nodes changed by subtree callbacks are passed after previous ones
+    notifying = true;
+    for (size_t idx = 0; idx < pending.size(); ++idx) {
+        auto node_p = pending[idx].node_wp.lock();
+        if (!node_p)
+            continue;
+
+        if (pending[idx].async_post)
+            node_p->AsyncPost_();
+        if (!pending[idx].subtree_changes.empty())
+            node_p->SubtreeNotify_(std::exchange(pending[idx].subtree_changes, {}));
+    }
+    pending.clear();
+    notifying = false;
+}
+
+void XNode::WriteLock::unlock()
+{
+    // Previous snapshot is retired after unlock (reclaimed snapshots could release nodes)
+    const auto* snapshot_prev_p = node_p_->SnapshotPublish_();
+    auto        subtree_changes = std::exchange(node_p_->subtree_changes_, {});
+    // Async changes are posted by this thread if no other thread is posting changes of node
+    bool async_post = !node_p_->async_changes_.empty() && !std::exchange(node_p_->async_posting_, true);
+    lck_.unlock();
+    XEpoch::Retire(snapshot_prev_p);
+
+    Unlocked_(node_p_, std::move(subtree_changes), async_post);
 }
 
 } // namespace xsdk::impl
\ No newline at end of file
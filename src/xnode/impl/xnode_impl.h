@@ -4,9 +4,12 @@
 #include "../xparent_validator.h"
 
 #include "xnode_callbacks.h"
+#include "xnode_snapshot.h"
+#include "xscalar_slots.h"
 
 #include "xnode_interfaces.h"
 
+#include <atomic>
 #include <deque>
 #include <map>
 #include <memory>
@@ -40,6 +43,41 @@ public:
 
     // Do not change parent of inserted node (if _val is node)
     virtual INode::InsertRes PrivateInsert(const XKey& _key, XValue&& _val) = 0;
+
+    // Transactions (@see xnode::Transaction): changes are applied to node locked by PrivateLock(), w/o parents update
+    // Changes of array are applied in order, each index refers to the array changed by previous changes
+    struct PrivateChange {
+        XKey     key;
+        XValue   to;              // Empty - erase
+        XValueRT from;            // Set on apply
+        bool     applied = false; // False - not changed (e.g. erase of missed key)
+        XKey     key_at;          // Set on apply: key of changed item (array index for kIdxLast)
+        size_t   size_from = 0;   // Set on apply: items count before change (array increased by set is reverted)
+    };
+
+    virtual void PrivateLock()   = 0;
+    virtual void PrivateUnlock() = 0;
+
+    // Vetoed (or failed) changes are reverted, return false if reverted
+    virtual bool PrivateApply(std::vector<PrivateChange>& _changes) = 0;
+    // Revert applied changes in reverse order (e.g. on other node failure), callbacks are called with Rollback reason
+    virtual void PrivateRevert(const std::vector<PrivateChange>& _changes) = 0;
+
+    // Subtree callbacks (@see INode::OnChangeSubtreeAdd()): changes of node are passed to node and ancestors
+    // after all write locks of thread are released
+    struct PrivateSubtreeChange {
+        INode::CallbackReason reason;
+        XKey                  key;
+        XValueRT              from;
+        XValueRT              to;
+    };
+
+    // Key of child node (name for map, index for array), empty if not found
+    virtual XKey PrivateChildKey(const INode::SPtrC& _child) const = 0;
+    // Call subtree callbacks with changes of node (_path - path of changed node relative to this one)
+    virtual void PrivateSubtreeNotify(const INode::SPtrC&                      _node,
+                                      const XPath&                             _path,
+                                      const std::vector<PrivateSubtreeChange>& _changes) const = 0;
 };
 
 class XNode final: public INode, public INodePrivate, public std::enable_shared_from_this<XNode> {
@@ -48,12 +86,32 @@ class XNode final: public INode, public INodePrivate, public std::enable_shared_
     mutable std::shared_mutex               container_rw_;
     const std::unique_ptr<IContainerMatch>  container_match_p_;
     const std::unique_ptr<IParentValidator> parent_validator_p_;
+    const bool                              values_timed_; // false - container values w/o own timestamps
+    std::atomic<uint64_t>                   generation_ = 0; // Changed under container_rw_ unique lock
+    int64_t                                 timestamp_last_ = kAbsentRT; // Last values timestamp (under unique lock)
+
+    // Lock-free readers snapshot (if enabled), published on write unlock if node was changed
+    const bool                              read_snapshots_;
+    std::atomic<const XNodeSnapshot*>       snapshot_p_     = nullptr;
+    bool                                    snapshot_dirty_ = false;
+
+    // Map scalar values readable by AtScalar() w/o locks (if enabled), updated under unique lock
+    const std::unique_ptr<XScalarSlots>     scalar_slots_p_;
 
     mutable std::shared_mutex    parent_n_name_rw_;
     std::weak_ptr<INode>         parent_wp_;
     std::unique_ptr<std::string> name_p_; // for reduce footprint (?)
 
     mutable XNodeCallbacks node_callbacks_;
+
+    // Changes for subtree callbacks (if any), passed on unlock
+    std::vector<PrivateSubtreeChange> subtree_changes_;
+    // Changes for async callbacks (if any), posted w/o nodes locks by single thread at once (in order of changes)
+    std::vector<PrivateSubtreeChange> async_changes_;
+    bool                              async_posting_ = false;
+
+    // Count of write locks held by thread, subtree callbacks are called when thread holds no write locks
+    inline static thread_local size_t write_locks_ = 0;
 #ifdef _DEBUG
     inline static std::atomic<int64_t> nodes_counter_;
 #endif
@@ -61,19 +119,28 @@ class XNode final: public INode, public INodePrivate, public std::enable_shared_
     XNode(std::unique_ptr<IContainerMatch>&&  _container_match,
           std::unique_ptr<IParentValidator>&& _parent_validator,
           uint64_t                            _uid,
-          std::string_view                    _name);
+          std::string_view                    _name,
+          bool                                _read_snapshots,
+          bool                                _scalar_slots);
 public:
     static std::shared_ptr<XNode> Create(std::unique_ptr<IContainerMatch>&&  _container_match,
                                                std::unique_ptr<IParentValidator>&& _parent_validator,
                                                uint64_t                            _uid,
-                                               std::string_view                    _name)
+                                               std::string_view                    _name,
+                                               bool                                _read_snapshots = false,
+                                               bool                                _scalar_slots   = false)
     {
-        return std::shared_ptr<XNode> {new XNode(std::move(_container_match), std::move(_parent_validator), _uid, _name)};
+        return std::shared_ptr<XNode> {new XNode(std::move(_container_match),
+                                                 std::move(_parent_validator),
+                                                 _uid,
+                                                 _name,
+                                                 _read_snapshots,
+                                                 _scalar_slots)};
     }
 
-#ifdef _DEBUG
-    virtual ~XNode() { nodes_counter_.fetch_sub(1); }
+    virtual ~XNode();
 
+#ifdef _DEBUG
     static int64_t counter() { return nodes_counter_.load(); }
 #endif
 
@@ -107,6 +174,12 @@ public:
     //-------------------------------------------------------------------------------
     // Callbacks, return uid for subsiqent remove this cb
     virtual uint64_t OnChangeAdd(OnChangePF&& _pf_on_change, uint64_t _id /*= 0*/) const override;
+    virtual uint64_t OnChangeKeysAdd(OnChangePF&& _pf_on_change,
+                                     KeysFilter   _filter,
+                                     uint64_t     _id /*= 0*/) const override;
+    virtual uint64_t OnChangeBatchAdd(OnChangeBatchPF&& _pf_on_batch, uint64_t _id /*= 0*/) const override;
+    virtual uint64_t OnChangeAsyncAdd(OnChangePF&& _pf_on_change, uint64_t _id /*= 0*/) const override;
+    virtual uint64_t OnChangeSubtreeAdd(OnSubtreeChangePF&& _pf_on_change, uint64_t _id /*= 0*/) const override;
     virtual bool     OnChangeRemove(uint64_t _id) const override;
     virtual size_t   OnChangeReset() const override;
 
@@ -116,13 +189,22 @@ public:
     virtual void     Clear() override;
     virtual size_t   Size() const override;
     virtual bool     Empty() const override;
+    virtual uint64_t Generation() const override;
     virtual XValueRT At(const XKey& _key) const override;
     virtual XValueRT At(const XKey& _key) override;
+    virtual XValueRT AtScalar(const XKey& _key) const override;
 
     // Return all items include erased
     virtual bool ForPatch(std::function<bool(const XKey&, const XValueRT&)>&& _pf_on_item,
                           const XKey&                                         _from_key) const override;
 
+    // Iterate items w/o copies under read lock (or snapshot)
+    virtual bool Visit(std::function<bool(const XKey&, const XValueRT&)>&& _pf_on_item,
+                       const XKey&                                         _from_key) const override;
+
+    // Remove erased items older than _keep_msec, return removed count
+    virtual size_t ErasedCompact(double _keep_msec) override;
+
     // Method for take, Erase, change items via callback
     virtual bool ForEach(std::function<OnEachRes(const XKey&, XValueRT&)>&& _pf_on_item,
                          const XKey&                                        _from_key) override;
@@ -187,6 +269,24 @@ public:
 
     virtual InsertRes PrivateInsert(const XKey& _key, XValue&& _val) override;
 
+    virtual void PrivateLock() override;
+    virtual void PrivateUnlock() override;
+    virtual bool PrivateApply(std::vector<PrivateChange>& _changes) override;
+    virtual void PrivateRevert(const std::vector<PrivateChange>& _changes) override;
+    virtual XKey PrivateChildKey(const INode::SPtrC& _child) const override;
+    virtual void PrivateSubtreeNotify(const INode::SPtrC&                      _node,
+                                      const XPath&                             _path,
+                                      const std::vector<PrivateSubtreeChange>& _changes) const override;
+
+    //----------------------------------------------------------------------------------------------
+    // Direct build of new node (@see XNodeBuilder): node is not shared yet, so items are put w/o locks,
+    // callbacks and parents validation
+
+    // Put item, child node (if any) is linked to this one, return false for duplicated key
+    bool BuildPut(const XKey& _key, XValue&& _val, XNode* _child_p = nullptr);
+    // Finish build: publish node state (generation, snapshot for lock-free readers)
+    void BuildEnd();
+
 private:
     // Const conversions
     static XValueRT MakeConst_(XValueRT&& _val);
@@ -198,11 +298,99 @@ private:
     IContainer*       ContainerGet_() { return container_match_p_->ContainerGet(); }
     const IContainer* ContainerGet_() const { return container_match_p_->ContainerGet(); }
 
-    // Callback helper
-    IContainer::OnChangePF OnChangePF_(bool _no_discard = false);
+    // Values for container (w/o timestamp if container values are not timed), called under unique lock
+    XValueRT ValueRT_(XValue&& _val);
+    XValueRT ValueRT_(const XValue& _val);
+    // Timestamp greater than timestamps of previous changes: node changes are ordered even if the clock is not
+    // advanced between them (e.g. coarse clock ticks, clock shards of different threads)
+    int64_t  Timestamp_();
+
+    // Callback helper (also updates generation on structure changes), _batched - changes passed to batch callbacks
+    // by operation (@see ChangesBatch)
+    IContainer::OnChangePF OnChangePF_(bool _no_discard = false, bool _batched = false);
+    // Changes w/o callbacks: only node state (generation, snapshot, scalar slots) is updated
+    IContainer::OnChangePF OnChangeSilentPF_();
+    void                   Changed_(const IContainer::KeyType& _key, const XValueRT& _from, const XValueRT& _to);
+    void                   ScalarSlotSet_(const IContainer::KeyType& _key, const XValueRT& _val);
+    void                   GenerationNext_()
+    {
+        snapshot_dirty_ = true;
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+
+    // Container write lock, publishes snapshot for lock-free readers on unlock
+    class WriteLock {
+    public:
+        explicit WriteLock(XNode* _node_p) : node_p_(_node_p), lck_(_node_p->container_rw_) { ++write_locks_; }
+        WriteLock(XNode* _node_p, std::adopt_lock_t)
+            : node_p_(_node_p), lck_(_node_p->container_rw_, std::adopt_lock)
+        {
+        }
+        ~WriteLock()
+        {
+            if (lck_.owns_lock())
+                unlock();
+        }
+
+        void unlock();
+
+    private:
+        XNode*                              node_p_;
+        std::unique_lock<std::shared_mutex> lck_;
+    };
+
+    // Changes of bulk operation for batch callbacks (if any): approved as a whole before apply, approved but
+    // not applied changes are passed to batch callbacks as rollback
+    class ChangesBatch {
+    public:
+        explicit ChangesBatch(XNode* _node_p) : node_p_(_node_p), enabled_(_node_p->node_callbacks_.HasBatch()) {}
+
+        bool Enabled() const { return enabled_; }
+        void Add(const XKey& _key, XValueRT&& _from, XValueRT&& _to)
+        {
+            if (enabled_)
+                changes_.push_back({_key, std::move(_from), std::move(_to)});
+        }
+        bool Approve() const
+        {
+            return !enabled_ || node_p_->node_callbacks_.DoBatchCallbacks(node_p_->NodeThis_(), changes_, false);
+        }
+        // Value approved by callbacks (same timestamp for callbacks and node)
+        const XValueRT& To(size_t _pos) const { return changes_[_pos].to; }
+        void            Failed(size_t _pos)
+        {
+            if (enabled_)
+                failed_.push_back(changes_[_pos]);
+        }
+        void Rollback() const
+        {
+            if (enabled_)
+                node_p_->node_callbacks_.DoBatchRollback(node_p_->NodeThis_(), failed_);
+        }
+
+    private:
+        XNode*                     node_p_;
+        const bool                 enabled_;
+        std::vector<INode::Change> changes_;
+        std::vector<INode::Change> failed_;
+    };
+
+    // Lock-free readers snapshot helpers
+    const XNodeSnapshot* SnapshotGet_() const { return snapshot_p_.load(std::memory_order_seq_cst); }
+    const XNodeSnapshot* SnapshotPublish_();
+
+    // Subtree and async callbacks helpers: pass changes to node and ancestors, post changes to dispatcher
+    // (on release of last write lock of thread)
+    void        SubtreeNotify_(const std::vector<PrivateSubtreeChange>& _changes);
+    void        AsyncPost_();
+    static void Unlocked_(XNode* _node_p, std::vector<PrivateSubtreeChange>&& _subtree_changes, bool _async_post);
+
+    // Previous values of transaction changes (before apply, for batch callbacks)
+    void PrivateChangesFrom_(std::vector<PrivateChange>& _changes);
 
     // Key conversions
     IContainer::KeyType ContainerKey_(const XKey& _key, bool _use_index) const;
+    IContainer::KeyType ContainerKeyFind_(const XKey& _key, bool _use_index) const;
     XKey                NodeKey_(const IContainer::KeyType& _key) const;
 
     // Parent's check
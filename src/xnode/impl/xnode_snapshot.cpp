@@ -0,0 +1,68 @@
+#include "xnode_snapshot.h"
+
+#include "xconstant.h"
+
+#include <cassert>
+
+namespace xsdk::impl {
+
+XNodeSnapshot::XNodeSnapshot(std::vector<Item>&& _items, size_t _size, bool _map)
+    : items_(std::move(_items)), size_(_size)
+{
+    assert(size_ <= items_.size());
+    if (!_map || items_.empty())
+        return;
+
+    // Load factor <= 0.5
+    size_t slots_count = 4;
+    while (slots_count < items_.size() * 2)
+        slots_count *= 2;
+
+    slots_.resize(slots_count);
+    auto mask = slots_count - 1;
+    for (size_t pos = 0; pos < items_.size(); ++pos) {
+        const auto* atom_p = std::get_if<xnode::StringAtom>(&items_[pos].first);
+        if (!atom_p)
+            continue;
+
+        auto idx = atom_p->hash() & mask;
+        while (slots_[idx])
+            idx = (idx + 1) & mask;
+        slots_[idx] = (uint32_t)(pos + 1);
+    }
+}
+
+size_t XNodeSnapshot::Find(const XKey& _key) const
+{
+    switch (_key.Type()) {
+        case XKey::KeyType::Index: {
+            auto idx = _key.IndexGet().value();
+            if (idx == kIdxLast && size_)
+                idx = size_ - 1;
+            return idx < size_ ? idx : items_.size();
+        }
+        case XKey::KeyType::String: {
+            // Not interned string could not be a key of any item
+            const auto& atom = _key.AtomGet();
+            return AtomFind_(atom.empty() ? xnode::StringAtom::Borrow(_key.StringGet().value()) : atom);
+        }
+        default:
+            return items_.size();
+    }
+}
+
+size_t XNodeSnapshot::AtomFind_(const xnode::StringAtom& _atom) const
+{
+    if (slots_.empty() || _atom.empty())
+        return items_.size();
+
+    auto mask = slots_.size() - 1;
+    for (auto idx = _atom.hash() & mask; slots_[idx]; idx = (idx + 1) & mask) {
+        auto pos = slots_[idx] - 1;
+        if (std::get<xnode::StringAtom>(items_[pos].first) == _atom)
+            return pos;
+    }
+    return items_.size();
+}
+
+} // namespace xsdk::impl
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../../xcontainer/xcontainer.h"
+#include "xkey/xkey.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace xsdk::impl {
+
+// Immutable copy of node items for lock-free readers (published by node writers, reclaimed via XEpoch).
+// Items are kept in container order (index access), map items are indexed by interned keys.
+// Erased map items (empty values, @see INode::ForPatch()) are kept after items: found by key only, as in container.
+class XNodeSnapshot {
+public:
+    using Item = std::pair<IContainer::KeyType, IContainer::MappedType>;
+
+    XNodeSnapshot(std::vector<Item>&& _items, size_t _size, bool _map);
+
+    // Count of items (w/o erased)
+    size_t                   Size() const { return size_; }
+    const std::vector<Item>& Items() const { return items_; }
+
+    // Return item position or Items().size() if not found (index keys are items positions, also for maps)
+    size_t Find(const XKey& _key) const;
+
+private:
+    size_t AtomFind_(const xnode::StringAtom& _atom) const;
+
+    const std::vector<Item> items_;
+    const size_t            size_;
+    std::vector<uint32_t>   slots_; // Map only: item position + 1 (zero - empty slot), size is power of 2
+};
+
+} // namespace xsdk::impl
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "xnode_interfaces.h"
+
+#include <utility>
+#include <vector>
+
+namespace xsdk::impl {
+
+// Visit node items in order w/o holding the node read lock while nested nodes are processed:
+// locking of child under parent lock could deadlock with Transaction::Commit() (nodes are locked by address).
+// Scalar items are passed from INode::Visit(), the visit is stopped on scalar item after nested nodes: the collected
+// nested nodes (only references) are passed after Visit() returns and the visit is resumed from the stopped item.
+// The visit is also stopped (before scalar item) if _pf_page_full() returns true, _pf_page_end() is called after
+// each Visit() (w/o node lock), e.g. for pass of buffered output to sink.
+// Note: the node could be changed between visits, e.g. the rest items are skipped if the stopped item was erased.
+template <class TPFItem, class TPFPageFull, class TPFPageEnd>
+void VisitNestedUnlocked(const INode::SPtrC& _node_sp,
+                         TPFItem&&           _pf_on_item,
+                         TPFPageFull&&       _pf_page_full,
+                         TPFPageEnd&&        _pf_page_end)
+{
+    std::vector<std::pair<XKey, XValueRT>> nested;
+    XKey                                   key_from;
+    do {
+        XKey   key_stop;
+        size_t passed = 0; // At least one item is passed per visit
+        _node_sp->Visit(
+            [&](const XKey& _key, const XValueRT& _val) {
+                auto type = _val.Type();
+                if (type == XValue::kObject || type == XValue::kConstObject) {
+                    nested.emplace_back(_key, _val);
+                    return false;
+                }
+                if (!nested.empty() || (passed && _pf_page_full())) {
+                    key_stop = _key;
+                    return true;
+                }
+
+                _pf_on_item(_key, _val);
+                ++passed;
+                return false;
+            },
+            key_from);
+
+        for (const auto& [key, val] : nested)
+            _pf_on_item(key, val);
+        nested.clear();
+        _pf_page_end();
+        key_from = std::move(key_stop);
+    } while (key_from);
+}
+
+template <class TPFItem>
+void VisitNestedUnlocked(const INode::SPtrC& _node_sp, TPFItem&& _pf_on_item)
+{
+    VisitNestedUnlocked(_node_sp, std::forward<TPFItem>(_pf_on_item), [] { return false; }, [] {});
+}
+
+} // namespace xsdk::impl
@@ -10,6 +10,10 @@ std::pair<IContainer::KeyType, IContainer::MappedType> XParentValidatorArray::Fi
 {
     assert(_container_p);
 
+    // O(1) check for values index, the scan below only for real duplicates
+    if (_container_p->ValueCount(_value_check) == 0)
+        return {};
+
     IContainer::KeyType    key_existed;
     IContainer::MappedType val_existed;
     _container_p->ForEach([&](const auto& key, const auto& val) {
@@ -30,6 +34,10 @@ IContainer::KeyType XParentValidatorArray::RemoveDuplicates(IContainer*
 {
     assert(_container_p);
 
+    // Only one item (at _key_keep) -> nothing to remove
+    if (_container_p->ValueCount(_value_remove) < 2)
+        return {};
+
     IContainer::KeyType key_removed;
     _container_p->ForEach([&](const auto& key, const auto& val) {
         if (key != _key_keep && val == _value_remove) {
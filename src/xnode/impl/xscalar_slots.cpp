@@ -0,0 +1,206 @@
+#include "xscalar_slots.h"
+#include "xepoch.h"
+
+#include <cstring>
+#include <utility>
+
+namespace xsdk::impl {
+
+XScalarSlots::Table::Table(size_t _size) : mask(_size - 1), slots_p(new std::atomic<Slot*>[_size])
+{
+    for (size_t idx = 0; idx < _size; ++idx)
+        slots_p[idx].store(nullptr, std::memory_order_relaxed);
+}
+
+XScalarSlots::XScalarSlots() : slots_p_(std::make_unique<Slots>()) {}
+
+// No readers: each reader holds the node
+XScalarSlots::~XScalarSlots() { delete table_p_.load(std::memory_order_relaxed); }
+
+void XScalarSlots::Set(const xnode::StringAtom& _key, const XValueRT& _val)
+{
+    if (_key.empty())
+        return;
+
+    auto* slot_p = SlotFind_(table_p_.load(std::memory_order_relaxed), _key);
+    if (!IsScalar(_val)) {
+        if (slot_p && slot_p->type.load(std::memory_order_relaxed) != XValue::kEmpty) {
+            SlotWrite_(slot_p, XValue::kEmpty, 0, kAbsentRT);
+            ++empty_;
+            SlotsCompact_();
+        }
+        return;
+    }
+
+    uint64_t bits = 0;
+    switch (_val.Type()) {
+        case XValue::kBool:
+            bits = _val.Bool() ? 1 : 0;
+            break;
+        case XValue::kInt64:
+            bits = static_cast<uint64_t>(_val.Int64());
+            break;
+        case XValue::kUint64:
+            bits = _val.Uint64();
+            break;
+        default: {
+            auto val_double = _val.Double();
+            std::memcpy(&bits, &val_double, sizeof(bits));
+        }
+    }
+
+    // Values of not timed containers: time of change
+    auto timestamp = _val.TimeIsAbsent() ? XValueRT(XValue()).Timestamp() : _val.Timestamp();
+    if (slot_p) {
+        if (slot_p->type.load(std::memory_order_relaxed) == XValue::kEmpty)
+            --empty_;
+        SlotWrite_(slot_p, _val.Type(), bits, timestamp);
+        return;
+    }
+
+    // New slot is filled before publishing
+    slot_p      = &slots_p_->emplace_back();
+    slot_p->key = _key;
+    SlotWrite_(slot_p, _val.Type(), bits, timestamp);
+    SlotInsert_(slot_p);
+}
+
+void XScalarSlots::Reset()
+{
+    for (auto& slot : *slots_p_) {
+        if (slot.type.load(std::memory_order_relaxed) != XValue::kEmpty) {
+            SlotWrite_(&slot, XValue::kEmpty, 0, kAbsentRT);
+            ++empty_;
+        }
+    }
+    SlotsCompact_();
+}
+
+XValueRT XScalarSlots::Get(const xnode::StringAtom& _key) const
+{
+    if (_key.empty())
+        return XValueRT();
+
+    // Table and slots are not deleted until the end of critical section
+    XEpoch::Guard guard;
+    const auto*   slot_p = SlotFind_(table_p_.load(std::memory_order_acquire), _key);
+    if (!slot_p)
+        return XValueRT();
+
+    int      type      = XValue::kEmpty;
+    uint64_t bits      = 0;
+    int64_t  timestamp = kAbsentRT;
+    for (;;) {
+        auto sequence = slot_p->sequence.load(std::memory_order_acquire);
+        type          = slot_p->type.load(std::memory_order_relaxed);
+        bits          = slot_p->bits.load(std::memory_order_relaxed);
+        timestamp     = slot_p->timestamp.load(std::memory_order_relaxed);
+
+        // Fields loads are ordered before sequence re-check
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((sequence & 1) == 0 && slot_p->sequence.load(std::memory_order_relaxed) == sequence)
+            break;
+    }
+
+    switch (type) {
+        case XValue::kBool:
+            return XValueRT(XValue(bits != 0), timestamp);
+        case XValue::kInt64:
+            return XValueRT(XValue(static_cast<int64_t>(bits)), timestamp);
+        case XValue::kUint64:
+            return XValueRT(XValue(bits), timestamp);
+        case XValue::kDouble: {
+            double val_double = 0.0;
+            std::memcpy(&val_double, &bits, sizeof(bits));
+            return XValueRT(XValue(val_double), timestamp);
+        }
+        default:
+            return XValueRT();
+    }
+}
+
+/*static*/ XScalarSlots::Slot* XScalarSlots::SlotFind_(const Table* _table_p, const xnode::StringAtom& _key)
+{
+    if (!_table_p)
+        return nullptr;
+
+    for (auto idx = _key.hash() & _table_p->mask;; idx = (idx + 1) & _table_p->mask) {
+        auto* slot_p = _table_p->slots_p[idx].load(std::memory_order_acquire);
+        if (!slot_p || slot_p->key == _key)
+            return slot_p;
+    }
+}
+
+/*static*/ void XScalarSlots::SlotWrite_(Slot* _slot_p, int _type, uint64_t _bits, int64_t _timestamp)
+{
+    // Odd sequence is stored (and fenced) before fields, so readers detect overlapped write
+    auto sequence = _slot_p->sequence.load(std::memory_order_relaxed);
+    _slot_p->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    _slot_p->type.store(_type, std::memory_order_relaxed);
+    _slot_p->bits.store(_bits, std::memory_order_relaxed);
+    _slot_p->timestamp.store(_timestamp, std::memory_order_relaxed);
+
+    _slot_p->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void XScalarSlots::SlotInsert_(Slot* _slot_p)
+{
+    const auto* table_p = table_p_.load(std::memory_order_relaxed);
+
+    // Load factor <= 0.5, new table is filled before publishing (storage already contains new slot)
+    if (!table_p || slots_p_->size() * 2 > table_p->mask + 1) {
+        TablePublish_(table_p ? (table_p->mask + 1) * 2 : 16);
+        return;
+    }
+
+    auto idx = _slot_p->key.hash() & table_p->mask;
+    while (table_p->slots_p[idx].load(std::memory_order_relaxed))
+        idx = (idx + 1) & table_p->mask;
+    table_p->slots_p[idx].store(_slot_p, std::memory_order_release);
+}
+
+void XScalarSlots::SlotsCompact_()
+{
+    if (empty_ < kEmptyMin || empty_ * 2 <= slots_p_->size())
+        return;
+
+    // Not empty slots are copied to new storage, readers of previous storage get the same values
+    auto slots_p = std::make_unique<Slots>();
+    for (const auto& slot : *slots_p_) {
+        auto type = slot.type.load(std::memory_order_relaxed);
+        if (type == XValue::kEmpty)
+            continue;
+
+        auto& slot_new = slots_p->emplace_back();
+        slot_new.key   = slot.key;
+        slot_new.type.store(type, std::memory_order_relaxed);
+        slot_new.bits.store(slot.bits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        slot_new.timestamp.store(slot.timestamp.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    auto slots_prev_p = std::exchange(slots_p_, std::move(slots_p));
+    empty_            = 0;
+
+    size_t size = 16;
+    while (size < slots_p_->size() * 2)
+        size *= 2;
+    TablePublish_(size);
+    XEpoch::Retire(slots_prev_p.release());
+}
+
+void XScalarSlots::TablePublish_(size_t _size)
+{
+    auto table_p = std::make_unique<Table>(_size);
+    for (auto& slot : *slots_p_) {
+        auto idx = slot.key.hash() & table_p->mask;
+        while (table_p->slots_p[idx].load(std::memory_order_relaxed))
+            idx = (idx + 1) & table_p->mask;
+        table_p->slots_p[idx].store(&slot, std::memory_order_relaxed);
+    }
+
+    XEpoch::Retire(table_p_.exchange(table_p.release(), std::memory_order_release));
+}
+
+} // namespace xsdk::impl
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "xstring.h"
+#include "xvalue/xvalue_rt.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+namespace xsdk::impl {
+
+// Copy of map node scalar values (bool, int64, uint64, double) for readers w/o node lock.
+// Each slot holds value bits, type and timestamp protected by own sequence lock (odd sequence - write in progress):
+// readers do not write shared memory and retry only if the slot is changed during read.
+// Writers are serialized by node unique lock. Erased or non-scalar values reset slot to empty, slots lookup table
+// is grown by publishing of new table. When most of slots are empty the live slots are copied to new storage and
+// table: replaced tables and storages (with keys of slots) are retired and deleted after readers (@see XEpoch).
+class XScalarSlots {
+    struct Slot {
+        xnode::StringAtom     key; // Immutable after publishing
+        std::atomic<uint64_t> sequence  = 0;
+        std::atomic<int>      type      = XValue::kEmpty;
+        std::atomic<uint64_t> bits      = 0;
+        std::atomic<int64_t>  timestamp = kAbsentRT;
+    };
+
+    struct Table {
+        explicit Table(size_t _size);
+
+        const size_t                                mask;
+        const std::unique_ptr<std::atomic<Slot*>[]> slots_p; // Power of 2 size, nullptr - empty
+    };
+
+    using Slots = std::deque<Slot>; // Stable addresses
+
+    // Storage is rebuilt when more than half of slots (and at least kEmptyMin) are empty
+    static constexpr size_t kEmptyMin = 16;
+
+public:
+    XScalarSlots();
+    ~XScalarSlots();
+
+    XScalarSlots(const XScalarSlots&)            = delete;
+    XScalarSlots& operator=(const XScalarSlots&) = delete;
+
+    // Writer side (under node unique lock): set scalar value or reset slot (if any) for other values
+    void Set(const xnode::StringAtom& _key, const XValueRT& _val);
+    // Reset all slots to empty values
+    void Reset();
+
+    // Return scalar value with timestamp, empty value if key not found or value is not scalar
+    XValueRT Get(const xnode::StringAtom& _key) const;
+
+    static bool IsScalar(const XValue& _val) { return _val.Type() & XValue::kNumbersMask; }
+
+private:
+    static Slot* SlotFind_(const Table* _table_p, const xnode::StringAtom& _key);
+    static void  SlotWrite_(Slot* _slot_p, int _type, uint64_t _bits, int64_t _timestamp);
+    void         SlotInsert_(Slot* _slot_p);
+    // Copy not empty slots to new storage if most of slots are empty
+    void         SlotsCompact_();
+    // Publish new table of all slots, previous table is retired
+    void         TablePublish_(size_t _size);
+
+    std::atomic<const Table*> table_p_ = nullptr; // Owned
+    std::unique_ptr<Slots>    slots_p_;           // Writer only: slots storage
+    size_t                    empty_ = 0;         // Writer only: count of empty slots
+};
+
+} // namespace xsdk::impl
@@ -0,0 +1,139 @@
+#include "xwork_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <utility>
+
+namespace xsdk::impl {
+
+namespace {
+// Participant of pool run by current thread
+thread_local const XWorkPool* g_thread_pool_p = nullptr;
+thread_local size_t           g_thread_idx    = 0;
+} // namespace
+
+XWorkPool::XWorkPool(size_t _threads)
+{
+    for (size_t idx = 0; idx < std::max<size_t>(_threads, 1); ++idx)
+        deques_.push_back(std::make_unique<TaskDeque>());
+    for (size_t idx = 1; idx < deques_.size(); ++idx)
+        threads_.emplace_back([this, idx] { Run_(idx); });
+}
+
+XWorkPool::~XWorkPool()
+{
+    stopped_.store(true);
+    {
+        std::lock_guard lck(wake_mutex_);
+        wake_cv_.notify_all();
+    }
+    for (auto& thread : threads_)
+        thread.join();
+}
+
+void XWorkPool::Submit(Task&& _task)
+{
+    assert(_task);
+    pending_.fetch_add(1, std::memory_order_relaxed);
+
+    // Non-participants push to deque of waiting thread
+    auto& deque = *deques_[g_thread_pool_p == this ? g_thread_idx : 0];
+    {
+        std::lock_guard lck(deque.mutex);
+        deque.tasks.push_back(std::move(_task));
+    }
+
+    // Pushed task is ordered before check of sleeping count (paired with fence in Run_())
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        std::lock_guard lck(wake_mutex_);
+        wake_cv_.notify_one();
+    }
+}
+
+void XWorkPool::Wait()
+{
+    assert(!g_thread_pool_p && "nested wait");
+    auto pool_prev_p = std::exchange(g_thread_pool_p, this);
+    auto idx_prev    = std::exchange(g_thread_idx, 0);
+
+    // Sleep while running tasks are not done (could submit nested tasks), woken on submit and on last task done
+    while (pending_.load(std::memory_order_acquire)) {
+        if (!RunOne_(0))
+            Sleep_(true);
+    }
+
+    g_thread_pool_p = pool_prev_p;
+    g_thread_idx    = idx_prev;
+}
+
+bool XWorkPool::RunOne_(size_t _idx)
+{
+    Task task;
+    {
+        // Own tasks from back
+        auto& deque = *deques_[_idx];
+        std::lock_guard lck(deque.mutex);
+        if (!deque.tasks.empty()) {
+            task = std::move(deque.tasks.back());
+            deque.tasks.pop_back();
+        }
+    }
+
+    // Steal from front of others, starting from the next participant
+    for (size_t offset = 1; !task && offset < deques_.size(); ++offset) {
+        auto&           deque = *deques_[(_idx + offset) % deques_.size()];
+        std::lock_guard lck(deque.mutex);
+        if (!deque.tasks.empty()) {
+            task = std::move(deque.tasks.front());
+            deque.tasks.pop_front();
+        }
+    }
+
+    if (!task)
+        return false;
+
+    task();
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // Done count is ordered before check of sleeping count (paired with fence in Sleep_())
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping_.load(std::memory_order_relaxed)) {
+            std::lock_guard lck(wake_mutex_);
+            wake_cv_.notify_all();
+        }
+    }
+    return true;
+}
+
+void XWorkPool::Run_(size_t _idx)
+{
+    g_thread_pool_p = this;
+    g_thread_idx    = _idx;
+
+    while (!stopped_.load(std::memory_order_relaxed)) {
+        if (!RunOne_(_idx))
+            Sleep_(false);
+    }
+
+    g_thread_pool_p = nullptr;
+}
+
+void XWorkPool::Sleep_(bool _until_done)
+{
+    std::unique_lock lck(wake_mutex_);
+    sleeping_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Tasks (and done count) are rechecked after sleeping count is visible for writers, timeout - just in case
+    bool has_tasks = std::any_of(deques_.begin(), deques_.end(), [](const auto& _deque_p) {
+        std::lock_guard lck_deque(_deque_p->mutex);
+        return !_deque_p->tasks.empty();
+    });
+    bool done = _until_done && !pending_.load(std::memory_order_relaxed);
+    if (!has_tasks && !done && !stopped_.load())
+        wake_cv_.wait_for(lck, std::chrono::milliseconds(10));
+    sleeping_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace xsdk::impl
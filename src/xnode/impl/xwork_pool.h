@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xsdk::impl {
+
+// Fork-join pool with work stealing (e.g. for parallel serialization of large trees).
+// Each participant (pool threads and the thread waiting in Wait()) has own deque of tasks: tasks submitted
+// by participant are pushed to its deque and taken from back (LIFO - the data is likely in cache),
+// idle participants steal from front of other deques (the oldest tasks, usually the largest ones).
+// Tasks could submit nested tasks, Wait() returns when all tasks (including nested) are done.
+class XWorkPool {
+public:
+    using Task = std::function<void()>;
+
+    // _threads - count of participants including the thread calling Wait()
+    explicit XWorkPool(size_t _threads);
+    ~XWorkPool();
+
+    XWorkPool(const XWorkPool&)            = delete;
+    XWorkPool& operator=(const XWorkPool&) = delete;
+
+    void Submit(Task&& _task);
+    // Run tasks by calling thread until all submitted tasks are done
+    void Wait();
+
+private:
+    struct alignas(64) TaskDeque {
+        std::mutex       mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool RunOne_(size_t _idx);
+    void Run_(size_t _idx);
+    // Wait for submitted tasks (or for done of all tasks if _until_done)
+    void Sleep_(bool _until_done);
+
+    std::vector<std::unique_ptr<TaskDeque>> deques_; // [0] - thread calling Wait()
+    std::vector<std::thread>                threads_;
+
+    std::atomic<size_t> pending_  = 0; // Submitted and not finished tasks
+    std::atomic<size_t> sleeping_ = 0;
+    std::atomic_bool    stopped_  = false;
+
+    std::mutex              wake_mutex_;
+    std::condition_variable wake_cv_;
+};
+
+} // namespace xsdk::impl
@@ -1,26 +1,51 @@
+#include "../factory/xnode_builder.h"
+#include "../impl/xnode_visit.h"
+#include "../impl/xwork_pool.h"
 #include "xnode_json.h"
-#include "xnode_factory.h"
 
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/reader.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <memory>
+#include <ostream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 namespace xsdk {
 
+// Tree is built directly (w/o INode::Insert() per value): parsed tree is private until parse end
 struct XNodeJsonHandler: public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, XNodeJsonHandler> {
 
-    XValue root;
+    impl::XNodeBuilder builder;
 
 private:
-    XKey                     key;
-    std::vector<INode::SPtr> nodes;
+    XKey key;
 
     uint64_t         root_uid;
     std::string_view root_name;
 
+    // Buffer parsed in place (if any): long strings refer to it w/o copies
+    std::shared_ptr<xnode::StringBuffer> buffer_p;
+
 public:
-    XNodeJsonHandler(uint64_t _uid = 0, std::string_view _name = {}) : root_uid(_uid), root_name(_name) {}
+    XNodeJsonHandler(uint64_t                             _uid      = 0,
+                     std::string_view                     _name     = {},
+                     std::shared_ptr<xnode::StringBuffer> _buffer_p = nullptr)
+        : root_uid(_uid), root_name(_name), buffer_p(std::move(_buffer_p))
+    {
+    }
 
     bool Null() { return _put_value(XValue(nullptr)); }
     bool Bool(bool b) { return _put_value(XValue(b)); }
@@ -31,88 +56,170 @@ public:
     bool Double(double d) { return _put_value(XValue(d)); }
     bool String(const char* str, rapidjson::SizeType length, bool copy)
     {
+        if (buffer_p && !copy && length > xnode::StringShort::kSizeMax)
+            return _put_value(xnode::StringBuffer::View(buffer_p, std::string_view(str, length)));
+
         return _put_value(std::string_view(str, length));
     }
     bool Key(const char* str, rapidjson::SizeType length, bool copy)
     {
-        key = std::string(str, length);
+        // Interned once: container key is taken from atom
+        key = xnode::StringAtom(std::string_view(str, length));
         return true;
     }
 
     bool StartObject() { return _put_node(INode::NodeType::Map); }
 
-    bool EndObject(rapidjson::SizeType memberCount)
-    {
-        assert(!nodes.empty() && nodes.back() && nodes.back()->Size() == memberCount &&
-               nodes.back()->Type() == INode::NodeType::Map);
-
-        return _end_node();
-    }
+    bool EndObject(rapidjson::SizeType memberCount) { return builder.NodeEnd(); }
 
     bool StartArray() { return _put_node(INode::NodeType::Array); }
 
-    bool EndArray(rapidjson::SizeType elementCount)
-    {
-        assert(!nodes.empty() && nodes.back() && nodes.back()->Size() == elementCount &&
-               nodes.back()->Type() == INode::NodeType::Array);
-
-        return _end_node();
-    }
+    bool EndArray(rapidjson::SizeType elementCount) { return builder.NodeEnd(); }
 
 private:
-    bool _put_value(XValue&& _val)
-    {
-        if (nodes.empty()) {
-            assert(!key && !root);
-            root = std::move(_val);
-            return true;
-        }
-
-        auto [success, insert_at, prev] = nodes.back()->Insert(std::exchange(key, kIdxEnd), std::move(_val));
-        assert(success);
-        return success;
-    }
+    // Duplicated keys are reported as parse error
+    bool _put_value(XValue&& _val) { return builder.ValuePut(std::exchange(key, kIdxEnd), std::move(_val)); }
 
     bool _put_node(INode::NodeType _node_type)
     {
-        auto node_p = XNodeFactoryGet()->NodeCreate(_node_type,
-                                                    nodes.empty() ? root_name : std::string_view(),
-                                                    nodes.empty() ? root_uid : 0);
-        _put_value(node_p);
-        nodes.push_back(node_p);
-        return true;
+        bool root = builder.Depth() == 0;
+        return builder.NodeStart(_node_type,
+                                 std::exchange(key, kIdxEnd),
+                                 root ? root_name : std::string_view(),
+                                 root ? root_uid : 0);
     }
+};
 
-    bool _end_node()
-    {
-        if (nodes.empty())
-            return false;
+// In place stream over buffer w/o zero terminator (as rapidjson::InsituStringStream): unescaped strings are
+// written over the source data
+class JsonInsituStream {
+public:
+    using Ch = char;
 
-        nodes.pop_back();
-        return true;
+    JsonInsituStream(Ch* _data, size_t _size) : src_(_data), head_(_data), end_(_data + _size) {}
+
+    Ch     Peek() const { return src_ < end_ ? *src_ : '\0'; }
+    Ch     Take() { return src_ < end_ ? *src_++ : '\0'; }
+    size_t Tell() const { return static_cast<size_t>(src_ - head_); }
+
+    // Written string is not longer than read source
+    Ch*    PutBegin() { return dst_ = src_; }
+    void   Put(Ch _c)
+    {
+        assert(dst_ && dst_ < src_);
+        *dst_++ = _c;
     }
+    void   Flush() {}
+    size_t PutEnd(Ch* _begin) { return static_cast<size_t>(dst_ - _begin); }
+
+private:
+    Ch*       src_;
+    Ch*       dst_ = nullptr;
+    Ch* const head_;
+    Ch* const end_;
 };
 
+template <unsigned TParseFlags, class TStream>
+std::pair<INode::SPtr, size_t> JsonParse(TStream& _stream, XNodeJsonHandler& _handler)
+{
+    rapidjson::Reader reader;
+    auto              res       = reader.Parse<TParseFlags>(_stream, _handler);
+    size_t            error_pos = 0;
+    if (res.IsError())
+        error_pos = res.Offset() != 0 ? res.Offset() : -1;
+
+    return {_handler.builder.Root().QueryPtr<INode>(), error_pos};
+}
+
 std::pair<INode::SPtr, size_t> xnode::FromJson(std::string_view _json, uint64_t _uid, std::string_view _name)
 {
     if (_json.empty())
         return {nullptr, -1};
 
-    XNodeJsonHandler handler(_uid, _name);
-
-    rapidjson::Reader       reader;
+    XNodeJsonHandler        handler(_uid, _name);
     rapidjson::StringStream ssInput(_json.data());
-    auto                    res       = reader.Parse(ssInput, handler);
-    size_t                  error_pos = 0;
-    if (res.IsError())
-        error_pos = res.Offset() != 0 ? res.Offset() : -1;
+    return JsonParse<rapidjson::kParseDefaultFlags>(ssInput, handler);
+}
+
+std::pair<INode::SPtr, size_t> xnode::FromJsonInsitu(std::shared_ptr<char> _data_p,
+                                                     size_t                _size,
+                                                     uint64_t              _uid,
+                                                     std::string_view      _name)
+{
+    if (!_data_p || _size == 0)
+        return {nullptr, -1};
 
-    return {handler.root.QueryPtr<INode>(), error_pos};
+    JsonInsituStream stream(_data_p.get(), _size);
+    XNodeJsonHandler handler(_uid, _name, xnode::StringBuffer::Create(std::move(_data_p)));
+    return JsonParse<rapidjson::kParseInsituFlag>(stream, handler);
+}
+
+std::pair<INode::SPtr, size_t> xnode::FromJsonInsitu(std::string&& _json, uint64_t _uid, std::string_view _name)
+{
+    // The string is owned by buffer
+    auto json_p = std::make_shared<std::string>(std::move(_json));
+    auto size   = json_p->size();
+    return FromJsonInsitu(std::shared_ptr<char>(json_p, json_p->data()), size, _uid, _name);
 }
 
 // Serialization to json
+
+// Output stream for writers: the output is passed to sink by chunks of bounded size.
+// The sink is called from Flush() only, w/o node locks held: by WriteXNode() after each node and between pages of
+// node items (visit of node is paused when the buffer is full), so the buffer could exceed chunk size by output
+// of single value.
+class JsonChunkStream {
+public:
+    using Ch = char;
+
+    JsonChunkStream(const xnode::JsonChunkPF& _pf_chunk, size_t _chunk_size) :
+        pf_chunk_(_pf_chunk), chunk_size_(std::max<size_t>(_chunk_size, 1))
+    {
+        data_.reserve(chunk_size_);
+    }
+
+    void Put(char _ch) { data_.push_back(_ch); }
+
+    bool PageFull() const { return data_.size() >= chunk_size_; }
+
+    // Pass filled chunks to sink, the rest is kept for the next chunk
+    void Flush()
+    {
+        size_t pos = 0;
+        for (; data_.size() - pos >= chunk_size_; pos += chunk_size_)
+            Sink_(std::string_view(data_).substr(pos, chunk_size_));
+        data_.erase(0, pos);
+    }
+
+    // Pass all output to sink
+    void Finish()
+    {
+        Flush();
+        Sink_(data_);
+        data_.clear();
+    }
+
+    bool Failed() const { return failed_; }
+
+private:
+    void Sink_(std::string_view _chunk)
+    {
+        // After sink failure the output is skipped
+        if (!_chunk.empty() && !failed_)
+            failed_ = !pf_chunk_(_chunk);
+    }
+
+    const xnode::JsonChunkPF& pf_chunk_;
+    const size_t              chunk_size_;
+    std::string               data_;
+    bool                      failed_ = false;
+};
+
 template <class TWriter>
-void WriteXValue(TWriter&& writer, const XValueRT& ValueAt_, xnode::JsonFormat _json_format)
+void WriteXValue(TWriter&&              writer,
+                 const XValueRT&        ValueAt_,
+                 xnode::JsonFormat      _json_format,
+                 const JsonChunkStream* _paged_p = nullptr)
 {
     switch (ValueAt_.Type()) {
         case XValue::kEmpty: // 2Think !!!
@@ -136,7 +243,7 @@ void WriteXValue(TWriter&& writer, const XValueRT& ValueAt_, xnode::JsonFormat _
             break;
         case XValue::kObject:
         case XValue::kConstObject:
-            WriteXNode(ValueAt_.QueryPtrC<INode>(), writer, _json_format);
+            WriteXNode(ValueAt_.QueryPtrC<INode>(), writer, _json_format, _paged_p);
             break;
 
         default:
@@ -146,26 +253,65 @@ void WriteXValue(TWriter&& writer, const XValueRT& ValueAt_, xnode::JsonFormat _
 }
 
 template <class TWriter>
-void WriteXNode(const INode::SPtrC& _node_sp, TWriter&& writer, xnode::JsonFormat _json_format)
+void WriteXNode(const INode::SPtrC&    _node_sp,
+                TWriter&&              writer,
+                xnode::JsonFormat      _json_format,
+                const JsonChunkStream* _paged_p = nullptr)
 {
+    // Streamed output: the node items are visited by pages of about chunk size, passed to sink between pages
+    auto pf_page_full = [_paged_p] { return _paged_p && _paged_p->PageFull(); };
+    auto pf_page_end  = [&writer] { writer.Flush(); };
     if (_node_sp->Type() == INode::NodeType::Map) {
         writer.StartObject();
-        auto test_vec = _node_sp->BulkGetAll();
-        for (const auto& [key, xval] : _node_sp->BulkGetAll()) {
-            assert(!key.StringGet().value_or("").empty());
-            writer.Key(key.StringGet().value().data(),
-                       static_cast<rapidjson::SizeType>(key.StringGet().value().size()));
-            WriteXValue(writer, xval, _json_format);
-        }
+        impl::VisitNestedUnlocked(
+            _node_sp,
+            [&](const XKey& _key, const XValueRT& _val) {
+                auto key = _key.StringGet();
+                assert(key && !key->empty());
+                writer.Key(key->data(), static_cast<rapidjson::SizeType>(key->size()));
+                WriteXValue(writer, _val, _json_format, _paged_p);
+            },
+            pf_page_full,
+            pf_page_end);
         writer.EndObject();
     }
     else {
         assert(_node_sp->Type() == INode::NodeType::Array);
         writer.StartArray();
-        for (const auto& [key_idx, xval] : _node_sp->BulkGetAll())
-            WriteXValue(writer, xval, _json_format);
+        impl::VisitNestedUnlocked(
+            _node_sp,
+            [&](const XKey&, const XValueRT& _val) { WriteXValue(writer, _val, _json_format, _paged_p); },
+            pf_page_full,
+            pf_page_end);
         writer.EndArray();
     }
+
+    // Output of streaming writers is passed to sink here, after the node is unlocked
+    writer.Flush();
+}
+
+template <class TStream>
+void JsonWrite(const INode::SPtrC& _node_this,
+               TStream&            _stream,
+               xnode::JsonFormat   _json_format,
+               size_t              _indent_char_count,
+               char                _indent_char)
+{
+    const JsonChunkStream* paged_p = nullptr;
+    if constexpr (std::is_same_v<TStream, JsonChunkStream>)
+        paged_p = &_stream;
+
+    if (xnode::JsonFormat::kOneLine == _json_format) {
+        WriteXNode(_node_this, rapidjson::Writer<TStream>(_stream), _json_format, paged_p);
+    }
+    else {
+        auto writer = rapidjson::PrettyWriter<TStream>(_stream);
+        writer.SetFormatOptions(xnode::JsonFormat::kOneLineArrays == _json_format ?
+                                    rapidjson::kFormatSingleLineArray :
+                                    rapidjson::kFormatDefault);
+        writer.SetIndent(_indent_char, (uint32_t)_indent_char_count);
+        WriteXNode(_node_this, std::move(writer), _json_format, paged_p);
+    }
 }
 
 std::string xnode::ToJson(const INode::SPtrC& _node_this,
@@ -178,18 +324,259 @@ std::string xnode::ToJson(const INode::SPtrC& _node_this,
         return {};
 
     rapidjson::StringBuffer s;
-    if (JsonFormat::kOneLine == _json_format) {
-        WriteXNode(_node_this, rapidjson::Writer<rapidjson::StringBuffer>(s), _json_format);
+    JsonWrite(_node_this, s, _json_format, _indent_char_count, _indent_char);
+    return {s.GetString(), s.GetSize()};
+}
+
+// Parallel serialization: nested nodes of nodes with at least subtree_size_min items are serialized by pool tasks
+// into separate parts (grouped into batches of about subtree_size_min items), the parent part keeps positions of
+// nested parts. The value prefix (separator, indentation and key) is written by parent writer, indentation of
+// nested levels is added by part stream - so the joined parts are the same as output of sequential writer.
+class JsonParallelWriter {
+    struct Batch;
+
+    struct Part {
+        std::string                                  text;
+        std::vector<std::pair<size_t, const Part*>> holes; // {position in text, nested part}
+        std::vector<std::unique_ptr<Batch>>          batches;
+    };
+
+    struct Batch {
+        explicit Batch(size_t _level) : level(_level) {}
+
+        const size_t                              level; // Count of containers around nodes of batch
+        std::deque<std::pair<INode::SPtrC, Part>> items; // Stable references for holes
+        size_t                                    size = 0;
+    };
+
+    // Output stream with additional indentation after new lines
+    struct PartStream {
+        using Ch = char;
+
+        void Put(char _ch)
+        {
+            text.push_back(_ch);
+            if (_ch == '\n')
+                text.append(indent, indent_char);
+        }
+        void Flush() {}
+
+        std::string& text;
+        const size_t indent;
+        const char   indent_char;
+    };
+
+public:
+    JsonParallelWriter(xnode::JsonFormat                 _json_format,
+                       size_t                            _indent_char_count,
+                       char                              _indent_char,
+                       const xnode::JsonParallelOptions& _options,
+                       size_t                            _threads) :
+        json_format_(_json_format),
+        indent_char_count_(_indent_char_count),
+        indent_char_(_indent_char),
+        subtree_size_min_(std::max<size_t>(_options.subtree_size_min, 1)),
+        pool_(_threads)
+    {
     }
-    else {
-        auto writer = rapidjson::PrettyWriter<rapidjson::StringBuffer>(s);
-        writer.SetFormatOptions(JsonFormat::kOneLineArrays == _json_format ? rapidjson::kFormatSingleLineArray :
-                                                                             rapidjson::kFormatDefault);
-        writer.SetIndent(_indent_char, (uint32_t)_indent_char_count);
-        WriteXNode(_node_this, std::move(writer), _json_format);
+
+    std::string Write(const INode::SPtrC& _node)
+    {
+        Part root;
+        PartWrite_(root, _node, 0);
+        pool_.Wait();
+
+        std::string json;
+        json.reserve(Size_(root));
+        Join_(json, root);
+        return json;
     }
 
-    return {s.GetString(), s.GetSize()};
+private:
+    void PartWrite_(Part& _part, const INode::SPtrC& _node, size_t _level)
+    {
+        PartStream stream {_part.text, _level * indent_char_count_, indent_char_};
+        if (xnode::JsonFormat::kOneLine == json_format_) {
+            rapidjson::Writer<PartStream> writer(stream);
+            NodeWrite_(writer, _part, _node, _level);
+        }
+        else {
+            rapidjson::PrettyWriter<PartStream> writer(stream);
+            writer.SetFormatOptions(xnode::JsonFormat::kOneLineArrays == json_format_ ?
+                                        rapidjson::kFormatSingleLineArray :
+                                        rapidjson::kFormatDefault);
+            writer.SetIndent(indent_char_, (uint32_t)indent_char_count_);
+            NodeWrite_(writer, _part, _node, _level);
+        }
+    }
+
+    template <class TWriter>
+    void NodeWrite_(TWriter& _writer, Part& _part, const INode::SPtrC& _node_sp, size_t _level)
+    {
+        bool   is_map  = _node_sp->Type() == INode::NodeType::Map;
+        bool   split   = _node_sp->Size() >= subtree_size_min_;
+        Batch* batch_p = nullptr;
+
+        is_map ? _writer.StartObject() : _writer.StartArray();
+        impl::VisitNestedUnlocked(_node_sp, [&](const XKey& _key, const XValueRT& _val) {
+            if (is_map) {
+                auto key = _key.StringGet();
+                assert(key && !key->empty());
+                _writer.Key(key->data(), static_cast<rapidjson::SizeType>(key->size()));
+            }
+
+            auto type = _val.Type();
+            if (type != XValue::kObject && type != XValue::kConstObject) {
+                WriteXValue(_writer, _val, json_format_);
+                return;
+            }
+
+            auto node_p = _val.QueryPtrC<INode>();
+            if (!split) {
+                NodeWrite_(_writer, _part, node_p, _level + 1);
+                return;
+            }
+
+            // Empty raw value for prefix only, the node is written by task
+            _writer.RawValue("",
+                             0,
+                             node_p->Type() == INode::NodeType::Map ? rapidjson::kObjectType :
+                                                                       rapidjson::kArrayType);
+            if (!batch_p)
+                batch_p = _part.batches.emplace_back(std::make_unique<Batch>(_level + 1)).get();
+
+            auto& item = batch_p->items.emplace_back(node_p, Part());
+            _part.holes.emplace_back(_part.text.size(), &item.second);
+            batch_p->size += node_p->Size() + 1;
+            if (batch_p->size >= subtree_size_min_) {
+                BatchSubmit_(batch_p);
+                batch_p = nullptr;
+            }
+        });
+        if (batch_p)
+            BatchSubmit_(batch_p);
+        is_map ? _writer.EndObject() : _writer.EndArray();
+    }
+
+    void BatchSubmit_(Batch* _batch_p)
+    {
+        pool_.Submit([this, _batch_p] {
+            for (auto& [node_p, part] : _batch_p->items)
+                PartWrite_(part, node_p, _batch_p->level);
+        });
+    }
+
+    static size_t Size_(const Part& _part)
+    {
+        auto size = _part.text.size();
+        for (const auto& [pos, part_p] : _part.holes)
+            size += Size_(*part_p);
+        return size;
+    }
+
+    static void Join_(std::string& _json, const Part& _part)
+    {
+        size_t pos_prev = 0;
+        for (const auto& [pos, part_p] : _part.holes) {
+            _json.append(_part.text, pos_prev, pos - pos_prev);
+            Join_(_json, *part_p);
+            pos_prev = pos;
+        }
+        _json.append(_part.text, pos_prev, std::string::npos);
+    }
+
+    const xnode::JsonFormat json_format_;
+    const size_t            indent_char_count_;
+    const char              indent_char_;
+    const size_t            subtree_size_min_;
+    impl::XWorkPool         pool_;
+};
+
+std::string xnode::ToJsonParallel(const INode::SPtrC&        _node_this,
+                                  JsonFormat                 _json_format,
+                                  size_t                     _indent_char_count,
+                                  char                       _indent_char,
+                                  const JsonParallelOptions& _options)
+{
+    // Small root is written sequentially: not worth of pool threads start
+    auto threads = _options.threads ? _options.threads : std::thread::hardware_concurrency();
+    if (!_node_this || threads <= 1 || _node_this->Size() < std::max<size_t>(_options.subtree_size_min, 1))
+        return ToJson(_node_this, nullptr, _json_format, _indent_char_count, _indent_char);
+
+    return JsonParallelWriter(_json_format, _indent_char_count, _indent_char, _options, threads).Write(_node_this);
+}
+
+bool xnode::ToJson(const INode::SPtrC&       _node_this,
+                   const xnode::JsonChunkPF& _pf_chunk,
+                   xnode::JsonFormat         _json_format,
+                   size_t                    _indent_char_count,
+                   char                      _indent_char,
+                   size_t                    _chunk_size)
+{
+    if (!_node_this || !_pf_chunk)
+        return false;
+
+    JsonChunkStream stream(_pf_chunk, _chunk_size);
+    JsonWrite(_node_this, stream, _json_format, _indent_char_count, _indent_char);
+    stream.Finish();
+    return !stream.Failed();
+}
+
+bool xnode::ToJson(const INode::SPtrC& _node_this,
+                   std::ostream&       _stream,
+                   xnode::JsonFormat   _json_format,
+                   size_t              _indent_char_count,
+                   char                _indent_char,
+                   size_t              _chunk_size)
+{
+    auto pf_chunk = [&_stream](std::string_view _chunk) {
+        return _stream.write(_chunk.data(), static_cast<std::streamsize>(_chunk.size())).good();
+    };
+    return ToJson(_node_this, pf_chunk, _json_format, _indent_char_count, _indent_char, _chunk_size) &&
+           _stream.flush().good();
+}
+
+bool xnode::ToJson(const INode::SPtrC& _node_this,
+                   std::FILE*          _file_p,
+                   xnode::JsonFormat   _json_format,
+                   size_t              _indent_char_count,
+                   char                _indent_char,
+                   size_t              _chunk_size)
+{
+    if (!_file_p)
+        return false;
+
+    auto pf_chunk = [_file_p](std::string_view _chunk) {
+        return std::fwrite(_chunk.data(), 1, _chunk.size(), _file_p) == _chunk.size();
+    };
+    return ToJson(_node_this, pf_chunk, _json_format, _indent_char_count, _indent_char, _chunk_size) &&
+           std::fflush(_file_p) == 0;
+}
+
+bool xnode::ToJson(const INode::SPtrC& _node_this,
+                   int                 _fd,
+                   xnode::JsonFormat   _json_format,
+                   size_t              _indent_char_count,
+                   char                _indent_char,
+                   size_t              _chunk_size)
+{
+    auto pf_chunk = [_fd](std::string_view _chunk) {
+        // Partial writes (e.g. to socket or pipe) are continued
+        while (!_chunk.empty()) {
+#ifdef _WIN32
+            auto res = ::_write(_fd, _chunk.data(), static_cast<unsigned int>(_chunk.size()));
+#else
+            auto res = ::write(_fd, _chunk.data(), _chunk.size());
+#endif
+            if (res < 0 && errno == EINTR)
+                continue;
+            if (res <= 0)
+                return false;
+            _chunk.remove_prefix(static_cast<size_t>(res));
+        }
+        return true;
+    };
+    return ToJson(_node_this, pf_chunk, _json_format, _indent_char_count, _indent_char, _chunk_size);
 }
 
 } // namespace xsdk
@@ -11,10 +11,13 @@ class IContainerMatch {
 public:
     virtual ~IContainerMatch() = default;
 
-    virtual IContainer::KeyType ContainerKey(const XKey& _key, bool _sequntial_index) const = 0;
-    virtual XKey                NodeKey(const IContainer::KeyType& _key) const              = 0;
-    virtual IContainer*         ContainerGet()                                              = 0;
-    virtual const IContainer*   ContainerGet() const                                        = 0;
+    // Key for insertion (string is interned)
+    virtual IContainer::KeyType ContainerKey(const XKey& _key, bool _sequntial_index) const     = 0;
+    // Key for lookup: no interning and no allocations, empty key for not interned string (could not be found)
+    virtual IContainer::KeyType ContainerKeyFind(const XKey& _key, bool _sequntial_index) const = 0;
+    virtual XKey                NodeKey(const IContainer::KeyType& _key) const                  = 0;
+    virtual IContainer*         ContainerGet()                                                  = 0;
+    virtual const IContainer*   ContainerGet() const                                            = 0;
 };
 
 } // namespace xsdk
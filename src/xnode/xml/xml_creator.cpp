@@ -2,6 +2,8 @@
 
 #include "xml_creator.h"
 
+#include "../impl/xnode_visit.h"
+
 #include "xnode_interfaces.h"
 
 namespace xsdk::impl {
@@ -31,7 +33,7 @@ XC::DOMDocument* XmlDocCreator::GetDocument()
     if (impl) {
         doc_.reset(impl->createDocument(0, tr_->ToXmlChars(root_name.c_str())->data(), 0));
         auto root = doc_->getDocumentElement();
-        for (const auto& [key, xval] : root_node_->BulkGetAll()) {
+        VisitNestedUnlocked(root_node_, [&](const XKey& key, const XValueRT& xval) {
             assert(!key.StringGet().value_or("").empty());
             auto child_node = xval.QueryPtrC<INode>();
             if (child_node) {
@@ -56,7 +58,7 @@ XC::DOMDocument* XmlDocCreator::GetDocument()
                     }
                 }
             }
-        }
+        });
         return doc_.get();
     }
     return nullptr;
@@ -100,7 +102,7 @@ void XmlDocCreator::AddMapNode_(const INode::SPtrC& _node, XC::DOMElement* _pare
         }
     }
     _parent->appendChild(element);
-    for (const auto& [key, xval] : _node->BulkGetAll()) {
+    VisitNestedUnlocked(_node, [&](const XKey& key, const XValueRT& xval) {
         assert(!key.StringGet().value_or("").empty());
         auto child_node = xval.QueryPtrC<INode>();
         if (child_node) {
@@ -127,13 +129,13 @@ void XmlDocCreator::AddMapNode_(const INode::SPtrC& _node, XC::DOMElement* _pare
                 }
             }
         }
-    }
+    });
 }
 
 void XmlDocCreator::AddArrayNode_(const INode::SPtrC& _node, XC::DOMElement* _parent)
 {
     auto element_name = _node->IsName("") ? GetNameForUnnamedNode_() : _node->NameGet();
-    for (const auto& [key, xval] : _node->BulkGetAll()) {
+    VisitNestedUnlocked(_node, [&](const XKey&, const XValueRT& xval) {
         auto child_node = xval.QueryPtrC<INode>();
         if (child_node) {
             if (child_node->IsName("")) {
@@ -151,12 +153,12 @@ void XmlDocCreator::AddArrayNode_(const INode::SPtrC& _node, XC::DOMElement* _pa
             element->appendChild(value);
             _parent->appendChild(element);
         }
-    }
+    });
 }
 
 void XmlDocCreator::AddArrayNodeAsText_(const INode::SPtrC& _node, XC::DOMElement* _parent) {
     auto element = _parent;
-    for (const auto& [key, xval] : _node->BulkGetAll()) {
+    VisitNestedUnlocked(_node, [&](const XKey&, const XValueRT& xval) {
         auto child_node = xval.QueryPtrC<INode>();
         if (child_node) {
             AddNode_(child_node, element, true);
@@ -165,7 +167,7 @@ void XmlDocCreator::AddArrayNodeAsText_(const INode::SPtrC& _node, XC::DOMElemen
             auto value   = doc_->createTextNode(tr_->ToXmlChars(xval.String().data())->data());
             element->appendChild(value);
         }
-    }
+    });
 }
 
 std::string XmlDocCreator::GetNameForUnnamedNode_() { return "noname"; }
@@ -38,9 +38,9 @@ bool XValue::operator==(const XValue& _val) const
     if (IsInteger() && _val.IsInteger())
         return Int64() == _val.Int64();
 
-    const auto* p_str1 = StringView().data();      //-V758
-    const auto* p_str2 = _val.StringView().data(); //-V758
-    if (p_str1 && p_str2)                          //-V560 //-V560
+    const auto* p_str1 = StringC_();      //-V758
+    const auto* p_str2 = _val.StringC_(); //-V758
+    if (p_str1 && p_str2)                 //-V560 //-V560
         return std::strcmp(p_str1, p_str2) == 0;
 
     auto sp_obj1 = ObjectPtrC(); //-V779
@@ -59,9 +59,9 @@ int32_t XValue::Compare(const XValue& _val) const
     if (IsInteger() && _val.IsInteger())
         return (int32_t)(Int64() - _val.Int64());
 
-    const auto* p_str1 = StringView().data();      //-V758
-    const auto* p_str2 = _val.StringView().data(); //-V758
-    if (p_str1 && p_str2)                          //-V560 //-V560
+    const auto* p_str1 = StringC_();      //-V758
+    const auto* p_str2 = _val.StringC_(); //-V758
+    if (p_str1 && p_str2)                 //-V560 //-V560
         return std::strcmp(p_str1, p_str2);
 
     auto sp_obj1 = ObjectPtrC(); //-V779
@@ -96,7 +96,9 @@ XValue::ValueType XValue::Type() const noexcept
             return kUint64;
         case XValueIndex<double>():
             return kDouble;
+        case XValueIndex<xnode::StringShort>():
         case XValueIndex<xnode::String::SPtrC>():
+        case XValueIndex<xnode::StringBuffer::ViewPtrC>():
             return kString;
     }
 
@@ -119,7 +121,9 @@ bool XValue::IsAttribute() const noexcept
         case XValueIndex<int64_t>():
         case XValueIndex<uint64_t>():
         case XValueIndex<double>():
+        case XValueIndex<xnode::StringShort>():
         case XValueIndex<xnode::String::SPtrC>():
+        case XValueIndex<xnode::StringBuffer::ViewPtrC>():
             return true;
 
         default:
@@ -143,10 +147,15 @@ bool XValue::IsEmpty() const noexcept
         case XValueIndex<std::monostate>():
         case XValueIndex<XValueNull>():
             return true;
+        case XValueIndex<xnode::StringShort>():
+            return std::get<xnode::StringShort>(*this).size() == 0;
         case XValueIndex<xnode::String::SPtrC>():
             if (!std::get<xnode::String::SPtrC>(*this))
                 assert(std::get<xnode::String::SPtrC>(*this));
             return std::get<xnode::String::SPtrC>(*this)->empty();
+        case XValueIndex<xnode::StringBuffer::ViewPtrC>():
+            assert(std::get<xnode::StringBuffer::ViewPtrC>(*this));
+            return std::get<xnode::StringBuffer::ViewPtrC>(*this)->empty();
 
         default:
             return false;
@@ -164,11 +173,13 @@ bool XValue::Bool(bool _default) const
             return std::get<uint64_t>(*this) > 0;
         case XValueIndex<double>():
             return std::get<double>(*this) > 0.0;
-        case XValueIndex<xnode::String::SPtrC>(): {
-            auto p_str = std::get<xnode::String::SPtrC>(*this);
-            assert(p_str);
+        case XValueIndex<xnode::StringShort>():
+        case XValueIndex<xnode::String::SPtrC>():
+        case XValueIndex<xnode::StringBuffer::ViewPtrC>(): {
+            const auto* psz = StringC_();
+            assert(psz);
             // todo: !!! case unsensetive comparision
-            return *p_str == "true" || std::atof(p_str->c_str()) > 0;
+            return std::strcmp(psz, "true") == 0 || std::atof(psz) > 0;
         }
         default:
             return _default;
@@ -186,8 +197,10 @@ int64_t XValue::Int64(int64_t _default) const
             return (int64_t)std::min(std::get<uint64_t>(*this), (uint64_t)std::numeric_limits<int64_t>::max());
         case XValueIndex<double>():
             return std::llround(std::get<double>(*this));
-        case XValueIndex<xnode::String::SPtrC>(): {
-            const auto* psz = std::get<xnode::String::SPtrC>(*this)->c_str();
+        case XValueIndex<xnode::StringShort>():
+        case XValueIndex<xnode::String::SPtrC>():
+        case XValueIndex<xnode::StringBuffer::ViewPtrC>(): {
+            const auto* psz = StringC_();
             assert(psz);
             char* end = nullptr;
             auto  ll  = std::strtoll(psz, &end, 0);
@@ -216,8 +229,10 @@ uint64_t XValue::Uint64(uint64_t _default, uint64_t _negative_res) const
             auto ll = std::llround(std::get<double>(*this));
             return ll >= 0 ? (uint64_t)ll : _negative_res;
         }
-        case XValueIndex<xnode::String::SPtrC>(): {
-            const auto* psz = std::get<xnode::String::SPtrC>(*this)->c_str();
+        case XValueIndex<xnode::StringShort>():
+        case XValueIndex<xnode::String::SPtrC>():
+        case XValueIndex<xnode::StringBuffer::ViewPtrC>(): {
+            const auto* psz = StringC_();
             assert(psz);
             char* end = nullptr;
             if (psz[0] == '-') {
@@ -258,8 +273,10 @@ double XValue::Double(double _default) const
             return (double)std::get<uint64_t>(*this);
         case XValueIndex<double>():
             return std::get<double>(*this);
+        case XValueIndex<xnode::StringShort>():
         case XValueIndex<xnode::String::SPtrC>():
-            return std::atof(std::get<xnode::String::SPtrC>(*this)->c_str());
+        case XValueIndex<xnode::StringBuffer::ViewPtrC>():
+            return std::atof(StringC_());
         default:
             return _default;
     }
@@ -276,8 +293,12 @@ std::string XValue::String(std::string_view _default) const
             return std::to_string(std::get<uint64_t>(*this));
         case XValueIndex<double>():
             return std::to_string(std::get<double>(*this));
+        case XValueIndex<xnode::StringShort>():
+            return std::string(std::get<xnode::StringShort>(*this).view());
         case XValueIndex<xnode::String::SPtrC>():
             return *std::get<xnode::String::SPtrC>(*this);
+        case XValueIndex<xnode::StringBuffer::ViewPtrC>():
+            return std::string(*std::get<xnode::StringBuffer::ViewPtrC>(*this));
         default:
             return std::string(_default);
     }
@@ -285,13 +306,39 @@ std::string XValue::String(std::string_view _default) const
 
 std::string_view XValue::StringView(std::string_view _default) const
 {
+    const auto* short_p = std::get_if<xnode::StringShort>(this);
+    if (short_p)
+        return short_p->view();
+
     const auto* pp_str = std::get_if<xnode::String::SPtrC>(this);
     if (pp_str && *pp_str)
         return *pp_str->get();
 
+    const auto* pp_view = std::get_if<xnode::StringBuffer::ViewPtrC>(this);
+    if (pp_view && *pp_view)
+        return *pp_view->get();
+
     return _default;
 }
 
+const char* XValue::StringC_() const noexcept
+{
+    const auto* short_p = std::get_if<xnode::StringShort>(this);
+    if (short_p)
+        return short_p->c_str();
+
+    const auto* pp_str = std::get_if<xnode::String::SPtrC>(this);
+    if (pp_str && *pp_str)
+        return (*pp_str)->c_str();
+
+    // Views are zero terminated
+    const auto* pp_view = std::get_if<xnode::StringBuffer::ViewPtrC>(this);
+    if (pp_view && *pp_view)
+        return (*pp_view)->data();
+
+    return nullptr;
+}
+
 IObject::SPtr XValue::ObjectPtr(IObject::SPtr _default) const
 {
     auto pp_obj = std::get_if<IObject::SPtr>(this);
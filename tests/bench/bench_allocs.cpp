@@ -0,0 +1,69 @@
+#include "bench_utils.h"
+
+#include <algorithm>
+#include <cstdlib>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#include <new>
+
+// Replaced global allocation functions: count heap allocations per thread (for allocations per item counters)
+
+namespace {
+
+thread_local size_t g_allocs_count = 0;
+
+void* AllocCounted(size_t _size)
+{
+    ++g_allocs_count;
+    if (void* p = std::malloc(_size ? _size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* AllocCounted(size_t _size, std::align_val_t _align)
+{
+    ++g_allocs_count;
+    auto align = std::max((size_t)_align, sizeof(void*));
+#ifdef _WIN32
+    if (void* p = _aligned_malloc(_size ? _size : 1, align))
+        return p;
+#else
+    if (void* p = std::aligned_alloc(align, (_size + align - 1) / align * align))
+        return p;
+#endif
+
+    throw std::bad_alloc();
+}
+
+void FreeAligned(void* _p) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(_p);
+#else
+    std::free(_p);
+#endif
+}
+
+} // namespace
+
+size_t xsdk::bench::AllocsCount() { return g_allocs_count; }
+
+// NOLINTBEGIN(*)
+
+void* operator new(size_t _size) { return AllocCounted(_size); }
+void* operator new[](size_t _size) { return AllocCounted(_size); }
+void* operator new(size_t _size, std::align_val_t _align) { return AllocCounted(_size, _align); }
+void* operator new[](size_t _size, std::align_val_t _align) { return AllocCounted(_size, _align); }
+
+void operator delete(void* _p) noexcept { std::free(_p); }
+void operator delete[](void* _p) noexcept { std::free(_p); }
+void operator delete(void* _p, size_t) noexcept { std::free(_p); }
+void operator delete[](void* _p, size_t) noexcept { std::free(_p); }
+void operator delete(void* _p, std::align_val_t) noexcept { FreeAligned(_p); }
+void operator delete[](void* _p, std::align_val_t) noexcept { FreeAligned(_p); }
+void operator delete(void* _p, size_t, std::align_val_t) noexcept { FreeAligned(_p); }
+void operator delete[](void* _p, size_t, std::align_val_t) noexcept { FreeAligned(_p); }
+
+// NOLINTEND(*)
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "xnode.h"
+#include "xnode_factory.h"
+#include "xnode_functions.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace xsdk::bench {
+
+// Node sizes sweep: 1, 16, 256, 4K, 64K, 1M
+static constexpr int64_t kSizeMin        = 1;
+static constexpr int64_t kSizeMax        = 1 << 20;
+static constexpr int     kSizeMultiplier = 16;
+
+// Sizes for multi-threaded runs (full sweep x threads is too long)
+static constexpr int64_t kSizeThreadsSmall = 1 << 8;
+static constexpr int64_t kSizeThreadsLarge = 1 << 16;
+
+// Items per child node for tree benchmarks (Clone, Compare, JSON, XML)
+static constexpr size_t kTreeChildSize = 16;
+
+inline int ThreadsMax() { return std::max(1, (int)std::thread::hardware_concurrency()); }
+
+// Count of heap allocations made by calling thread (global operator new is replaced in bench_allocs.cpp)
+size_t AllocsCount();
+
+// Set "allocs" counter: heap allocations per item made by calling thread since _allocs_from
+// (averaged over threads for multi-threaded runs)
+inline void AllocsCounterSet(benchmark::State& _state, size_t _allocs_from, size_t _items)
+{
+    auto allocs               = (double)(AllocsCount() - _allocs_from) / (double)std::max<size_t>(_items, 1);
+    _state.counters["allocs"] = benchmark::Counter(allocs, benchmark::Counter::kAvgThreads);
+}
+
+// state.range(1): 0 - map, 1 - array
+inline INode::NodeType NodeTypeArg(int64_t _arg) { return _arg ? INode::NodeType::Array : INode::NodeType::Map; }
+
+inline const char* NodeTypeLabel(INode::NodeType _type)
+{
+    return _type == INode::NodeType::Array ? "array" : "map";
+}
+
+inline std::string KeyName(size_t _idx) { return "key_" + std::to_string(_idx); }
+
+inline XValue ValueMake(size_t _idx)
+{
+    switch (_idx % 4) {
+        case 0: return XValue((int64_t)_idx);
+        case 1: return XValue((double)_idx * 0.5);
+        case 2: return XValue("value_" + std::to_string(_idx));
+        default: return XValue((_idx & 0x4) != 0);
+    }
+}
+
+inline std::vector<XKey> KeysMake(INode::NodeType _type, size_t _count, size_t _from = 0)
+{
+    std::vector<XKey> keys;
+    keys.reserve(_count);
+    for (size_t i = _from; i < _from + _count; ++i) {
+        if (_type == INode::NodeType::Array)
+            keys.emplace_back(i);
+        else
+            keys.emplace_back(KeyName(i));
+    }
+    return keys;
+}
+
+inline const char* MapLayoutLabel(MapLayout _layout)
+{
+    switch (_layout) {
+        case MapLayout::Hash: return "hash";
+        case MapLayout::HashOrdered: return "hash_ordered";
+        case MapLayout::Flat: return "flat";
+        case MapLayout::FlatHash: return "flat_hash";
+        default: return "tree";
+    }
+}
+
+inline const char* ArrayLayoutLabel(ArrayLayout _layout)
+{
+    return _layout == ArrayLayout::Deque ? "deque" : "vector";
+}
+
+// Flat node with _count values of mixed types
+inline INode::SPtr NodeMake(INode::NodeType                             _type,
+                            size_t                                      _count,
+                            const std::optional<INodeFactory::Options>& _options = std::nullopt)
+{
+    auto node_p = xnode::Create(_type, {}, 0, _options);
+    if (_type == INode::NodeType::Array) {
+        std::vector<XValue> values;
+        values.reserve(_count);
+        for (size_t i = 0; i < _count; ++i)
+            values.emplace_back(ValueMake(i));
+        node_p->BulkInsert(XKey(kIdxEnd), std::move(values));
+    }
+    else {
+        std::vector<std::pair<XKey, XValue>> values;
+        values.reserve(_count);
+        for (size_t i = 0; i < _count; ++i)
+            values.emplace_back(KeyName(i), ValueMake(i));
+        node_p->BulkSet(std::move(values));
+    }
+    return node_p;
+}
+
+// Two levels tree with _count values in total: root of _type with children maps of kTreeChildSize values
+inline INode::SPtr TreeMake(INode::NodeType _type, size_t _count)
+{
+    auto root_p = xnode::Create(_type);
+    for (size_t child_idx = 0; child_idx * kTreeChildSize < _count; ++child_idx) {
+        auto child_p = NodeMake(INode::NodeType::Map, std::min(kTreeChildSize, _count - child_idx * kTreeChildSize));
+        if (_type == INode::NodeType::Array)
+            root_p->Insert(XKey(kIdxEnd), child_p);
+        else
+            root_p->Insert(XKey(KeyName(child_idx)), child_p);
+    }
+    return root_p;
+}
+
+// Apply sizes x {map, array} sweep
+inline void SizesSweep(benchmark::internal::Benchmark* _bench)
+{
+    _bench->ArgNames({"size", "array"});
+    for (int64_t size = kSizeMin; size <= kSizeMax; size *= kSizeMultiplier) {
+        _bench->Args({size, 0});
+        _bench->Args({size, 1});
+    }
+}
+
+// Apply sizes x map layouts sweep
+inline void MapLayoutsSweep(benchmark::internal::Benchmark* _bench)
+{
+    _bench->ArgNames({"size", "layout"});
+    for (int64_t size = kSizeMin; size <= kSizeMax; size *= kSizeMultiplier) {
+        for (auto layout :
+             {MapLayout::Tree, MapLayout::Hash, MapLayout::HashOrdered, MapLayout::Flat, MapLayout::FlatHash})
+            _bench->Args({size, (int64_t)layout});
+    }
+}
+
+// Apply small sizes x map layouts sweep
+inline void MapLayoutsSmallSweep(benchmark::internal::Benchmark* _bench)
+{
+    _bench->ArgNames({"size", "layout"});
+    for (int64_t size : {4, 8, 16}) {
+        for (auto layout :
+             {MapLayout::Tree, MapLayout::Hash, MapLayout::HashOrdered, MapLayout::Flat, MapLayout::FlatHash})
+            _bench->Args({size, (int64_t)layout});
+    }
+}
+
+// Apply sizes x array layouts sweep
+inline void ArrayLayoutsSweep(benchmark::internal::Benchmark* _bench)
+{
+    _bench->ArgNames({"size", "layout"});
+    for (int64_t size = kSizeMin; size <= kSizeMax; size *= kSizeMultiplier) {
+        for (auto layout : {ArrayLayout::Vector, ArrayLayout::Deque})
+            _bench->Args({size, (int64_t)layout});
+    }
+}
+
+// Apply {small, large} sizes x {map, array} x 1..N threads sweep
+inline void ThreadsSweep(benchmark::internal::Benchmark* _bench)
+{
+    _bench->ArgNames({"size", "array"});
+    for (auto size : {kSizeThreadsSmall, kSizeThreadsLarge}) {
+        _bench->Args({size, 0});
+        _bench->Args({size, 1});
+    }
+    _bench->ThreadRange(1, ThreadsMax())->UseRealTime();
+}
+
+} // namespace xsdk::bench
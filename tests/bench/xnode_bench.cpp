@@ -0,0 +1,678 @@
+#include "bench_utils.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+using namespace xsdk;
+using namespace xsdk::bench;
+
+// NOLINTBEGIN(*)
+
+namespace {
+
+// Node shared between benchmark threads, created by thread #0 before loop start
+// (benchmark library synchronize threads at start and at the end of the loop)
+INode::SPtr       g_node_p;
+std::vector<XKey> g_keys;
+
+void SharedSetup(const benchmark::State& _state)
+{
+    if (_state.thread_index() != 0)
+        return;
+
+    auto type = NodeTypeArg(_state.range(1));
+    g_node_p  = NodeMake(type, (size_t)_state.range(0));
+    g_keys    = KeysMake(type, (size_t)_state.range(0));
+}
+
+void SharedTeardown(benchmark::State& _state)
+{
+    if (_state.thread_index() != 0)
+        return;
+
+    _state.SetLabel(NodeTypeLabel(g_node_p->Type()));
+    g_node_p.reset();
+    g_keys.clear();
+}
+
+// Each thread walk keys with own offset for reduce same key contention.
+// Called before loop start, while thread #0 could still fill g_keys: the count of keys is taken from arguments.
+size_t KeyIdxFirst(const benchmark::State& _state)
+{
+    return ((size_t)_state.range(0) / _state.threads()) * _state.thread_index();
+}
+
+} // namespace
+
+static void BM_At(benchmark::State& _state)
+{
+    SharedSetup(_state);
+    size_t idx = KeyIdxFirst(_state);
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(g_node_p->At(g_keys[idx]));
+        if (++idx == g_keys.size())
+            idx = 0;
+    }
+    _state.SetItemsProcessed(_state.iterations());
+    SharedTeardown(_state);
+}
+BENCHMARK(BM_At)->Apply(SizesSweep);
+BENCHMARK(BM_At)->Apply(ThreadsSweep);
+
+// Read-mostly map: shared_mutex readers vs lock-free snapshot readers (INodeFactory::Options::read_snapshots),
+// thread #0 changes one value per 1024 reads
+static void BM_AtReadSnapshots(benchmark::State& _state)
+{
+    if (_state.thread_index() == 0) {
+        INodeFactory::Options options;
+        options.read_snapshots = _state.range(1) != 0;
+
+        g_node_p = NodeMake(INode::NodeType::Map, (size_t)_state.range(0), options);
+        g_keys   = KeysMake(INode::NodeType::Map, (size_t)_state.range(0));
+    }
+
+    size_t  idx     = KeyIdxFirst(_state);
+    int64_t counter = 0;
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(g_node_p->At(g_keys[idx]));
+        if (++idx == g_keys.size())
+            idx = 0;
+        if (_state.thread_index() == 0 && (++counter & 1023) == 0)
+            g_node_p->Set(g_keys[idx], counter);
+    }
+    _state.SetItemsProcessed(_state.iterations());
+    if (_state.thread_index() == 0) {
+        _state.SetLabel(_state.range(1) ? "read_snapshots" : "shared_mutex");
+        g_node_p.reset();
+        g_keys.clear();
+    }
+}
+BENCHMARK(BM_AtReadSnapshots)
+    ->ArgNames({"size", "snapshots"})
+    ->ArgsProduct({{kSizeThreadsSmall}, {0, 1}})
+    ->ThreadRange(1, ThreadsMax())
+    ->UseRealTime();
+
+// Scalar counters: At() with shared_mutex vs AtScalar() from seqlock slots (INodeFactory::Options::scalar_slots),
+// thread #0 changes one value per 64 reads
+static void BM_AtScalar(benchmark::State& _state)
+{
+    if (_state.thread_index() == 0) {
+        INodeFactory::Options options;
+        options.scalar_slots = _state.range(1) != 0;
+
+        g_node_p = NodeMake(INode::NodeType::Map, (size_t)_state.range(0), options);
+        g_keys   = KeysMake(INode::NodeType::Map, (size_t)_state.range(0));
+    }
+
+    bool    scalar  = _state.range(1) != 0;
+    size_t  idx     = KeyIdxFirst(_state);
+    int64_t counter = 0;
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(scalar ? g_node_p->AtScalar(g_keys[idx]) : g_node_p->At(g_keys[idx]));
+        if (++idx == g_keys.size())
+            idx = 0;
+        if (_state.thread_index() == 0 && (++counter & 63) == 0)
+            g_node_p->Set(g_keys[idx], counter);
+    }
+    _state.SetItemsProcessed(_state.iterations());
+    if (_state.thread_index() == 0) {
+        _state.SetLabel(scalar ? "scalar_slots" : "shared_mutex");
+        g_node_p.reset();
+        g_keys.clear();
+    }
+}
+BENCHMARK(BM_AtScalar)
+    ->ArgNames({"size", "scalar"})
+    ->ArgsProduct({{kSizeThreadsSmall}, {0, 1}})
+    ->ThreadRange(1, ThreadsMax())
+    ->UseRealTime();
+
+static void BM_MapLayoutAt(benchmark::State& _state)
+{
+    INodeFactory::Options options;
+    options.map_layout = (MapLayout)_state.range(1);
+
+    auto   size   = (size_t)_state.range(0);
+    auto   node_p = NodeMake(INode::NodeType::Map, size, options);
+    auto   keys   = KeysMake(INode::NodeType::Map, size);
+    size_t idx    = 0;
+    auto   allocs = AllocsCount();
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(node_p->At(keys[idx]));
+        if (++idx == keys.size())
+            idx = 0;
+    }
+    AllocsCounterSet(_state, allocs, _state.iterations());
+    _state.SetItemsProcessed(_state.iterations());
+    _state.SetLabel(MapLayoutLabel(options.map_layout));
+}
+BENCHMARK(BM_MapLayoutAt)->Apply(MapLayoutsSweep);
+
+// Key made from string per call: node->At("key") (should be allocation free)
+static void BM_MapLayoutAtString(benchmark::State& _state)
+{
+    INodeFactory::Options options;
+    options.map_layout = (MapLayout)_state.range(1);
+
+    auto                     size   = (size_t)_state.range(0);
+    auto                     node_p = NodeMake(INode::NodeType::Map, size, options);
+    std::vector<std::string> names;
+    for (size_t i = 0; i < size; ++i)
+        names.push_back(KeyName(i));
+
+    size_t idx    = 0;
+    auto   allocs = AllocsCount();
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(node_p->At(names[idx]));
+        if (++idx == names.size())
+            idx = 0;
+    }
+    AllocsCounterSet(_state, allocs, _state.iterations());
+    _state.SetItemsProcessed(_state.iterations());
+    _state.SetLabel(MapLayoutLabel(options.map_layout));
+}
+BENCHMARK(BM_MapLayoutAtString)->Apply(MapLayoutsSweep);
+
+// Key made from string per call (e.g. keys from parsed text): interning table lookup, no allocation for known keys
+static void BM_KeyMake(benchmark::State& _state)
+{
+    std::vector<std::string> names;
+    for (size_t i = 0; i < (size_t)_state.range(0); ++i)
+        names.push_back(KeyName(i));
+
+    // Intern before measure (as keys of nodes)
+    for (const auto& name : names)
+        xnode::StringAtom atom(name);
+
+    size_t idx = 0;
+    for (auto _ : _state) {
+        XKey key(names[idx]);
+        benchmark::DoNotOptimize(key);
+        if (++idx == names.size())
+            idx = 0;
+    }
+    _state.SetItemsProcessed(_state.iterations());
+}
+BENCHMARK(BM_KeyMake)->ArgName("size")->Arg(kSizeThreadsSmall)->Arg(kSizeThreadsLarge);
+BENCHMARK(BM_KeyMake)->ArgName("size")->Arg(kSizeThreadsSmall)->ThreadRange(1, ThreadsMax())->UseRealTime();
+
+// Paging through map by index (e.g. UI lists)
+static void BM_MapLayoutIndexAt(benchmark::State& _state)
+{
+    INodeFactory::Options options;
+    options.map_layout = (MapLayout)_state.range(1);
+
+    auto   size   = (size_t)_state.range(0);
+    auto   node_p = NodeMake(INode::NodeType::Map, size, options);
+    size_t idx    = 0;
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(node_p->At(XKey(idx)));
+        if (++idx == size)
+            idx = 0;
+    }
+    _state.SetItemsProcessed(_state.iterations());
+    _state.SetLabel(MapLayoutLabel(options.map_layout));
+}
+BENCHMARK(BM_MapLayoutIndexAt)->Apply(MapLayoutsSweep);
+
+// Access by index with key erased and restored between reads (keys index is updated, not rebuilt)
+static void BM_MapLayoutIndexAtChanged(benchmark::State& _state)
+{
+    INodeFactory::Options options;
+    options.map_layout = (MapLayout)_state.range(1);
+
+    auto   size   = (size_t)_state.range(0);
+    auto   node_p = NodeMake(INode::NodeType::Map, size, options);
+    auto   keys   = KeysMake(INode::NodeType::Map, size);
+    size_t idx    = 0;
+    for (auto _ : _state) {
+        auto val = node_p->Erase(keys[idx]);
+        node_p->Set(keys[idx], std::move(val));
+        benchmark::DoNotOptimize(node_p->At(XKey(idx)));
+        if (++idx == size)
+            idx = 0;
+    }
+    _state.SetItemsProcessed(_state.iterations());
+    _state.SetLabel(MapLayoutLabel(options.map_layout));
+}
+BENCHMARK(BM_MapLayoutIndexAtChanged)->Apply(MapLayoutsSweep);
+
+// Create and fill small node per iteration
+static void BM_MapLayoutCreate(benchmark::State& _state)
+{
+    INodeFactory::Options options;
+    options.map_layout = (MapLayout)_state.range(1);
+
+    auto size = (size_t)_state.range(0);
+    for (auto _ : _state)
+        benchmark::DoNotOptimize(NodeMake(INode::NodeType::Map, size, options));
+
+    _state.SetItemsProcessed(_state.iterations());
+    _state.SetLabel(MapLayoutLabel(options.map_layout));
+}
+BENCHMARK(BM_MapLayoutCreate)->Apply(MapLayoutsSmallSweep);
+
+static void BM_MapLayoutBulkGetAll(benchmark::State& _state)
+{
+    INodeFactory::Options options;
+    options.map_layout = (MapLayout)_state.range(1);
+
+    INode::SPtrC node_cp = NodeMake(INode::NodeType::Map, (size_t)_state.range(0), options);
+    for (auto _ : _state)
+        benchmark::DoNotOptimize(node_cp->BulkGetAll());
+
+    _state.SetItemsProcessed(_state.iterations());
+    _state.SetLabel(MapLayoutLabel(options.map_layout));
+}
+BENCHMARK(BM_MapLayoutBulkGetAll)->Apply(MapLayoutsSmallSweep);
+
+static void BM_ArrayLayoutAt(benchmark::State& _state)
+{
+    INodeFactory::Options options;
+    options.array_layout = (ArrayLayout)_state.range(1);
+
+    auto   size   = (size_t)_state.range(0);
+    auto   node_p = NodeMake(INode::NodeType::Array, size, options);
+    auto   keys   = KeysMake(INode::NodeType::Array, size);
+    size_t idx    = 0;
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(node_p->At(keys[idx]));
+        if (++idx == keys.size())
+            idx = 0;
+    }
+    _state.SetItemsProcessed(_state.iterations());
+    _state.SetLabel(ArrayLayoutLabel(options.array_layout));
+}
+BENCHMARK(BM_ArrayLayoutAt)->Apply(ArrayLayoutsSweep);
+
+// Append to the end: per item Insert() vs one BulkInsert()
+static void BM_ArrayLayoutAppend(benchmark::State& _state)
+{
+    INodeFactory::Options options;
+    options.array_layout = (ArrayLayout)_state.range(1);
+
+    auto size = (size_t)_state.range(0);
+    for (auto _ : _state) {
+        auto node_p = xnode::Create(INode::NodeType::Array, {}, 0, options);
+        for (size_t i = 0; i < size; ++i)
+            node_p->Insert(XKey(kIdxEnd), XValue((int64_t)i));
+        benchmark::DoNotOptimize(node_p);
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+    _state.SetLabel(ArrayLayoutLabel(options.array_layout));
+}
+BENCHMARK(BM_ArrayLayoutAppend)->Apply(ArrayLayoutsSweep);
+
+static void BM_ArrayLayoutBulkAppend(benchmark::State& _state)
+{
+    INodeFactory::Options options;
+    options.array_layout = (ArrayLayout)_state.range(1);
+
+    auto size = (size_t)_state.range(0);
+    for (auto _ : _state)
+        benchmark::DoNotOptimize(NodeMake(INode::NodeType::Array, size, options));
+
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+    _state.SetLabel(ArrayLayoutLabel(options.array_layout));
+}
+BENCHMARK(BM_ArrayLayoutBulkAppend)->Apply(ArrayLayoutsSweep);
+
+// Values w/o own timestamps: state.range(2) - 0 timed, 1 untimed
+static void BM_ValuesUntimedBulk(benchmark::State& _state)
+{
+    INodeFactory::Options options;
+    options.values_timed = _state.range(2) == 0;
+
+    auto type = NodeTypeArg(_state.range(1));
+    auto size = (size_t)_state.range(0);
+    for (auto _ : _state)
+        benchmark::DoNotOptimize(NodeMake(type, size, options));
+
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+    _state.SetLabel(std::string(NodeTypeLabel(type)) + (options.values_timed ? "" : " untimed"));
+}
+BENCHMARK(BM_ValuesUntimedBulk)
+    ->ArgNames({"size", "array", "untimed"})
+    ->ArgsProduct({{kSizeThreadsSmall, kSizeThreadsLarge}, {0, 1}, {0, 1}});
+
+// Append child nodes (duplicates check for each node)
+static void BM_ArrayChildsAppend(benchmark::State& _state)
+{
+    auto                     size = (size_t)_state.range(0);
+    std::vector<INode::SPtr> childs;
+    for (size_t i = 0; i < size; ++i)
+        childs.push_back(xnode::Create(INode::NodeType::Map));
+
+    for (auto _ : _state) {
+        auto node_p = xnode::Create(INode::NodeType::Array);
+        for (const auto& child_p : childs)
+            node_p->Insert(XKey(kIdxEnd), child_p);
+        benchmark::DoNotOptimize(node_p);
+
+        _state.PauseTiming();
+        node_p.reset();
+        _state.ResumeTiming();
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_ArrayChildsAppend)->ArgName("size")->RangeMultiplier(kSizeMultiplier)->Range(kSizeMin, kSizeThreadsLarge);
+
+static void BM_Set(benchmark::State& _state)
+{
+    SharedSetup(_state);
+    size_t  idx    = KeyIdxFirst(_state);
+    int64_t val    = 0;
+    auto    allocs = AllocsCount();
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(g_node_p->Set(g_keys[idx], XValue(++val)));
+        if (++idx == g_keys.size())
+            idx = 0;
+    }
+    AllocsCounterSet(_state, allocs, _state.iterations());
+    _state.SetItemsProcessed(_state.iterations());
+    SharedTeardown(_state);
+}
+BENCHMARK(BM_Set)->Apply(SizesSweep);
+BENCHMARK(BM_Set)->Apply(ThreadsSweep);
+
+// Writer with slow observer (~2 usec per notification): inline callback vs async callback.
+// Bursts of sets are flushed out of timing, so the writer time w/o observer stall is measured.
+static void BM_SetSlowObserver(benchmark::State& _state)
+{
+    constexpr size_t kBurst = 256;
+
+    auto async  = _state.range(0) != 0;
+    auto node_p = NodeMake(INode::NodeType::Map, kSizeThreadsSmall);
+    auto keys   = KeysMake(INode::NodeType::Map, kSizeThreadsSmall);
+
+    auto pf_observer = [](INode::CallbackReason, const INode::SPtrC&, const XKey&, const XValueRT&,
+                          const XValueRT&) -> std::optional<bool> {
+        auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(2);
+        while (std::chrono::steady_clock::now() < until)
+            ;
+        return true;
+    };
+    if (async)
+        node_p->OnChangeAsyncAdd(pf_observer);
+    else
+        node_p->OnChangeAdd(pf_observer);
+
+    int64_t val = 0;
+    for (auto _ : _state) {
+        for (size_t i = 0; i < kBurst; ++i)
+            benchmark::DoNotOptimize(node_p->Set(keys[i % keys.size()], XValue(++val)));
+
+        _state.PauseTiming();
+        xnode::AsyncFlush();
+        _state.ResumeTiming();
+    }
+    _state.SetItemsProcessed(_state.iterations() * kBurst);
+    if (async)
+        _state.counters["latency_avg_usec"] = xnode::AsyncMetricsGet().latency_avg_usec;
+}
+BENCHMARK(BM_SetSlowObserver)->ArgName("async")->Arg(0)->Arg(1);
+
+// Set with many subscribers of different keys: callbacks filter keys vs keys filtered by node
+static void BM_SetKeysCallbacks(benchmark::State& _state)
+{
+    auto subscribers = (size_t)_state.range(0);
+    auto filtered    = _state.range(1) != 0;
+    auto node_p      = NodeMake(INode::NodeType::Map, kSizeThreadsSmall);
+    auto keys        = KeysMake(INode::NodeType::Map, kSizeThreadsSmall);
+
+    size_t calls = 0;
+    for (size_t i = 0; i < subscribers; ++i) {
+        auto key = keys[i % keys.size()];
+        if (filtered) {
+            node_p->OnChangeKeysAdd([&](INode::CallbackReason, const INode::SPtrC&, const XKey&, const XValueRT&,
+                                        const XValueRT&) -> std::optional<bool> { return ++calls > 0; },
+                                    {{key}, {}});
+        }
+        else {
+            node_p->OnChangeAdd([&, key](INode::CallbackReason, const INode::SPtrC&, const XKey& _key,
+                                         const XValueRT&, const XValueRT&) -> std::optional<bool> {
+                if (_key == key)
+                    ++calls;
+                return true;
+            });
+        }
+    }
+
+    size_t  idx = 0;
+    int64_t val = 0;
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(node_p->Set(keys[idx], XValue(++val)));
+        if (++idx == keys.size())
+            idx = 0;
+    }
+    benchmark::DoNotOptimize(calls);
+    _state.SetItemsProcessed(_state.iterations());
+}
+BENCHMARK(BM_SetKeysCallbacks)->ArgNames({"subscribers", "filtered"})->ArgsProduct({{1, 50}, {0, 1}});
+
+// Set of deep node value: w/o subtree callbacks vs callback of root (path resolved by parent links)
+static void BM_SetSubtreeCallbacks(benchmark::State& _state)
+{
+    auto depth      = (size_t)_state.range(0);
+    auto subscribed = _state.range(1) != 0;
+    auto root_p     = xnode::CreateMap();
+    auto node_p     = root_p;
+    for (size_t i = 0; i < depth; ++i)
+        node_p = xnode::NodeGet(node_p, "level", INode::NodeType::Map);
+    auto keys = KeysMake(INode::NodeType::Map, kSizeThreadsSmall);
+
+    size_t calls = 0;
+    if (subscribed) {
+        root_p->OnChangeSubtreeAdd([&](INode::CallbackReason, const INode::SPtrC&, const XPath& _path,
+                                       const XValueRT&, const XValueRT&) -> std::optional<bool> {
+            calls += _path.size();
+            return true;
+        });
+    }
+
+    size_t  idx = 0;
+    int64_t val = 0;
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(node_p->Set(keys[idx], XValue(++val)));
+        if (++idx == keys.size())
+            idx = 0;
+    }
+    benchmark::DoNotOptimize(calls);
+    _state.SetItemsProcessed(_state.iterations());
+}
+BENCHMARK(BM_SetSubtreeCallbacks)->ArgNames({"depth", "subscribed"})->ArgsProduct({{1, 8}, {0, 1}});
+
+static void BM_Increment(benchmark::State& _state)
+{
+    SharedSetup(_state);
+    size_t       idx = KeyIdxFirst(_state);
+    const XValue increment(int64_t(1));
+    for (auto _ : _state) {
+        benchmark::DoNotOptimize(g_node_p->Increment(g_keys[idx], increment));
+        if (++idx == g_keys.size())
+            idx = 0;
+    }
+    _state.SetItemsProcessed(_state.iterations());
+    SharedTeardown(_state);
+}
+BENCHMARK(BM_Increment)->Apply(SizesSweep);
+BENCHMARK(BM_Increment)->Apply(ThreadsSweep);
+
+static void BM_CompareExchange(benchmark::State& _state)
+{
+    SharedSetup(_state);
+    size_t idx = KeyIdxFirst(_state);
+    for (auto _ : _state) {
+        // Value is changed by other threads, so exchange could fail - it is fine for measure
+        auto expected = g_node_p->At(g_keys[idx]);
+        benchmark::DoNotOptimize(g_node_p->CompareExchange(g_keys[idx], expected, XValue(int64_t(idx))));
+        if (++idx == g_keys.size())
+            idx = 0;
+    }
+    _state.SetItemsProcessed(_state.iterations());
+    SharedTeardown(_state);
+}
+BENCHMARK(BM_CompareExchange)->Apply(SizesSweep);
+BENCHMARK(BM_CompareExchange)->Apply(ThreadsSweep);
+
+// Insert state.range(0) items into empty node per iteration
+static void BM_Insert(benchmark::State& _state)
+{
+    auto type = NodeTypeArg(_state.range(1));
+    auto size = (size_t)_state.range(0);
+    auto keys = type == INode::NodeType::Array ? std::vector<XKey>(size, XKey(kIdxEnd)) : KeysMake(type, size);
+    for (auto _ : _state) {
+        _state.PauseTiming();
+        auto node_p = xnode::Create(type);
+        _state.ResumeTiming();
+
+        for (size_t i = 0; i < size; ++i)
+            benchmark::DoNotOptimize(node_p->Insert(keys[i], ValueMake(i)));
+
+        _state.PauseTiming();
+        node_p.reset();
+        _state.ResumeTiming();
+    }
+    _state.SetItemsProcessed(_state.iterations() * size);
+    _state.SetLabel(NodeTypeLabel(type));
+}
+BENCHMARK(BM_Insert)->Apply(SizesSweep);
+
+// Erase all state.range(0) items from node per iteration
+static void BM_Erase(benchmark::State& _state)
+{
+    auto type = NodeTypeArg(_state.range(1));
+    auto size = (size_t)_state.range(0);
+    // For array erase always first item - it is worst case for array
+    auto keys = type == INode::NodeType::Array ? std::vector<XKey>(size, XKey(kIdxBegin)) : KeysMake(type, size);
+    for (auto _ : _state) {
+        _state.PauseTiming();
+        auto node_p = NodeMake(type, size);
+        _state.ResumeTiming();
+
+        for (size_t i = 0; i < size; ++i)
+            benchmark::DoNotOptimize(node_p->Erase(keys[i]));
+
+        _state.PauseTiming();
+        node_p.reset();
+        _state.ResumeTiming();
+    }
+    _state.SetItemsProcessed(_state.iterations() * size);
+    _state.SetLabel(NodeTypeLabel(type));
+}
+BENCHMARK(BM_Erase)->Apply(SizesSweep);
+
+static void BM_BulkSet(benchmark::State& _state)
+{
+    auto type = NodeTypeArg(_state.range(1));
+    auto size = (size_t)_state.range(0);
+    auto keys = KeysMake(type, size);
+    for (auto _ : _state) {
+        _state.PauseTiming();
+        auto node_p = NodeMake(type, size);
+
+        std::vector<std::pair<XKey, XValue>> values;
+        values.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+            values.emplace_back(keys[i], ValueMake(i + 1));
+        _state.ResumeTiming();
+
+        benchmark::DoNotOptimize(node_p->BulkSet(std::move(values)));
+
+        _state.PauseTiming();
+        node_p.reset();
+        _state.ResumeTiming();
+    }
+    _state.SetItemsProcessed(_state.iterations() * size);
+    _state.SetLabel(NodeTypeLabel(type));
+}
+BENCHMARK(BM_BulkSet)->Apply(SizesSweep);
+
+// Notifications of bulk set: per-key callback vs one batch callback
+static void BM_BulkSetCallbacks(benchmark::State& _state)
+{
+    auto size  = (size_t)_state.range(0);
+    auto batch = _state.range(1) != 0;
+    auto keys  = KeysMake(INode::NodeType::Map, size);
+
+    size_t notified = 0;
+    for (auto _ : _state) {
+        _state.PauseTiming();
+        auto node_p = NodeMake(INode::NodeType::Map, size);
+        if (batch) {
+            node_p->OnChangeBatchAdd([&](INode::CallbackReason, const INode::SPtrC&,
+                                         const std::vector<INode::Change>& _changes) -> std::optional<bool> {
+                notified += _changes.size();
+                return true;
+            });
+        }
+        else {
+            node_p->OnChangeAdd([&](INode::CallbackReason, const INode::SPtrC&, const XKey&, const XValueRT&,
+                                    const XValueRT&) -> std::optional<bool> {
+                ++notified;
+                return true;
+            });
+        }
+
+        std::vector<std::pair<XKey, XValue>> values;
+        values.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+            values.emplace_back(keys[i], ValueMake(i + 1));
+        _state.ResumeTiming();
+
+        benchmark::DoNotOptimize(node_p->BulkSet(std::move(values)));
+
+        _state.PauseTiming();
+        node_p.reset();
+        _state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(notified);
+    _state.SetItemsProcessed(_state.iterations() * size);
+}
+BENCHMARK(BM_BulkSetCallbacks)
+    ->ArgNames({"size", "batch"})
+    ->ArgsProduct({{kSizeThreadsSmall, kSizeThreadsLarge}, {0, 1}});
+
+static void BM_BulkGetAll(benchmark::State& _state)
+{
+    SharedSetup(_state);
+    INode::SPtrC node_cp = g_node_p;
+    for (auto _ : _state)
+        benchmark::DoNotOptimize(node_cp->BulkGetAll());
+
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+    SharedTeardown(_state);
+}
+BENCHMARK(BM_BulkGetAll)->Apply(SizesSweep);
+BENCHMARK(BM_BulkGetAll)->Apply(ThreadsSweep);
+
+int main(int argc, char** argv)
+{
+    // Write JSON results by default, explicit --benchmark_out overrides it
+    std::vector<char*> args(argv, argv + argc);
+    bool               has_out = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]).rfind("--benchmark_out=", 0) == 0)
+            has_out = true;
+    }
+
+    std::string out_arg    = "--benchmark_out=xnode_bench.json";
+    std::string format_arg = "--benchmark_out_format=json";
+    if (!has_out) {
+        args.push_back(out_arg.data());
+        args.push_back(format_arg.data());
+    }
+
+    int args_count = (int)args.size();
+    benchmark::Initialize(&args_count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(args_count, args.data()))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
+
+// NOLINTEND(*)
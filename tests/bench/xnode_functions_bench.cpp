@@ -0,0 +1,291 @@
+#include "bench_utils.h"
+
+#include "xnode_json.h"
+#include "xnode_xml.h"
+
+using namespace xsdk;
+using namespace xsdk::bench;
+
+// NOLINTBEGIN(*)
+
+namespace {
+
+// Patch for TreeMake() tree: in each child change two values and erase one
+INode::SPtr PatchMake(const INode::SPtrC& _tree_p)
+{
+    auto patch_p = xnode::Create(_tree_p->Type());
+    _tree_p->BulkGetAll([&](const XKey& key, const XValueRT& val) {
+        auto child_p = val.QueryPtrC<INode>();
+        if (!child_p)
+            return OnCopyRes::Skip;
+
+        auto child_patch_p = xnode::Create(INode::NodeType::Map);
+        child_patch_p->Set(KeyName(0), XValue("patched"));
+        child_patch_p->Set(KeyName(kTreeChildSize / 2), XValue(int64_t(-1)));
+        child_patch_p->Set(KeyName(kTreeChildSize - 1), XValue(nullptr));
+
+        patch_p->Set(key, child_patch_p);
+        return OnCopyRes::Skip;
+    });
+    return patch_p;
+}
+
+} // namespace
+
+static void BM_Clone(benchmark::State& _state)
+{
+    auto tree_p = TreeMake(NodeTypeArg(_state.range(1)), (size_t)_state.range(0));
+    for (auto _ : _state) {
+        auto cloned_p = xnode::Clone(tree_p, true);
+        benchmark::DoNotOptimize(cloned_p);
+
+        _state.PauseTiming();
+        cloned_p.reset();
+        _state.ResumeTiming();
+    }
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+    _state.SetLabel(NodeTypeLabel(tree_p->Type()));
+}
+BENCHMARK(BM_Clone)->Apply(SizesSweep);
+
+static void BM_Compare(benchmark::State& _state)
+{
+    auto tree_p   = TreeMake(NodeTypeArg(_state.range(1)), (size_t)_state.range(0));
+    auto cloned_p = xnode::Clone(tree_p, true);
+    for (auto _ : _state)
+        benchmark::DoNotOptimize(xnode::Compare(tree_p, cloned_p, true));
+
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+    _state.SetLabel(NodeTypeLabel(tree_p->Type()));
+}
+BENCHMARK(BM_Compare)->Apply(SizesSweep);
+
+// Steady state: the same patch applied to the same target (after first iteration values are the same)
+static void BM_PatchApply(benchmark::State& _state)
+{
+    auto tree_p  = TreeMake(NodeTypeArg(_state.range(1)), (size_t)_state.range(0));
+    auto patch_p = PatchMake(tree_p);
+    for (auto _ : _state)
+        benchmark::DoNotOptimize(xnode::PatchApply(tree_p, patch_p));
+
+    _state.SetItemsProcessed(_state.iterations() * patch_p->Size());
+    _state.SetLabel(NodeTypeLabel(tree_p->Type()));
+}
+BENCHMARK(BM_PatchApply)->Apply(SizesSweep);
+
+// "allocs" counter: heap allocations per serialized value
+static void BM_ToJson(benchmark::State& _state)
+{
+    auto   tree_p      = TreeMake(NodeTypeArg(_state.range(1)), (size_t)_state.range(0));
+    size_t bytes       = 0;
+    auto   allocs_from = AllocsCount();
+    for (auto _ : _state) {
+        auto json = xnode::ToJson(tree_p, nullptr, xnode::JsonFormat::kOneLine);
+        bytes += json.size();
+        benchmark::DoNotOptimize(json);
+    }
+    AllocsCounterSet(_state, allocs_from, _state.iterations() * _state.range(0));
+    _state.SetBytesProcessed((int64_t)bytes);
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+    _state.SetLabel(NodeTypeLabel(tree_p->Type()));
+}
+BENCHMARK(BM_ToJson)->Apply(SizesSweep);
+
+// Streamed output: chunks passed to sink w/o accumulating of whole json
+static void BM_ToJsonStream(benchmark::State& _state)
+{
+    auto   tree_p   = TreeMake(NodeTypeArg(_state.range(1)), (size_t)_state.range(0));
+    size_t bytes    = 0;
+    auto   pf_chunk = [&bytes](std::string_view _chunk) {
+        bytes += _chunk.size();
+        benchmark::DoNotOptimize(_chunk.data());
+        return true;
+    };
+    auto allocs_from = AllocsCount();
+    for (auto _ : _state)
+        benchmark::DoNotOptimize(xnode::ToJson(tree_p, pf_chunk, xnode::JsonFormat::kOneLine));
+
+    AllocsCounterSet(_state, allocs_from, _state.iterations() * _state.range(0));
+    _state.SetBytesProcessed((int64_t)bytes);
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+    _state.SetLabel(NodeTypeLabel(tree_p->Type()));
+}
+BENCHMARK(BM_ToJsonStream)->Apply(SizesSweep);
+
+// Parallel serialization of large tree: threads count sweep (1 - sequential ToJson())
+static void BM_ToJsonParallel(benchmark::State& _state)
+{
+    auto tree_p = TreeMake(NodeTypeArg(_state.range(1)), (size_t)_state.range(0));
+
+    xnode::JsonParallelOptions options;
+    options.threads = (size_t)_state.range(2);
+
+    size_t bytes = 0;
+    for (auto _ : _state) {
+        auto json = xnode::ToJsonParallel(tree_p, xnode::JsonFormat::kOneLine, kExportIndentCount, ' ', options);
+        bytes += json.size();
+        benchmark::DoNotOptimize(json);
+    }
+    _state.SetBytesProcessed((int64_t)bytes);
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+    _state.SetLabel(NodeTypeLabel(tree_p->Type()));
+}
+BENCHMARK(BM_ToJsonParallel)
+    ->ArgNames({"size", "array", "threads"})
+    ->ArgsProduct({{65536, 1048576}, {0, 1}, {1, 2, 4, 8}})
+    ->UseRealTime();
+
+static void BM_MapLayoutToJson(benchmark::State& _state)
+{
+    INodeFactory::Options options;
+    options.map_layout = (MapLayout)_state.range(1);
+
+    auto node_p = NodeMake(INode::NodeType::Map, (size_t)_state.range(0), options);
+    for (auto _ : _state)
+        benchmark::DoNotOptimize(xnode::ToJson(node_p, nullptr, xnode::JsonFormat::kOneLine));
+
+    _state.SetItemsProcessed(_state.iterations());
+    _state.SetLabel(MapLayoutLabel(options.map_layout));
+}
+BENCHMARK(BM_MapLayoutToJson)->Apply(MapLayoutsSmallSweep);
+
+static void BM_FromJson(benchmark::State& _state)
+{
+    auto json = xnode::ToJson(TreeMake(NodeTypeArg(_state.range(1)), (size_t)_state.range(0)),
+                              nullptr,
+                              xnode::JsonFormat::kOneLine);
+    for (auto _ : _state) {
+        auto [node_p, err_pos] = xnode::FromJson(json);
+        benchmark::DoNotOptimize(node_p);
+
+        _state.PauseTiming();
+        node_p.reset();
+        _state.ResumeTiming();
+    }
+    _state.SetBytesProcessed(_state.iterations() * (int64_t)json.size());
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+    _state.SetLabel(NodeTypeLabel(NodeTypeArg(_state.range(1))));
+}
+BENCHMARK(BM_FromJson)->Apply(SizesSweep);
+
+// In-situ parsing: long strings refer to the (moved) json buffer
+static void BM_FromJsonInsitu(benchmark::State& _state)
+{
+    auto json = xnode::ToJson(TreeMake(NodeTypeArg(_state.range(1)), (size_t)_state.range(0)),
+                              nullptr,
+                              xnode::JsonFormat::kOneLine);
+    for (auto _ : _state) {
+        _state.PauseTiming();
+        auto json_copy = json;
+        _state.ResumeTiming();
+
+        auto [node_p, err_pos] = xnode::FromJsonInsitu(std::move(json_copy));
+        benchmark::DoNotOptimize(node_p);
+
+        _state.PauseTiming();
+        node_p.reset();
+        _state.ResumeTiming();
+    }
+    _state.SetBytesProcessed(_state.iterations() * (int64_t)json.size());
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+    _state.SetLabel(NodeTypeLabel(NodeTypeArg(_state.range(1))));
+}
+BENCHMARK(BM_FromJsonInsitu)->Apply(SizesSweep);
+
+// Value at the end of path of given depth: string path vs compiled path (w/o and with nodes cache)
+static void BM_PathAt(benchmark::State& _state)
+{
+    static const char* kModes[] = {"xpath_string", "compiled", "compiled_cached"};
+
+    auto        depth = (size_t)_state.range(0);
+    auto        mode  = _state.range(1);
+    auto        root  = xnode::Create(INode::NodeType::Map);
+    std::string path_str;
+    for (size_t i = 0; i < depth; ++i)
+        path_str += KeyName(i) + "::";
+    path_str += "value";
+    xnode::Set(root, XPath(path_str), 1);
+
+    xnode::CompiledPath path_compiled(path_str, mode == 2);
+    auto                allocs_from = AllocsCount();
+    for (auto _ : _state) {
+        auto val = mode ? path_compiled.At(root) : xnode::At(root, path_str);
+        benchmark::DoNotOptimize(val);
+    }
+    AllocsCounterSet(_state, allocs_from, _state.iterations());
+    _state.SetItemsProcessed(_state.iterations());
+    _state.SetLabel(kModes[mode]);
+}
+BENCHMARK(BM_PathAt)->ArgNames({"depth", "mode"})->ArgsProduct({{1, 4, 16}, {0, 1, 2}});
+
+// Writes of 4 values into each of given count of child nodes: separate xnode::Set() calls vs one transaction
+static void BM_Transaction(benchmark::State& _state)
+{
+    static constexpr size_t kValues = 4;
+
+    auto nodes = (size_t)_state.range(0);
+    bool batch = _state.range(1) != 0;
+    auto root  = xnode::Create(INode::NodeType::Map);
+
+    std::vector<XPath> paths;
+    for (size_t n = 0; n < nodes; ++n) {
+        for (size_t v = 0; v < kValues; ++v)
+            paths.emplace_back(KeyName(n) + "::" + KeyName(v));
+    }
+    for (const auto& path : paths)
+        xnode::Set(root, XPath(path), 0);
+
+    xnode::Transaction transaction(root);
+    int64_t            counter = 0;
+    for (auto _ : _state) {
+        ++counter;
+        for (const auto& path : paths) {
+            if (batch)
+                transaction.Set(path, counter);
+            else
+                xnode::Set(root, XPath(path), counter);
+        }
+        if (batch)
+            transaction.Commit();
+    }
+    _state.SetItemsProcessed(_state.iterations() * (int64_t)paths.size());
+    _state.SetLabel(batch ? "transaction" : "set");
+}
+BENCHMARK(BM_Transaction)->ArgNames({"nodes", "batch"})->ArgsProduct({{1, 4, 16}, {0, 1}});
+
+// XML root is always map (element), so only map sweep
+static void BM_ToXml(benchmark::State& _state)
+{
+    xnode::XmlPlatformInit();
+
+    auto   tree_p = TreeMake(INode::NodeType::Map, (size_t)_state.range(0));
+    size_t bytes  = 0;
+    for (auto _ : _state) {
+        auto xml = xnode::ToXml(tree_p);
+        bytes += xml.size();
+        benchmark::DoNotOptimize(xml);
+    }
+    _state.SetBytesProcessed((int64_t)bytes);
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_ToXml)->ArgName("size")->RangeMultiplier(kSizeMultiplier)->Range(kSizeMin, kSizeMax);
+
+static void BM_FromXml(benchmark::State& _state)
+{
+    xnode::XmlPlatformInit();
+
+    auto xml = xnode::ToXml(TreeMake(INode::NodeType::Map, (size_t)_state.range(0)));
+    for (auto _ : _state) {
+        auto [node_p, err_pos] = xnode::FromXml(xml);
+        benchmark::DoNotOptimize(node_p);
+
+        _state.PauseTiming();
+        node_p.reset();
+        _state.ResumeTiming();
+    }
+    _state.SetBytesProcessed(_state.iterations() * (int64_t)xml.size());
+    _state.SetItemsProcessed(_state.iterations() * _state.range(0));
+}
+BENCHMARK(BM_FromXml)->ArgName("size")->RangeMultiplier(kSizeMultiplier)->Range(kSizeMin, kSizeMax);
+
+// NOLINTEND(*)
@@ -0,0 +1,35 @@
+#include "bench_utils.h"
+
+#include "xvalue/xvalue_rt.h"
+
+using namespace xsdk;
+using namespace xsdk::bench;
+
+// NOLINTBEGIN(*)
+
+// Timestamp of XValueRT is taken on each value construction (and on each node change)
+template <class TClock>
+static void BM_ClockTimestamp(benchmark::State& _state)
+{
+    for (auto _ : _state)
+        benchmark::DoNotOptimize(TClock::Timestamp());
+
+    _state.SetItemsProcessed(_state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_ClockTimestamp, xnode::UniqueClock<>)->ThreadRange(1, ThreadsMax())->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ClockTimestamp, xnode::ShardedClock<>)->ThreadRange(1, ThreadsMax())->UseRealTime();
+
+// String value construction and copy: short strings are stored inline (no allocation, no refcount)
+static void BM_ValueString(benchmark::State& _state)
+{
+    std::string str((size_t)_state.range(0), 'a');
+    for (auto _ : _state) {
+        XValue val(str);
+        XValue val_copy = val;
+        benchmark::DoNotOptimize(val_copy);
+    }
+    _state.SetItemsProcessed(_state.iterations());
+}
+BENCHMARK(BM_ValueString)->ArgName("size")->Arg(4)->Arg(xnode::StringShort::kSizeMax)->Arg(64);
+
+// NOLINTEND(*)
@@ -1,3 +1,4 @@
+#include "xnode.h"
 #include "xkey/xkey.h"
 #include "xvalue/xvalue.h"
 #include "xobject_demo/xobject_demo.h"
@@ -37,5 +38,133 @@ TEST(xkey_tests, map_with_xkey)
     EXPECT_TRUE(mapTest[17].StringView().empty());
 }
 
+TEST(xkey_tests, interned_keys)
+{
+    // Key construction does not intern
+    XKey key("xkey_tests_interned");
+    EXPECT_TRUE(key.AtomGet().empty());
+    EXPECT_TRUE(xnode::StringAtom::Find("xkey_tests_interned").empty());
+    EXPECT_TRUE(xnode::StringAtom::Borrow("xkey_tests_interned").empty());
+
+    xnode::StringAtom atom("xkey_tests_interned");
+    EXPECT_EQ(atom, xnode::StringAtom::Find("xkey_tests_interned"));
+
+    XKey key_str(std::string("xkey_tests_interned"));
+    EXPECT_TRUE(key_str.AtomGet().empty());
+    EXPECT_EQ(key, key_str);
+
+    // Key from atom keeps the interned string
+    XKey key_atom(atom);
+    EXPECT_EQ(key_atom.AtomGet(), atom);
+    EXPECT_EQ(key_atom.StringGet()->data(), atom.str().data());
+    EXPECT_EQ(key, key_atom);
+
+    // Borrowed atoms are not counted, copy of borrowed atom is owning
+    {
+        auto count    = xnode::StringAtom::Count();
+        auto borrowed = xnode::StringAtom::Borrow("xkey_tests_interned");
+        EXPECT_TRUE(borrowed.borrowed());
+        EXPECT_EQ(borrowed, atom);
+        EXPECT_EQ(xnode::StringAtom::Borrow(atom), atom);
+
+        xnode::StringAtom copy(borrowed);
+        EXPECT_FALSE(copy.borrowed());
+        EXPECT_EQ(copy, atom);
+        EXPECT_EQ(xnode::StringAtom::Count(), count);
+    }
+    {
+        // Borrowed atom keeps the released string until destroyed, copy interns the string again
+        auto borrowed = xnode::StringAtom::Borrow(xnode::StringAtom("xkey_tests_borrowed"));
+        EXPECT_TRUE(xnode::StringAtom::Find("xkey_tests_borrowed").empty());
+        EXPECT_EQ(borrowed.view(), "xkey_tests_borrowed");
+
+        xnode::StringAtom copy(borrowed);
+        EXPECT_EQ(copy.view(), "xkey_tests_borrowed");
+        EXPECT_EQ(copy, xnode::StringAtom::Find("xkey_tests_borrowed"));
+    }
+    EXPECT_TRUE(xnode::StringAtom::Find("xkey_tests_borrowed").empty());
+
+    // Short strings are kept in key (w/o allocation), copies and moves refer own strings
+    for (const auto* str : {"xkey_short", "xkey_tests_long_key_string"}) {
+        XKey key_src(std::string {str});
+        XKey key_copy(key_src);
+        XKey key_assigned;
+        key_assigned = key_src;
+        EXPECT_EQ(key_copy.StringGet(), str);
+        EXPECT_EQ(key_assigned.StringGet(), str);
+
+        XKey key_moved(std::move(key_copy));
+        key_src = XKey();
+        EXPECT_EQ(key_moved.StringGet(), str);
+        EXPECT_EQ(key_assigned.StringGet(), str);
+
+        key_assigned = std::move(key_moved);
+        key_moved    = XKey("xkey_other");
+        EXPECT_EQ(key_assigned.StringGet(), str);
+    }
+
+    // Strings order
+    EXPECT_TRUE(xnode::StringAtom("abc") < xnode::StringAtom("abd"));
+    EXPECT_FALSE(xnode::StringAtom("abd") < xnode::StringAtom("abc"));
+    EXPECT_FALSE(xnode::StringAtom("abc") < xnode::StringAtom("abc"));
+
+    // Empty string -> empty atom
+    EXPECT_TRUE(XKey("").AtomGet().empty());
+    EXPECT_TRUE(XKey(1).AtomGet().empty());
+    EXPECT_EQ(XKey("").Type(), XKey::KeyType::String);
+
+    // Concurrent interning (with table growth)
+    constexpr size_t                            kThreads = 4;
+    constexpr size_t                            kNames   = 1000;
+    std::vector<std::thread>                    threads;
+    std::vector<std::vector<xnode::StringAtom>> atoms(kThreads);
+    auto                                        count_before = xnode::StringAtom::Count();
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&atoms, t]() {
+            for (size_t i = 0; i < kNames; ++i)
+                atoms[t].emplace_back("xkey_tests_name_" + std::to_string(i));
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(xnode::StringAtom::Count(), count_before + kNames);
+    for (size_t t = 1; t < kThreads; ++t)
+        EXPECT_EQ(atoms[t], atoms[0]);
+    for (size_t i = 0; i < kNames; ++i)
+        EXPECT_EQ(atoms[0][i].str(), "xkey_tests_name_" + std::to_string(i));
+
+    // Strings are removed with the last atom
+    atoms.clear();
+    EXPECT_EQ(xnode::StringAtom::Count(), count_before);
+    EXPECT_TRUE(xnode::StringAtom::Find("xkey_tests_name_0").empty());
+
+    // Concurrent interning and release of the same strings
+    threads.clear();
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([]() {
+            for (size_t n = 0; n < 20; ++n) {
+                for (size_t i = 0; i < kNames / 10; ++i) {
+                    xnode::StringAtom atom("xkey_tests_name_" + std::to_string(i));
+                    EXPECT_EQ(atom.str(), "xkey_tests_name_" + std::to_string(i));
+                    EXPECT_EQ(xnode::StringAtom::Find(atom.view()), atom);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(xnode::StringAtom::Count(), count_before);
+
+    // Keys of node are released with items (erased items are kept for patches until compaction)
+    auto map_sp = xnode::CreateMap();
+    for (size_t i = 0; i < kNames; ++i) {
+        map_sp->Set("xkey_tests_key_" + std::to_string(i), i);
+        map_sp->Erase("xkey_tests_key_" + std::to_string(i));
+    }
+    map_sp->ErasedCompact();
+    EXPECT_EQ(xnode::StringAtom::Count(), count_before);
+}
+
 
 // NOLINTEND(*)
\ No newline at end of file
@@ -0,0 +1,576 @@
+#include "xnode.h"
+#include "xnode_factory.h"
+#include "xnode_functions.h"
+#include "xnode_json.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace xsdk;
+
+// NOLINTBEGIN(*)
+
+static const MapLayout kMapLayouts[] = {MapLayout::Tree,
+                                        MapLayout::Hash,
+                                        MapLayout::HashOrdered,
+                                        MapLayout::Flat,
+                                        MapLayout::FlatHash};
+
+static INode::SPtr MapCreate(MapLayout _layout)
+{
+    INodeFactory::Options options;
+    options.map_layout = _layout;
+    return xnode::Create(INode::NodeType::Map, {}, 0, options);
+}
+
+TEST(xnode_layout_tests, map_basic)
+{
+    for (auto layout : kMapLayouts) {
+        auto node_map_sp = MapCreate(layout);
+
+        for (int i = 0; i < 100; ++i)
+            EXPECT_TRUE(node_map_sp->Set("key_" + std::to_string(i), i).first);
+
+        EXPECT_EQ(node_map_sp->Size(), 100);
+        EXPECT_EQ(node_map_sp->At("key_42"), 42);
+        EXPECT_FALSE(node_map_sp->At("key_100"));
+
+        // Same value -> not changed
+        EXPECT_FALSE(node_map_sp->Set("key_42", 42).first);
+        EXPECT_FALSE(node_map_sp->Insert("key_42", 43).succeeded);
+
+        for (int i = 0; i < 100; i += 2)
+            EXPECT_EQ(node_map_sp->Erase("key_" + std::to_string(i)), i);
+
+        EXPECT_EQ(node_map_sp->Size(), 50);
+        EXPECT_FALSE(node_map_sp->At("key_42"));
+        EXPECT_EQ(node_map_sp->At("key_43"), 43);
+
+        size_t counter = 0;
+        node_map_sp->ForEach([&](const XKey& key, XValueRT& val) {
+            EXPECT_EQ(key.StringGet().value(), "key_" + std::to_string(val.Int64()));
+            ++counter;
+            return OnEachRes::Next;
+        });
+        EXPECT_EQ(counter, 50);
+
+        // Erased items are still visible for ForPatch
+        counter = 0;
+        node_map_sp->ForPatch([&](const XKey&, const XValueRT&) {
+            ++counter;
+            return false;
+        });
+        EXPECT_EQ(counter, 100);
+
+        EXPECT_TRUE(node_map_sp->Set("key_42", 420).first);
+        EXPECT_EQ(node_map_sp->At("key_42"), 420);
+        EXPECT_EQ(node_map_sp->Size(), 51);
+
+        node_map_sp->Clear();
+        EXPECT_TRUE(node_map_sp->Empty());
+    }
+}
+
+TEST(xnode_layout_tests, map_hash_ordered_json)
+{
+    auto node_map_sp = MapCreate(MapLayout::HashOrdered);
+    node_map_sp->Set("z", 1);
+    node_map_sp->Set("b", 2);
+    node_map_sp->Set("x", 3);
+    node_map_sp->Set("a", 4);
+    node_map_sp->Erase("x");
+
+    EXPECT_EQ(xnode::ToJson(node_map_sp, nullptr, xnode::JsonFormat::kOneLine), R"({"z":1,"b":2,"a":4})");
+
+    // Factory default
+    auto options_prev  = XNodeFactoryGet()->OptionsDefaultGet();
+    auto options       = options_prev;
+    options.map_layout = MapLayout::HashOrdered;
+    XNodeFactoryGet()->OptionsDefaultSet(options);
+
+    std::string json             = R"({"z":1,"b":{"y":true,"c":false},"a":[1,2]})";
+    auto [node_json_sp, err_pos] = xnode::FromJson(json);
+    EXPECT_EQ(err_pos, 0);
+    EXPECT_EQ(xnode::ToJson(node_json_sp, nullptr, xnode::JsonFormat::kOneLine), json);
+
+    XNodeFactoryGet()->OptionsDefaultSet(options_prev);
+}
+
+TEST(xnode_layout_tests, map_flat_promote)
+{
+    for (auto layout : {MapLayout::Flat, MapLayout::FlatHash}) {
+        auto node_map_sp = MapCreate(layout);
+
+        // Flat: sorted as tree
+        node_map_sp->Set("c", 1);
+        node_map_sp->Set("a", 2);
+        node_map_sp->Set("b", 3);
+        EXPECT_EQ(xnode::ToJson(node_map_sp, nullptr, xnode::JsonFormat::kOneLine), R"({"a":2,"b":3,"c":1})");
+
+        // Promote (erased items are counted too)
+        node_map_sp->Erase("b");
+        for (int i = 0; i < 32; ++i)
+            node_map_sp->Set("key_" + std::to_string(i), i);
+
+        EXPECT_EQ(node_map_sp->Size(), 34);
+        EXPECT_EQ(node_map_sp->At("a"), 2);
+        EXPECT_FALSE(node_map_sp->At("b"));
+        EXPECT_EQ(node_map_sp->At("key_31"), 31);
+
+        size_t counter = 0;
+        node_map_sp->ForPatch([&](const XKey&, const XValueRT&) {
+            ++counter;
+            return false;
+        });
+        EXPECT_EQ(counter, 35);
+    }
+
+    // Default layout has the same order as tree
+    auto node_tree_sp = MapCreate(MapLayout::Tree);
+    auto node_flat_sp = xnode::Create(INode::NodeType::Map);
+    for (int i = 0; i < 40; ++i) {
+        node_tree_sp->Set("key_" + std::to_string((i * 7) % 40), i);
+        node_flat_sp->Set("key_" + std::to_string((i * 7) % 40), i);
+        EXPECT_EQ(xnode::ToJson(node_tree_sp), xnode::ToJson(node_flat_sp));
+    }
+}
+
+TEST(xnode_layout_tests, map_hash_random)
+{
+    for (auto layout : {MapLayout::Hash, MapLayout::HashOrdered, MapLayout::FlatHash}) {
+        auto node_map_sp = MapCreate(layout);
+
+        std::map<std::string, int64_t> reference;
+        std::mt19937                   rnd(12345);
+        for (int i = 0; i < 20000; ++i) {
+            auto key = "k" + std::to_string(rnd() % 1000);
+            if (rnd() % 3 == 0) {
+                EXPECT_EQ(node_map_sp->Erase(key).IsEmpty(), reference.erase(key) == 0);
+            }
+            else {
+                node_map_sp->Set(key, i);
+                reference[key] = i;
+            }
+        }
+
+        ASSERT_EQ(node_map_sp->Size(), reference.size());
+        for (const auto& [key, val] : reference)
+            EXPECT_EQ(node_map_sp->At(key), val);
+
+        // Erase all via ForEach
+        node_map_sp->ForEach([](auto&&...) { return OnEachRes::Erase; });
+        EXPECT_TRUE(node_map_sp->Empty());
+    }
+}
+
+TEST(xnode_layout_tests, map_index_access)
+{
+    for (auto layout : kMapLayouts) {
+        auto node_map_sp = MapCreate(layout);
+        EXPECT_TRUE(node_map_sp->At(kIdxLast).IsEmpty());
+
+        for (int i = 0; i < 100; ++i)
+            node_map_sp->Set("key_" + std::to_string(i), i);
+
+        // Index order is the enumeration order
+        std::vector<int64_t> values;
+        node_map_sp->ForEach([&](const XKey&, XValueRT& val) {
+            values.push_back(val.Int64());
+            return OnEachRes::Next;
+        });
+        ASSERT_EQ(values.size(), 100);
+        for (size_t i = 0; i < values.size(); ++i)
+            EXPECT_EQ(node_map_sp->At(i), values[i]);
+        EXPECT_EQ(node_map_sp->At(kIdxLast), values.back());
+        EXPECT_TRUE(node_map_sp->At(100).IsEmpty());
+
+        // Index is updated after keys changes (and not changed by values changes)
+        EXPECT_TRUE(node_map_sp->Set(0, -1).first);
+        EXPECT_EQ(node_map_sp->At(0), -1);
+        EXPECT_EQ(node_map_sp->At(1), values[1]);
+
+        auto erased = values.back();
+        EXPECT_EQ(node_map_sp->Erase(kIdxLast), erased);
+        EXPECT_EQ(node_map_sp->Size(), 99);
+        EXPECT_TRUE(node_map_sp->At(99).IsEmpty());
+        EXPECT_NE(node_map_sp->At(kIdxLast), erased);
+
+        node_map_sp->Set("key_" + std::to_string(erased), erased);
+        EXPECT_EQ(node_map_sp->Size(), 100);
+        EXPECT_EQ(node_map_sp->ErasedCompact(), 0);
+        for (size_t i = 1; i < values.size(); ++i)
+            EXPECT_FALSE(node_map_sp->At(i).IsEmpty());
+
+        // Index is kept by insertion and erasing of keys in any enumeration positions
+        auto pf_values = [&node_map_sp]() {
+            std::vector<int64_t> values_enum;
+            node_map_sp->ForEach([&](const XKey&, XValueRT& val) {
+                values_enum.push_back(val.Int64());
+                return OnEachRes::Next;
+            });
+            return values_enum;
+        };
+        for (int i = 0; i < 600; ++i) {
+            auto key = (i * 7919) % 300;
+            if (i % 3 == 2)
+                node_map_sp->Erase("key_" + std::to_string(key));
+            else
+                node_map_sp->Set("key_" + std::to_string(key), key);
+            if (i % 200 == 199)
+                node_map_sp->ErasedCompact();
+
+            auto values_enum = pf_values();
+            ASSERT_EQ(node_map_sp->Size(), values_enum.size());
+            for (size_t pos = i % 7; pos < values_enum.size(); pos += 7)
+                ASSERT_EQ(node_map_sp->At(pos), values_enum[pos]);
+        }
+
+        node_map_sp->Clear();
+        EXPECT_TRUE(node_map_sp->At(0).IsEmpty());
+    }
+}
+
+static size_t ForPatchCount(const INode::SPtr& _node_p)
+{
+    size_t counter = 0;
+    _node_p->ForPatch([&](const XKey&, const XValueRT&) {
+        ++counter;
+        return false;
+    });
+    return counter;
+}
+
+TEST(xnode_layout_tests, map_erased_compact)
+{
+    for (auto layout : kMapLayouts) {
+        // On demand
+        auto node_map_sp = MapCreate(layout);
+        for (int i = 0; i < 100; ++i)
+            node_map_sp->Set("key_" + std::to_string(i), i);
+        for (int i = 0; i < 100; i += 2)
+            node_map_sp->Erase("key_" + std::to_string(i));
+
+        // Recent erases are kept
+        EXPECT_EQ(node_map_sp->ErasedCompact(60'000), 0);
+        EXPECT_EQ(ForPatchCount(node_map_sp), 100);
+
+        EXPECT_EQ(node_map_sp->ErasedCompact(), 50);
+        EXPECT_EQ(ForPatchCount(node_map_sp), 50);
+        EXPECT_EQ(node_map_sp->Size(), 50);
+        EXPECT_EQ(node_map_sp->At("key_43"), 43);
+        EXPECT_FALSE(node_map_sp->At("key_42"));
+
+        // Erased key could be set again after compaction
+        EXPECT_TRUE(node_map_sp->Insert("key_42", 42).succeeded);
+        EXPECT_EQ(node_map_sp->Size(), 51);
+
+        // Auto compaction by ratio: keys churn do not grow map
+        INodeFactory::Options options;
+        options.map_layout       = layout;
+        options.erased_ratio_max = 1.0;
+        options.erased_keep_msec = 0;
+        auto node_churn_sp       = xnode::Create(INode::NodeType::Map, {}, 0, options);
+        for (int i = 0; i < 10'000; ++i) {
+            node_churn_sp->Set("session_" + std::to_string(i), i);
+            if (i >= 10)
+                node_churn_sp->Erase("session_" + std::to_string(i - 10));
+        }
+        EXPECT_EQ(node_churn_sp->Size(), 10);
+        EXPECT_LE(ForPatchCount(node_churn_sp), 64);
+        EXPECT_EQ(node_churn_sp->At("session_9999"), 9999);
+
+        // Auto compaction by ratio only
+        options.erased_keep_msec = -1;
+        auto node_ratio_sp       = xnode::Create(INode::NodeType::Map, {}, 0, options);
+        for (int i = 0; i < 1'000; ++i) {
+            node_ratio_sp->Set("session_" + std::to_string(i), i);
+            node_ratio_sp->Erase("session_" + std::to_string(i));
+        }
+        EXPECT_TRUE(node_ratio_sp->Empty());
+        EXPECT_LE(ForPatchCount(node_ratio_sp), 64);
+
+        // Auto compaction by age only
+        options.erased_ratio_max = 0;
+        options.erased_keep_msec = 0;
+        auto node_age_sp         = xnode::Create(INode::NodeType::Map, {}, 0, options);
+        for (int i = 0; i < 1'000; ++i) {
+            node_age_sp->Set("session_" + std::to_string(i), i);
+            node_age_sp->Erase("session_" + std::to_string(i));
+        }
+        EXPECT_LE(ForPatchCount(node_age_sp), 64);
+
+        // Auto compaction is disabled by default
+        options            = INodeFactory::Options();
+        options.map_layout = layout;
+        auto node_keep_sp  = xnode::Create(INode::NodeType::Map, {}, 0, options);
+        for (int i = 0; i < 1'000; ++i) {
+            node_keep_sp->Set("session_" + std::to_string(i), i);
+            node_keep_sp->Erase("session_" + std::to_string(i));
+        }
+        EXPECT_TRUE(node_keep_sp->Empty());
+        EXPECT_EQ(ForPatchCount(node_keep_sp), 1'000);
+    }
+
+    // Array: nothing to compact
+    EXPECT_EQ(xnode::Create(INode::NodeType::Array)->ErasedCompact(), 0);
+}
+
+TEST(xnode_layout_tests, array_basic)
+{
+    for (auto layout : {ArrayLayout::Vector, ArrayLayout::Deque}) {
+        INodeFactory::Options options;
+        options.array_layout = layout;
+        auto node_arr_sp     = xnode::Create(INode::NodeType::Array, {}, 0, options);
+
+        for (int i = 0; i < 100; ++i)
+            EXPECT_TRUE(node_arr_sp->Insert(kIdxEnd, i).succeeded);
+
+        EXPECT_EQ(node_arr_sp->Size(), 100);
+        EXPECT_EQ(node_arr_sp->At(42), 42);
+        EXPECT_EQ(node_arr_sp->At(kIdxLast), 99);
+        EXPECT_FALSE(node_arr_sp->At(100));
+
+        // Insert in the middle and at begin
+        EXPECT_TRUE(node_arr_sp->Insert(50, -50).succeeded);
+        EXPECT_TRUE(node_arr_sp->Insert(0, -1).succeeded);
+        EXPECT_EQ(node_arr_sp->At(0), -1);
+        EXPECT_EQ(node_arr_sp->At(51), -50);
+        EXPECT_EQ(node_arr_sp->At(52), 50);
+
+        EXPECT_EQ(node_arr_sp->Erase(51), -50);
+        EXPECT_EQ(node_arr_sp->Erase(0), -1);
+        EXPECT_EQ(node_arr_sp->Erase(kIdxLast), 99);
+        EXPECT_EQ(node_arr_sp->Size(), 99);
+
+        // Bulk append
+        std::vector<XValue> values;
+        for (int i = 99; i < 1000; ++i)
+            values.emplace_back(i);
+
+        auto [inserted, last_key] = node_arr_sp->BulkInsert(kIdxEnd, std::move(values));
+        EXPECT_EQ(inserted, 901);
+        EXPECT_EQ(last_key.IndexGet(), 999);
+        EXPECT_TRUE(values.empty());
+        EXPECT_EQ(node_arr_sp->Size(), 1000);
+
+        int64_t expected = 0;
+        node_arr_sp->ForEach([&](const XKey& key, XValueRT& val) {
+            EXPECT_EQ(key.IndexGet(), expected);
+            EXPECT_EQ(val, expected);
+            ++expected;
+            return OnEachRes::Next;
+        });
+        EXPECT_EQ(expected, 1000);
+
+        // Set with array growth
+        EXPECT_TRUE(node_arr_sp->Set(1001, "x").first);
+        EXPECT_EQ(node_arr_sp->Size(), 1002);
+        EXPECT_TRUE(node_arr_sp->At(1000).IsEmpty());
+    }
+}
+
+TEST(xnode_layout_tests, array_child_nodes)
+{
+    auto node_arr_sp = xnode::Create(INode::NodeType::Array);
+
+    std::vector<INode::SPtr> childs;
+    for (int i = 0; i < 1000; ++i) {
+        childs.push_back(xnode::Create(INode::NodeType::Map));
+        EXPECT_TRUE(node_arr_sp->Insert(kIdxEnd, childs.back()).succeeded);
+    }
+
+    // Duplicates
+    auto res = node_arr_sp->Insert(kIdxEnd, childs[500]);
+    EXPECT_FALSE(res.succeeded);
+    EXPECT_EQ(res.inserted_at.IndexGet(), 500);
+
+    // Set existed child to other place -> moved
+    EXPECT_TRUE(node_arr_sp->Set(0, childs[999]).first);
+    EXPECT_EQ(node_arr_sp->Size(), 999);
+    EXPECT_EQ(node_arr_sp->At(0), childs[999]);
+    EXPECT_EQ(node_arr_sp->At(kIdxLast), childs[998]);
+    EXPECT_FALSE(childs[0]->ParentGet());
+
+    // Erased child could be inserted again
+    EXPECT_EQ(node_arr_sp->Erase(1), childs[1]);
+    EXPECT_TRUE(node_arr_sp->Insert(kIdxEnd, childs[1]).succeeded);
+    EXPECT_TRUE(node_arr_sp->Insert(kIdxEnd, childs[0]).succeeded);
+    EXPECT_EQ(node_arr_sp->Size(), 1000);
+
+    // Not nodes values are not checked for duplicates
+    EXPECT_TRUE(node_arr_sp->Insert(kIdxEnd, nullptr).succeeded);
+    auto [inserted, last_key] = node_arr_sp->BulkInsert(kIdxEnd, {XValue(nullptr), XValue(1), XValue(1)});
+    EXPECT_EQ(inserted, 3);
+    EXPECT_EQ(node_arr_sp->Size(), 1004);
+
+    node_arr_sp->Clear();
+    EXPECT_TRUE(node_arr_sp->Insert(kIdxEnd, childs[500]).succeeded);
+}
+
+TEST(xnode_layout_tests, bulk_failed_kept)
+{
+    auto node_map_sp = xnode::Create(INode::NodeType::Map);
+    node_map_sp->Insert("b", 1);
+
+    std::vector<std::pair<XKey, XValue>> values = {{"a", 1}, {"b", 2}, {"c", 3}, {"b", 4}, {"d", 5}};
+    EXPECT_EQ(node_map_sp->BulkInsert(std::move(values)), 3);
+    // Failed items are kept (in order) with existed values
+    ASSERT_EQ(values.size(), 2);
+    EXPECT_EQ(values[0].first.StringGet(), "b");
+    EXPECT_EQ(values[0].second, 1);
+    EXPECT_EQ(values[1].first.StringGet(), "b");
+    EXPECT_EQ(values[1].second, 1);
+    EXPECT_EQ(node_map_sp->Size(), 4);
+}
+
+TEST(xnode_layout_tests, values_untimed)
+{
+    for (auto layout : kMapLayouts) {
+        INodeFactory::Options options;
+        options.map_layout   = layout;
+        options.values_timed = false;
+        auto node_map_sp     = xnode::Create(INode::NodeType::Map, {}, 0, options);
+
+        for (int i = 0; i < 100; ++i)
+            EXPECT_TRUE(node_map_sp->Set("key_" + std::to_string(i), i).first);
+        EXPECT_TRUE(node_map_sp->Insert("child", xnode::Create(INode::NodeType::Array, {}, 0, options)).succeeded);
+
+        EXPECT_EQ(node_map_sp->Size(), 101);
+        EXPECT_EQ(node_map_sp->At("key_42"), 42);
+        EXPECT_FALSE(node_map_sp->Set("key_42", 42).first);
+
+        // Common node timestamp: taken on read after change
+        auto val_42 = node_map_sp->At("key_42");
+        EXPECT_FALSE(val_42.TimeIsAbsent());
+        EXPECT_EQ(node_map_sp->At("key_0").Timestamp(), val_42.Timestamp());
+
+        EXPECT_EQ(node_map_sp->Set("key_0", 1000).second, 0);
+        auto val_0 = node_map_sp->At("key_0");
+        EXPECT_GT(val_0.Timestamp(), val_42.Timestamp());
+        EXPECT_EQ(node_map_sp->At("key_42").Timestamp(), val_0.Timestamp());
+
+        // Erase detection
+        for (int i = 0; i < 100; i += 2)
+            EXPECT_EQ(node_map_sp->Erase("key_" + std::to_string(i)), i == 0 ? 1000 : i);
+
+        EXPECT_EQ(node_map_sp->Size(), 51);
+        EXPECT_FALSE(node_map_sp->At("key_42"));
+        EXPECT_EQ(ForPatchCount(node_map_sp), 101);
+        EXPECT_EQ(node_map_sp->ErasedCompact(), 50);
+        EXPECT_EQ(node_map_sp->Size(), 51);
+
+        auto [node_parsed_sp, err_pos] = xnode::FromJson(xnode::ToJson(node_map_sp));
+        ASSERT_TRUE(node_parsed_sp);
+        EXPECT_EQ(node_parsed_sp->Size(), 51);
+        EXPECT_EQ(node_parsed_sp->At("key_43"), 43);
+    }
+
+    // Compaction by erase time (not by common timestamp, which is taken lazily after last change)
+    for (auto layout : kMapLayouts) {
+        INodeFactory::Options options;
+        options.map_layout   = layout;
+        options.values_timed = false;
+        auto node_map_sp     = xnode::Create(INode::NodeType::Map, {}, 0, options);
+        for (int i = 0; i < 10; ++i)
+            node_map_sp->Set("key_" + std::to_string(i), i);
+        node_map_sp->Erase("key_1");
+        node_map_sp->Erase("key_2");
+        EXPECT_EQ(node_map_sp->ErasedCompact(60'000), 0);
+        EXPECT_EQ(node_map_sp->ErasedCompact(), 2);
+        EXPECT_EQ(ForPatchCount(node_map_sp), 8);
+
+        // Erased and set again: not compacted
+        node_map_sp->Erase("key_3");
+        node_map_sp->Set("key_3", 3);
+        node_map_sp->Erase("key_4");
+        EXPECT_EQ(node_map_sp->ErasedCompact(), 1);
+        EXPECT_EQ(node_map_sp->At("key_3"), 3);
+        EXPECT_EQ(ForPatchCount(node_map_sp), 7);
+
+        // Auto compaction by age
+        options.erased_keep_msec = 0;
+        auto node_churn_sp       = xnode::Create(INode::NodeType::Map, {}, 0, options);
+        for (int i = 0; i < 1'000; ++i) {
+            node_churn_sp->Set("session_" + std::to_string(i), i);
+            node_churn_sp->Erase("session_" + std::to_string(i));
+        }
+        EXPECT_LE(ForPatchCount(node_churn_sp), 64);
+    }
+
+    for (auto layout : {ArrayLayout::Vector, ArrayLayout::Deque}) {
+        INodeFactory::Options options;
+        options.array_layout = layout;
+        options.values_timed = false;
+        auto node_arr_sp     = xnode::Create(INode::NodeType::Array, {}, 0, options);
+
+        std::vector<XValue> values;
+        for (int i = 0; i < 100; ++i)
+            values.emplace_back(i);
+        EXPECT_EQ(node_arr_sp->BulkInsert(XKey(kIdxEnd), std::move(values)).first, 100);
+
+        auto val_10 = node_arr_sp->At(size_t(10));
+        EXPECT_EQ(val_10, 10);
+        EXPECT_FALSE(val_10.TimeIsAbsent());
+
+        EXPECT_EQ(node_arr_sp->Erase(size_t(0)), 0);
+        EXPECT_EQ(node_arr_sp->Size(), 99);
+        EXPECT_EQ(node_arr_sp->At(size_t(10)), 11);
+        EXPECT_GT(node_arr_sp->At(size_t(10)).Timestamp(), val_10.Timestamp());
+    }
+}
+
+TEST(xnode_layout_tests, timestamps_ordered)
+{
+    // Each change of node has greater timestamp than previous changes (including erased items)
+    for (auto layout : kMapLayouts) {
+        auto    node_map_sp = MapCreate(layout);
+        int64_t prev        = kAbsentRT;
+        for (int i = 0; i < 100; ++i) {
+            auto key = "key_" + std::to_string(i % 10);
+            if (i % 3 == 2)
+                node_map_sp->Erase(key);
+            else
+                node_map_sp->Set(key, i);
+
+            auto val = node_map_sp->At(key);
+            if (val.TimeIsAbsent())
+                continue;
+
+            EXPECT_GT(val.Timestamp(), prev);
+            prev = val.Timestamp();
+        }
+    }
+}
+
+TEST(xnode_layout_tests, map_lookup_not_interned)
+{
+    for (auto layout : kMapLayouts) {
+        auto node_map_sp = MapCreate(layout);
+        auto layout_name = "layout_key_" + std::to_string((int)layout);
+        for (int i = 0; i < 20; ++i)
+            EXPECT_TRUE(node_map_sp->Set("key_" + std::to_string(i), i).first);
+
+        // Lookups by unknown key: not found and key is not interned
+        XKey key(layout_name);
+        EXPECT_FALSE(node_map_sp->At(key));
+        EXPECT_FALSE(node_map_sp->Erase(key));
+        EXPECT_TRUE(node_map_sp->BulkGet({key}).empty());
+        EXPECT_TRUE(node_map_sp->IsKeyValid(false, key));
+        EXPECT_TRUE(node_map_sp->IsKeyValid(true, key));
+        EXPECT_TRUE(xnode::StringAtom::Find(layout_name).empty());
+
+        // Interned on insert, key made before insert is still usable
+        EXPECT_TRUE(node_map_sp->Set(key, 42).first);
+        EXPECT_FALSE(xnode::StringAtom::Find(layout_name).empty());
+        EXPECT_TRUE(key.AtomGet().empty());
+        EXPECT_TRUE(node_map_sp->IsKeyValid(false, key));
+        EXPECT_EQ(node_map_sp->At(key), 42);
+        EXPECT_EQ(node_map_sp->At(layout_name), 42);
+        EXPECT_EQ(node_map_sp->Erase(key), 42);
+        EXPECT_FALSE(node_map_sp->At(layout_name));
+    }
+}
+
+// NOLINTEND(*)
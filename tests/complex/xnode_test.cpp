@@ -9,6 +9,9 @@
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
 #include <thread>
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -305,6 +308,463 @@ TEST(xnode_tests, path_node_tests)
     EXPECT_TRUE(xnode::At(node_map_sp, "node2::subnode::next::node::value").IsEmpty());
 }
 
+TEST(xnode_tests, compiled_path)
+{
+    auto node_map_sp = xnode::Create(INode::NodeType::Map);
+
+    xnode::CompiledPath path("node1::subnode::next::value");
+    EXPECT_EQ(path.Path().size(), 4);
+    EXPECT_TRUE(path.At(node_map_sp).IsEmpty());
+    EXPECT_FALSE(path.NodeGet(node_map_sp));
+
+    // Missed nodes are created
+    auto [success, val] = path.Set(node_map_sp, 123);
+    EXPECT_TRUE(success);
+    EXPECT_EQ(path.At(node_map_sp), 123);
+    EXPECT_EQ(xnode::At(node_map_sp, "node1::subnode::next::value"), 123);
+
+    // Scalar changes do not affect generation
+    auto next_sp    = xnode::NodeGet(node_map_sp, "node1::subnode::next");
+    auto generation = next_sp->Generation();
+    next_sp->Set("value", 456);
+    EXPECT_EQ(next_sp->Generation(), generation);
+    EXPECT_EQ(path.At(node_map_sp), 456);
+    next_sp->Set("value2", 1);
+    EXPECT_NE(next_sp->Generation(), generation);
+
+    // Replaced intermediate node
+    auto subnode_sp = xnode::NodeGet(node_map_sp, "node1::subnode");
+    auto next_new   = xnode::CreateMap({{"value", 789}});
+    subnode_sp->Set("next", next_new);
+    EXPECT_EQ(path.At(node_map_sp), 789);
+    EXPECT_EQ(path.NodeGet(node_map_sp), nullptr);
+    EXPECT_EQ(xnode::CompiledPath("node1::subnode::next").NodeGet(node_map_sp), next_new);
+
+    // Erased and re-created intermediate node
+    xnode::Erase(node_map_sp, "node1::subnode");
+    EXPECT_TRUE(path.At(node_map_sp).IsEmpty());
+    xnode::Set(node_map_sp, "node1::subnode::next::value", 1000);
+    EXPECT_EQ(path.At(node_map_sp), 1000);
+
+    // Cleared node
+    xnode::NodeGet(node_map_sp, "node1")->Clear();
+    EXPECT_TRUE(path.At(node_map_sp).IsEmpty());
+
+    // Another root
+    auto node_map2_sp = xnode::Create(INode::NodeType::Map);
+    xnode::Set(node_map2_sp, "node1::subnode::next::value", 2000);
+    xnode::Set(node_map_sp, "node1::subnode::next::value", 3000);
+    EXPECT_EQ(path.At(node_map2_sp), 2000);
+    EXPECT_EQ(path.At(node_map_sp), 3000);
+
+    // Arrays and erase
+    xnode::CompiledPath path_array("array[1]::value");
+    xnode::Set(node_map_sp, "array[0]::value", 1);
+    xnode::Set(node_map_sp, "array[1]::value", 2);
+    EXPECT_EQ(path_array.At(node_map_sp), 2);
+    xnode::Erase(node_map_sp, "array[0]");
+    EXPECT_TRUE(path_array.At(node_map_sp).IsEmpty());
+    EXPECT_EQ(xnode::CompiledPath("array[0]::value").Erase(node_map_sp), 2);
+}
+
+TEST(xnode_tests, transaction)
+{
+    auto root_sp = xnode::CreateMap({{"a", 1}});
+    xnode::Set(root_sp, "child::b", 2);
+    xnode::Set(root_sp, "child::node::c", 3);
+
+    // Changes of each node are passed to callbacks together
+    std::vector<std::pair<std::string, XKey>> changes;
+    std::vector<XKey>                         rollbacks;
+    auto pf_on_change = [&](std::string _node) -> INode::OnChangePF {
+        return [&, _node](INode::CallbackReason _reason, const INode::SPtrC&, const XKey& _key, const XValueRT&,
+                          const XValueRT& _to) -> std::optional<bool> {
+            if (_reason == INode::CallbackReason::Rollback) {
+                rollbacks.push_back(_key);
+                return true;
+            }
+            changes.emplace_back(_node, _key);
+            return _to != XValue("veto");
+        };
+    };
+    auto child_sp = xnode::NodeGet(root_sp, "child");
+    root_sp->OnChangeAdd(pf_on_change("root"));
+    child_sp->OnChangeAdd(pf_on_change("child"));
+
+    xnode::Transaction transaction(root_sp);
+    EXPECT_FALSE(transaction.Set(XPath(), 1));
+    EXPECT_FALSE(transaction.Set("child::x", xnode::CreateMap()));
+    EXPECT_TRUE(transaction.Set("a", 10));
+    EXPECT_TRUE(transaction.Set("child::b", 20));
+    EXPECT_TRUE(transaction.Set("a", 11)); // Coalesced
+    EXPECT_TRUE(transaction.Set("child::new", "str"));
+    EXPECT_TRUE(transaction.Set("new_child::d", 4)); // Missed node is created
+    EXPECT_TRUE(transaction.Erase("child::node"));
+    EXPECT_TRUE(transaction.Erase("missed::e"));
+    EXPECT_EQ(transaction.Size(), 7);
+
+    auto node_sp = xnode::NodeGet(root_sp, "child::node");
+    EXPECT_TRUE(transaction.Commit());
+    EXPECT_EQ(transaction.Size(), 0);
+    EXPECT_EQ(root_sp->At("a"), 11);
+    EXPECT_EQ(xnode::At(root_sp, "child::b"), 20);
+    EXPECT_EQ(xnode::At(root_sp, "child::new"), "str");
+    EXPECT_EQ(xnode::At(root_sp, "new_child::d"), 4);
+    EXPECT_TRUE(xnode::At(root_sp, "child::node").IsEmpty());
+    EXPECT_TRUE(xnode::At(root_sp, "missed").IsEmpty());
+    EXPECT_FALSE(node_sp->ParentGet());
+    EXPECT_TRUE(rollbacks.empty());
+
+    // Missed node is created (change of root) before locks, then changes of each node are passed together
+    auto it_child = std::find_if(changes.begin(), changes.end(), [](const auto& _change) {
+        return _change.first == "child";
+    });
+    ASSERT_NE(it_child, changes.end());
+    EXPECT_EQ(std::count(changes.begin(), changes.end(), std::make_pair(std::string("root"), XKey("a"))), 1);
+    EXPECT_EQ(std::count_if(it_child, changes.end(), [](const auto& _change) { return _change.first == "child"; }),
+              3);
+
+    // Vetoed change aborts transaction: applied changes of other nodes are reverted
+    auto a_prev = root_sp->At("a");
+    changes.clear();
+    transaction.Set("a", 100);
+    transaction.Set("child::b", 200);
+    transaction.Set("child::vetoed", "veto");
+    transaction.Set("created::sub::c", 1);
+    transaction.Set("child::created::d", 1);
+    EXPECT_FALSE(transaction.Commit());
+    EXPECT_EQ(root_sp->At("a"), a_prev);
+    EXPECT_EQ(root_sp->At("a").Timestamp(), a_prev.Timestamp());
+    EXPECT_EQ(xnode::At(root_sp, "child::b"), 20);
+    EXPECT_TRUE(xnode::At(root_sp, "child::vetoed").IsEmpty());
+    // Created intermediate nodes are removed
+    EXPECT_TRUE(root_sp->At("created").IsEmpty());
+    EXPECT_TRUE(xnode::At(root_sp, "child::created").IsEmpty());
+    // Nodes are changed in order of addresses: change of root is reverted only if it was applied before veto
+    auto root_applied = std::count(changes.begin(), changes.end(), std::make_pair(std::string("root"), XKey("a")));
+    EXPECT_EQ(std::count(rollbacks.begin(), rollbacks.end(), XKey("a")), root_applied);
+    EXPECT_EQ(std::count(rollbacks.begin(), rollbacks.end(), XKey("b")), 1);
+
+    // Failed resolution of path
+    root_sp->Set("scalar", 1);
+    transaction.Set("a", 100);
+    transaction.Set("new_child::created::e", 1);
+    transaction.Set("scalar::value", 1);
+    EXPECT_FALSE(transaction.Commit());
+    EXPECT_EQ(root_sp->At("a"), a_prev);
+    EXPECT_TRUE(xnode::At(root_sp, "new_child::created").IsEmpty());
+    EXPECT_EQ(xnode::At(root_sp, "new_child::d"), 4);
+}
+
+TEST(xnode_tests, transaction_abort_array)
+{
+    auto root_sp = xnode::CreateMap({{"arr", xnode::CreateArray({0, 1, 2, 3, 4})}, {"map", xnode::CreateMap()}});
+    auto arr_sp  = root_sp->At("arr").QueryPtr<INode>();
+    auto map_sp  = root_sp->At("map").QueryPtr<INode>();
+    auto pf_veto = [](INode::CallbackReason, const INode::SPtrC&, const XKey&, const XValueRT&,
+                      const XValueRT& _to) -> std::optional<bool> { return _to != XValue("veto"); };
+    arr_sp->OnChangeAdd(pf_veto);
+    map_sp->OnChangeAdd(pf_veto);
+
+    std::vector<XValueRT> items_prev;
+    arr_sp->Visit([&](const XKey&, const XValueRT& _val) {
+        items_prev.push_back(_val);
+        return false;
+    });
+
+    // Changes of array are applied in order and reverted in reverse order: erased items are inserted back,
+    // increased array is truncated
+    xnode::Transaction transaction(root_sp);
+    transaction.Erase("arr[1]");
+    transaction.Set("arr[1]", 20);
+    transaction.Erase("arr[3]");
+    transaction.Set("arr[5]", 5);
+    transaction.Set("arr[0]", "veto");
+    EXPECT_FALSE(transaction.Commit());
+    ASSERT_EQ(arr_sp->Size(), items_prev.size());
+    for (size_t i = 0; i < items_prev.size(); ++i) {
+        EXPECT_EQ(arr_sp->At(i), items_prev[i]);
+        EXPECT_EQ(arr_sp->At(i).Timestamp(), items_prev[i].Timestamp());
+    }
+
+    // Batch callbacks get previous values of changed items
+    std::vector<XValue> batch_from;
+    arr_sp->OnChangeBatchAdd([&](INode::CallbackReason, const INode::SPtrC&,
+                                 const std::vector<INode::Change>& _changes) -> std::optional<bool> {
+        for (const auto& change : _changes)
+            batch_from.push_back(change.from);
+        return true;
+    });
+    transaction.Erase("arr[1]");
+    transaction.Set("arr[1]", 20);
+    transaction.Erase("arr[3]");
+    transaction.Set("arr[5]", 5);
+    EXPECT_TRUE(transaction.Commit());
+    EXPECT_EQ(batch_from, std::vector<XValue>({1, 2, 4, XValue()}));
+    EXPECT_EQ(xnode::ToJson(arr_sp, nullptr, xnode::JsonFormat::kOneLine), "[0,20,3,null,null,5]");
+
+    // Reverted new key of map is removed w/o erased item
+    map_sp->Set("a", 1);
+    transaction.Set("map::b", 2);
+    transaction.Set("map::a", "veto");
+    EXPECT_FALSE(transaction.Commit());
+    EXPECT_TRUE(map_sp->At("b").IsEmpty());
+    size_t patch_count = 0;
+    map_sp->ForPatch([&](const XKey&, const XValueRT&) {
+        ++patch_count;
+        return false;
+    });
+    EXPECT_EQ(patch_count, 1);
+}
+
+TEST(xnode_tests, batch_callbacks)
+{
+    auto map_sp = xnode::CreateMap({{"a", 1}, {"b", 2}});
+
+    std::vector<std::vector<INode::Change>> batches;
+    std::vector<std::vector<INode::Change>> rollbacks;
+    size_t                                  changes = 0;
+    map_sp->OnChangeAdd([&](INode::CallbackReason _reason, const INode::SPtrC&, const XKey&, const XValueRT&,
+                            const XValueRT&) -> std::optional<bool> {
+        if (_reason != INode::CallbackReason::Rollback)
+            ++changes;
+        return true;
+    });
+    map_sp->OnChangeBatchAdd([&](INode::CallbackReason _reason, const INode::SPtrC&,
+                                 const std::vector<INode::Change>& _changes) -> std::optional<bool> {
+        if (_reason == INode::CallbackReason::Rollback) {
+            rollbacks.push_back(_changes);
+            return true;
+        }
+        batches.push_back(_changes);
+        return std::none_of(_changes.begin(), _changes.end(), [](const auto& _change) {
+            return _change.to == XValue("veto");
+        });
+    });
+
+    // Bulk operation: one batch, per-key callbacks still called
+    EXPECT_EQ(map_sp->BulkSet({{"a", 10}, {"c", 3}}), 2);
+    ASSERT_EQ(batches.size(), 1);
+    ASSERT_EQ(batches[0].size(), 2);
+    EXPECT_EQ(batches[0][0].key, XKey("a"));
+    EXPECT_EQ(batches[0][0].from, 1);
+    EXPECT_EQ(batches[0][0].to, 10);
+    EXPECT_EQ(batches[0][1].key, XKey("c"));
+    EXPECT_TRUE(batches[0][1].from.IsEmpty());
+    EXPECT_EQ(changes, 2);
+
+    // Vetoed as a whole
+    EXPECT_EQ(map_sp->BulkSet({{"a", 100}, {"d", "veto"}}), 0);
+    EXPECT_EQ(map_sp->At("a"), 10);
+    EXPECT_TRUE(map_sp->At("d").IsEmpty());
+    EXPECT_EQ(batches.size(), 2);
+    EXPECT_EQ(changes, 2);
+
+    // Single change: batch of one, veto of batch cancels change (per-key callbacks are rolled back)
+    batches.clear();
+    EXPECT_TRUE(map_sp->Set("b", 20).first);
+    ASSERT_EQ(batches.size(), 1);
+    ASSERT_EQ(batches[0].size(), 1);
+    EXPECT_EQ(batches[0][0].from, 2);
+    EXPECT_FALSE(map_sp->Set("b", "veto").first);
+    EXPECT_EQ(map_sp->At("b"), 20);
+
+    // Approved but not applied changes (existed keys for insert) are passed as rollback
+    batches.clear();
+    rollbacks.clear();
+    EXPECT_EQ(map_sp->BulkInsert({{"a", 5}, {"e", 5}}), 1);
+    ASSERT_EQ(batches.size(), 1);
+    EXPECT_EQ(batches[0].size(), 2);
+    ASSERT_EQ(rollbacks.size(), 1);
+    ASSERT_EQ(rollbacks[0].size(), 1);
+    EXPECT_EQ(rollbacks[0][0].key, XKey("a"));
+    EXPECT_EQ(rollbacks[0][0].from, 5);
+    EXPECT_EQ(rollbacks[0][0].to, 10);
+
+    // Array insert: keys are positions
+    auto arr_sp   = xnode::CreateArray({1, 2});
+    auto arr_keys = std::vector<XKey>();
+    arr_sp->OnChangeBatchAdd([&](INode::CallbackReason, const INode::SPtrC&,
+                                 const std::vector<INode::Change>& _changes) -> std::optional<bool> {
+        for (const auto& change : _changes)
+            arr_keys.push_back(change.key);
+        return true;
+    });
+    EXPECT_EQ(arr_sp->BulkInsert(XKey(1), {10, 11}).first, 2);
+    EXPECT_EQ(arr_keys, std::vector<XKey>({XKey(1), XKey(2)}));
+    EXPECT_EQ(arr_sp->At(2), 11);
+
+    // Transaction: one batch per node, vetoed batch aborts transaction
+    auto child_sp = xnode::NodeGet(map_sp, "child");
+    batches.clear();
+    rollbacks.clear();
+    xnode::Transaction transaction(map_sp);
+    transaction.Set("a", 11);
+    transaction.Set("b", 21);
+    transaction.Set("child::x", 1);
+    EXPECT_TRUE(transaction.Commit());
+    ASSERT_EQ(batches.size(), 1);
+    EXPECT_EQ(batches[0].size(), 2);
+
+    batches.clear();
+    transaction.Set("a", 12);
+    transaction.Set("f", "veto");
+    EXPECT_FALSE(transaction.Commit());
+    EXPECT_EQ(map_sp->At("a"), 11);
+    EXPECT_TRUE(rollbacks.empty());
+
+    // Removed with other callbacks
+    EXPECT_GT(map_sp->OnChangeReset(), 0);
+    batches.clear();
+    EXPECT_TRUE(map_sp->Set("a", 0).first);
+    EXPECT_TRUE(batches.empty());
+}
+
+TEST(xnode_tests, keys_filtered_callbacks)
+{
+    auto map_sp = xnode::CreateMap();
+
+    // Callbacks of keys and prefixes are called in order of registration with other callbacks
+    std::vector<std::string> calls;
+    auto pf_on_change = [&](std::string _name) -> INode::OnChangePF {
+        return [&, _name](INode::CallbackReason _reason, const INode::SPtrC&, const XKey& _key, const XValueRT&,
+                          const XValueRT& _to) -> std::optional<bool> {
+            calls.push_back(_name + (_reason == INode::CallbackReason::Rollback ? ":rollback" : ""));
+            if (_name == "once")
+                return std::nullopt;
+            return _name != "ab*" || _to != XValue("veto");
+        };
+    };
+    EXPECT_EQ(map_sp->OnChangeKeysAdd(pf_on_change("empty"), {}), 0);
+    map_sp->OnChangeKeysAdd(pf_on_change("a"), {{"a"}, {}});
+    map_sp->OnChangeAdd(pf_on_change("all"));
+    auto id_prefix = map_sp->OnChangeKeysAdd(pf_on_change("ab*"), {{}, {"ab"}});
+    map_sp->OnChangeKeysAdd(pf_on_change("a|abc|x*"), {{"a", "abc"}, {"x", "abc"}});
+    map_sp->OnChangeKeysAdd(pf_on_change("once"), {{"once"}, {}});
+
+    map_sp->Set("a", 1);
+    EXPECT_EQ(calls, std::vector<std::string>({"a", "all", "a|abc|x*"}));
+
+    calls.clear();
+    map_sp->Set("abc", 1);
+    EXPECT_EQ(calls, std::vector<std::string>({"all", "ab*", "a|abc|x*"}));
+
+    calls.clear();
+    map_sp->Set("b", 1);
+    map_sp->Set("xyz", 1);
+    EXPECT_EQ(calls, std::vector<std::string>({"all", "all", "a|abc|x*"}));
+
+    // Veto: rollback of called before vetoed
+    calls.clear();
+    EXPECT_FALSE(map_sp->Set("ab", "veto").first);
+    EXPECT_EQ(calls, std::vector<std::string>({"all", "ab*", "all:rollback"}));
+
+    // Removed and expired callbacks are removed from index
+    calls.clear();
+    EXPECT_TRUE(map_sp->OnChangeRemove(id_prefix));
+    map_sp->Set("abc", 2);
+    map_sp->Set("once", 1);
+    map_sp->Set("once", 2);
+    EXPECT_EQ(calls, std::vector<std::string>({"all", "a|abc|x*", "all", "once", "all"}));
+
+    // Array: keys are indexes
+    auto arr_sp = xnode::CreateArray({0, 0, 0});
+    calls.clear();
+    arr_sp->OnChangeKeysAdd(pf_on_change("1"), {{1}, {}});
+    arr_sp->Set(0, 1);
+    arr_sp->Set(1, 1);
+    EXPECT_EQ(calls, std::vector<std::string>({"1"}));
+
+    EXPECT_EQ(map_sp->OnChangeReset(), 3);
+    calls.clear();
+    map_sp->Set("a", 2);
+    EXPECT_TRUE(calls.empty());
+}
+
+TEST(xnode_tests, subtree_callbacks)
+{
+    auto root_sp = xnode::CreateMap({{"a", 1}});
+    xnode::Set(root_sp, "child::b", 1);
+    xnode::Set(root_sp, "child::arr", xnode::CreateArray({0, 0}));
+    auto child_sp = xnode::NodeGet(root_sp, "child");
+    auto arr_sp   = xnode::NodeGet(root_sp, "child::arr");
+    child_sp->OnChangeAdd([](INode::CallbackReason, const INode::SPtrC&, const XKey&, const XValueRT&,
+                             const XValueRT& _to) -> std::optional<bool> { return _to != XValue("veto"); });
+
+    // Paths are relative to subscribed node, callbacks are called w/o locks (could read the tree)
+    std::vector<std::string> calls;
+    auto pf_on_change = [&](std::string _name) -> INode::OnSubtreeChangePF {
+        return [&, _name](INode::CallbackReason _reason, const INode::SPtrC& _node, const XPath& _path,
+                          const XValueRT&, const XValueRT& _to) -> std::optional<bool> {
+            EXPECT_EQ(_node->At(_path.back()).ObjectPtrC(), _to.ObjectPtrC());
+            EXPECT_GE(root_sp->Size(), 1);
+            calls.push_back(_name + ":" + _path.to_string() +
+                            (_reason == INode::CallbackReason::Rollback ? ":rollback" : ""));
+            if (_name == "once")
+                return std::nullopt;
+            return true;
+        };
+    };
+    auto id_root = root_sp->OnChangeSubtreeAdd(pf_on_change("root"));
+    child_sp->OnChangeSubtreeAdd(pf_on_change("child"));
+
+    root_sp->Set("a", 2);
+    xnode::Set(root_sp, "child::b", 2);
+    arr_sp->Set(1, 2);
+    EXPECT_EQ(calls, std::vector<std::string>({"root:a", "child:b", "root:child::b", "child:arr[1]",
+                                               "root:child::arr[1]"}));
+
+    // Added nodes are watched
+    calls.clear();
+    xnode::Set(root_sp, "child::new::c", 1);
+    EXPECT_EQ(calls, std::vector<std::string>({"child:new", "root:child::new", "child:new::c",
+                                               "root:child::new::c"}));
+
+    // Index of node in array is found by values index (including shifted by inserts before the node)
+    auto item_sp = xnode::CreateMap();
+    EXPECT_TRUE(arr_sp->Insert(2, item_sp).succeeded);
+    calls.clear();
+    item_sp->Set("x", 1);
+    EXPECT_TRUE(arr_sp->Insert(0, -1).succeeded);
+    EXPECT_TRUE(arr_sp->Insert(0, -2).succeeded);
+    item_sp->Set("x", 2);
+    EXPECT_FALSE(arr_sp->Erase(0).IsEmpty());
+    item_sp->Set("x", 3);
+    EXPECT_EQ(calls, std::vector<std::string>({"child:arr[2]::x", "root:child::arr[2]::x", "child:arr[0]",
+                                               "root:child::arr[0]", "child:arr[0]", "root:child::arr[0]",
+                                               "child:arr[4]::x", "root:child::arr[4]::x", "child:arr[0]",
+                                               "root:child::arr[0]", "child:arr[3]::x", "root:child::arr[3]::x"}));
+
+    // Vetoed changes: reverted ones are passed as rollback (changes of node are passed together)
+    calls.clear();
+    xnode::Transaction transaction(root_sp);
+    transaction.Set("child::b", 3);
+    transaction.Set("child::c", "veto");
+    EXPECT_FALSE(transaction.Commit());
+    EXPECT_EQ(calls, std::vector<std::string>({"child:b", "child:b:rollback", "root:child::b",
+                                               "root:child::b:rollback"}));
+
+    // Removed and expired callbacks
+    calls.clear();
+    arr_sp->OnChangeSubtreeAdd(pf_on_change("once"));
+    EXPECT_TRUE(root_sp->OnChangeRemove(id_root));
+    arr_sp->Set(0, 1);
+    arr_sp->Set(0, 2);
+    EXPECT_EQ(calls, std::vector<std::string>({"once:[0]", "child:arr[0]", "child:arr[0]"}));
+
+    // Detached nodes are not watched
+    calls.clear();
+    root_sp->OnChangeSubtreeAdd(pf_on_change("root"));
+    root_sp->Erase("child");
+    arr_sp->Set(0, 3);
+    EXPECT_EQ(calls, std::vector<std::string>({"root:child", "child:arr[0]"}));
+
+    EXPECT_EQ(root_sp->OnChangeReset(), 1);
+    calls.clear();
+    root_sp->Set("a", 3);
+    EXPECT_TRUE(calls.empty());
+}
+
 TEST(xnode_tests, node_name_parent_tests)
 {
     auto node_map_sp = xnode::Create(INode::NodeType::Map);
@@ -800,6 +1260,228 @@ TEST(xnode_tests, json_tests)
     EXPECT_EQ(zDiff, 0);
 }
 
+TEST(xnode_tests, json_direct_build)
+{
+    // Parsed tree is built w/o Insert(): check parents, names and published state of nodes
+    auto [root_sp, err_pos] = xnode::FromJson(R"({"a":1,"map":{"arr":[1,{"c":"x"}],"e":{}}})", 42, "root");
+    ASSERT_TRUE(root_sp);
+    EXPECT_EQ(err_pos, 0);
+    EXPECT_EQ(root_sp->ObjectUid(), 42);
+    EXPECT_EQ(root_sp->NameGet(), "root");
+    EXPECT_FALSE(root_sp->ParentGet());
+    EXPECT_NE(root_sp->Generation(), 0);
+
+    auto map_sp  = xnode::NodeGet(root_sp, "map");
+    auto arr_sp  = xnode::NodeGet(root_sp, "map::arr");
+    auto item_sp = arr_sp->At(1).QueryPtr<INode>();
+    ASSERT_TRUE(map_sp && arr_sp && item_sp);
+    EXPECT_EQ(map_sp->NameGet(), "map");
+    EXPECT_EQ(map_sp->ObjectUid(), 0);
+    EXPECT_EQ(map_sp->ParentGet(), root_sp);
+    EXPECT_EQ(arr_sp->NameGet(), "arr");
+    EXPECT_EQ(arr_sp->ParentGet(), map_sp);
+    EXPECT_EQ(item_sp->ParentGet(), arr_sp);
+    EXPECT_TRUE(item_sp->NameGet().empty());
+    EXPECT_EQ(xnode::At(root_sp, "map::arr[1]::c").String(), "x");
+    EXPECT_TRUE(xnode::NodeGet(root_sp, "map::e")->Empty());
+
+    // Duplicated key
+    EXPECT_NE(xnode::FromJson(R"({"a":1,"b":{"a":1,"a":2}})").second, 0);
+
+    // Moved node is removed from built parent
+    auto node_sp = xnode::CreateMap();
+    EXPECT_TRUE(arr_sp->ParentSet(node_sp, "moved").first);
+    EXPECT_FALSE(map_sp->At("arr").IsObject());
+    EXPECT_EQ(node_sp->At("moved").QueryPtr<INode>(), arr_sp);
+
+    // Factory options: snapshot and scalar slots are published
+    auto options_prev      = XNodeFactoryGet()->OptionsDefaultGet();
+    auto options           = options_prev;
+    options.read_snapshots = true;
+    options.scalar_slots   = true;
+    XNodeFactoryGet()->OptionsDefaultSet(options);
+
+    auto [node_opt_sp, err_opt_pos] = xnode::FromJson(R"({"a":1,"b":[2],"c":{"d":true}})");
+    XNodeFactoryGet()->OptionsDefaultSet(options_prev);
+    ASSERT_TRUE(node_opt_sp);
+    EXPECT_EQ(node_opt_sp->Size(), 3);
+    EXPECT_EQ(node_opt_sp->AtScalar("a"), XValue(1));
+    EXPECT_EQ(xnode::At(node_opt_sp, "b[0]"), XValue(2));
+    EXPECT_EQ(xnode::At(node_opt_sp, "c::d"), XValue(true));
+}
+
+TEST(xnode_tests, json_insitu)
+{
+    std::string json = R"({"arr":["x","0123456789abcdef"],"long":"long string \"escaped\" w/o copy","short":"abc"})";
+    auto [node_check, err_check] = xnode::FromJson(json);
+
+    // Long strings refer to buffer, the buffer is released with the last value
+    std::weak_ptr<char> data_wp;
+    XValue              long_val;
+    {
+        auto data_p = std::shared_ptr<char>(new char[json.size()], std::default_delete<char[]>());
+        std::memcpy(data_p.get(), json.data(), json.size()); // W/o zero terminator
+        data_wp = data_p;
+
+        auto [node_sp, err_pos] = xnode::FromJsonInsitu(std::move(data_p), json.size(), 1, "insitu");
+        ASSERT_TRUE(node_sp);
+        EXPECT_EQ(err_pos, 0);
+        EXPECT_EQ(node_sp->NameGet(), "insitu");
+        EXPECT_EQ(xnode::Compare(node_sp, node_check, true), 0);
+        EXPECT_EQ(xnode::ToJson(node_sp, nullptr, xnode::JsonFormat::kOneLine), json);
+
+        long_val = node_sp->At("long");
+        EXPECT_EQ(long_val.StringView(), "long string \"escaped\" w/o copy");
+        EXPECT_EQ(long_val, XValue("long string \"escaped\" w/o copy"));
+        EXPECT_EQ(long_val.String().size(), long_val.StringView().size());
+        EXPECT_FALSE(data_wp.expired());
+    }
+    EXPECT_FALSE(data_wp.expired());
+    long_val.Reset();
+    EXPECT_TRUE(data_wp.expired());
+
+    // String overload and errors
+    auto [node_str_sp, err_str] = xnode::FromJsonInsitu(std::string(json));
+    EXPECT_EQ(err_str, 0);
+    EXPECT_EQ(xnode::Compare(node_str_sp, node_check, true), 0);
+    EXPECT_NE(xnode::FromJsonInsitu(std::string(R"({"a":"not terminated)")).second, 0);
+    EXPECT_NE(xnode::FromJsonInsitu(std::string(R"({"a":1} x)")).second, 0);
+    EXPECT_EQ(xnode::FromJsonInsitu(std::string()).first, nullptr);
+}
+
+TEST(xnode_tests, json_stream)
+{
+    auto [node_sp, err_pos] = xnode::FromJson(R"({"a":1,"arr":[1,2,{"b":"long string value"}],"map":{"c":true}})");
+    ASSERT_TRUE(node_sp);
+
+    for (auto format : {xnode::JsonFormat::kOneLine, xnode::JsonFormat::kOneLineArrays, xnode::JsonFormat::kPretty}) {
+        auto json = xnode::ToJson(node_sp, nullptr, format);
+
+        // Chunks of bounded size
+        std::string chunks;
+        size_t      chunks_count = 0;
+        auto        pf_chunk     = [&](std::string_view _chunk) {
+            EXPECT_LE(_chunk.size(), 7);
+            EXPECT_FALSE(_chunk.empty());
+            chunks += _chunk;
+            ++chunks_count;
+            return true;
+        };
+        EXPECT_TRUE(xnode::ToJson(node_sp, pf_chunk, format, kExportIndentCount, kExportIndentChar, 7));
+        EXPECT_EQ(chunks, json);
+        EXPECT_EQ(chunks_count, (json.size() + 6) / 7);
+
+        std::ostringstream stream;
+        EXPECT_TRUE(xnode::ToJson(node_sp, stream, format));
+        EXPECT_EQ(stream.str(), json);
+
+        // FILE* and file descriptor
+        auto file_p = std::tmpfile();
+        ASSERT_TRUE(file_p);
+        EXPECT_TRUE(xnode::ToJson(node_sp, file_p, format, kExportIndentCount, kExportIndentChar, 16));
+        EXPECT_TRUE(xnode::ToJson(node_sp, fileno(file_p), format));
+        std::rewind(file_p);
+        std::string file_data(json.size() * 2 + 1, '\0');
+        file_data.resize(std::fread(file_data.data(), 1, file_data.size(), file_p));
+        EXPECT_EQ(file_data, json + json);
+        std::fclose(file_p);
+    }
+
+    // Failed sink stops output
+    size_t calls = 0;
+    EXPECT_FALSE(xnode::ToJson(
+        node_sp,
+        [&](std::string_view) { return ++calls > 1; },
+        xnode::JsonFormat::kPretty,
+        kExportIndentCount,
+        kExportIndentChar,
+        4));
+    EXPECT_EQ(calls, 1);
+    EXPECT_FALSE(xnode::ToJson(nullptr, [](std::string_view) { return true; }));
+    EXPECT_FALSE(xnode::ToJson(node_sp, static_cast<std::FILE*>(nullptr)));
+    EXPECT_FALSE(xnode::ToJson(node_sp, -1));
+}
+
+TEST(xnode_tests, json_stream_paged)
+{
+    // Large leaf node is passed to sink by pages (w/o node lock): the node is changed after the first chunk, before
+    // its last item is written
+    auto arr_sp = xnode::Create(INode::NodeType::Array);
+    for (int i = 0; i < 1000; ++i)
+        arr_sp->Insert(kIdxEnd, i);
+    auto json = xnode::ToJson(arr_sp, nullptr, xnode::JsonFormat::kOneLine);
+
+    std::string      chunks;
+    std::atomic_bool changed = false;
+    std::thread      writer;
+    auto             pf_chunk = [&](std::string_view _chunk) {
+        if (!writer.joinable()) {
+            writer = std::thread([&] {
+                arr_sp->Set(size_t(999), -1);
+                changed = true;
+            });
+            for (int i = 0; i < 500 && !changed; ++i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            EXPECT_TRUE(changed);
+        }
+        chunks += _chunk;
+        return true;
+    };
+    EXPECT_TRUE(xnode::ToJson(arr_sp, pf_chunk, xnode::JsonFormat::kOneLine, kExportIndentCount, kExportIndentChar, 64));
+    writer.join();
+    EXPECT_EQ(chunks, json.substr(0, json.size() - 4) + "-1]");
+    EXPECT_EQ(chunks, xnode::ToJson(arr_sp, nullptr, xnode::JsonFormat::kOneLine));
+}
+
+TEST(xnode_tests, json_parallel)
+{
+    // Large array of maps with nested nodes, large map deeper and small nodes around
+    auto root_sp  = xnode::CreateMap({{"a", 1}, {"empty_map", xnode::CreateMap()}, {"str", "x\ny"}});
+    auto items_sp = xnode::Create(INode::NodeType::Array);
+    for (int i = 0; i < 300; ++i) {
+        auto item_sp = xnode::CreateMap({{"id", i}, {"name", "item " + std::to_string(i)}, {"val", i * 0.5}});
+        item_sp->Set("tags", xnode::CreateArray({i, "tag", true}));
+        item_sp->Set("nested", xnode::CreateMap({{"empty_arr", xnode::CreateArray()}, {"b", i % 3 == 0}}));
+        items_sp->Insert(kIdxEnd, item_sp);
+    }
+    xnode::Set(root_sp, "data::items", items_sp);
+    auto big_map_sp = xnode::NodeGet(root_sp, "data::big_map", INode::NodeType::Map);
+    for (int i = 0; i < 100; ++i)
+        big_map_sp->Set("key_" + std::to_string(i), i % 2 ? XValue(i) : XValue(xnode::CreateArray({i, i + 1})));
+
+    for (auto format : {xnode::JsonFormat::kOneLine, xnode::JsonFormat::kOneLineArrays, xnode::JsonFormat::kPretty}) {
+        auto json = xnode::ToJson(root_sp, nullptr, format);
+        for (size_t subtree_size_min : {1, 2, 16, 100, 100'000}) {
+            xnode::JsonParallelOptions options;
+            options.threads          = 4;
+            options.subtree_size_min = subtree_size_min;
+            EXPECT_EQ(xnode::ToJsonParallel(root_sp, format, kExportIndentCount, kExportIndentChar, options), json);
+            EXPECT_EQ(xnode::ToJsonParallel(root_sp, format, 2, '\t', options),
+                      xnode::ToJson(root_sp, nullptr, format, 2, '\t'));
+        }
+    }
+
+    xnode::JsonParallelOptions options;
+    options.threads = 1;
+    EXPECT_EQ(xnode::ToJsonParallel(root_sp, xnode::JsonFormat::kPretty, 4, ' ', options),
+              xnode::ToJson(root_sp, nullptr, xnode::JsonFormat::kPretty, 4, ' '));
+    EXPECT_EQ(xnode::ToJsonParallel(nullptr), "");
+}
+
+TEST(xnode_tests, json_nested_order)
+{
+    // Scalars and runs of nested nodes are alternated (nested nodes are written w/o parent lock)
+    auto arr_sp = xnode::CreateArray({1, xnode::CreateMap({{"a", 2}}), xnode::CreateArray({3}), 4, 5});
+    arr_sp->Insert(kIdxEnd, xnode::CreateMap());
+    arr_sp->Insert(kIdxEnd, 6);
+    auto map_sp = xnode::CreateMap({{"a", 1}, {"b", xnode::CreateArray({2})}, {"c", 3}, {"d", xnode::CreateMap()}});
+    map_sp->Set("e", arr_sp);
+
+    EXPECT_EQ(xnode::ToJson(arr_sp, nullptr, xnode::JsonFormat::kOneLine), R"([1,{"a":2},[3],4,5,{},6])");
+    EXPECT_EQ(xnode::ToJson(map_sp, nullptr, xnode::JsonFormat::kOneLine),
+              R"({"a":1,"b":[2],"c":3,"d":{},"e":[1,{"a":2},[3],4,5,{},6]})");
+}
+
 TEST(xnode_tests, array_tests)
 {
     auto node_map_sp = xnode::Create(INode::NodeType::Map);
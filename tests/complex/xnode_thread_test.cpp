@@ -1,10 +1,14 @@
 #include "xnode.h"
+#include "xnode_factory.h"
 #include "xnode_functions.h"
 #include "xnode_json.h"
 
+#include "../src/xnode/impl/xepoch.h"
+
 #include <gtest/gtest.h>
 #include <algorithm>
 #include <atomic>
+#include <mutex>
 #include <thread>
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -423,4 +427,409 @@ TEST(xnode_thread_tests, thread_node_complex_ops)
     // EXPECT_FALSE(TRUE);
 }
 
+TEST(xnode_thread_tests, read_snapshots)
+{
+    INodeFactory::Options options;
+    options.read_snapshots = true;
+
+    // Same results as locked reads
+    for (auto layout : {MapLayout::Tree, MapLayout::Hash, MapLayout::HashOrdered, MapLayout::Flat, MapLayout::FlatHash}) {
+        options.map_layout         = layout;
+        auto options_check         = options;
+        options_check.read_snapshots = false;
+
+        auto node_sp       = xnode::Create(INode::NodeType::Map, {}, 0, options);
+        auto node_check_sp = xnode::Create(INode::NodeType::Map, {}, 0, options_check);
+        for (auto* node_p : {node_sp.get(), node_check_sp.get()}) {
+            for (int i = 0; i < 40; ++i)
+                node_p->Set("key_" + std::to_string(i), i);
+            for (int i = 0; i < 40; i += 3)
+                node_p->Erase("key_" + std::to_string(i));
+            node_p->Set("child", xnode::CreateMap({{"a", 1}}));
+        }
+
+        // Values of different nodes have different timestamps
+        auto pf_items = [](const std::vector<std::pair<XKey, XValueRT>>& _items) {
+            std::vector<std::pair<XKey, int64_t>> items;
+            for (const auto& [key, val] : _items)
+                items.emplace_back(key, val.Int64());
+            return items;
+        };
+
+        EXPECT_EQ(node_sp->Size(), node_check_sp->Size());
+        EXPECT_EQ(node_sp->At("key_7"), 7);
+        EXPECT_TRUE(node_sp->At("key_9").IsEmpty());
+        EXPECT_TRUE(node_sp->At("key_not_interned_ever").IsEmpty());
+        EXPECT_EQ(node_sp->At(5).Int64(), node_check_sp->At(5).Int64());
+        EXPECT_TRUE(node_sp->At(kIdxLast).IsObject() || node_sp->At(kIdxLast) == node_check_sp->At(kIdxLast));
+        EXPECT_EQ(xnode::At(node_sp, "child::a"), 1);
+        EXPECT_EQ(pf_items(node_sp->BulkGetAll()), pf_items(node_check_sp->BulkGetAll()));
+        EXPECT_EQ(pf_items(node_sp->BulkGetAll(nullptr, "key_20")),
+                  pf_items(node_check_sp->BulkGetAll(nullptr, "key_20")));
+        EXPECT_EQ(pf_items(node_sp->BulkGet({"key_1", "key_3", "key_4"})),
+                  pf_items(node_check_sp->BulkGet({"key_1", "key_3", "key_4"})));
+
+        // Visit() hands out the same items as BulkGetAll() w/o copies
+        auto pf_visit = [](const INode::SPtr& _node_p, const XKey& _from_key, size_t _count_max) {
+            std::vector<std::pair<XKey, int64_t>> items;
+            _node_p->Visit(
+                [&](const XKey& _key, const XValueRT& _val) {
+                    items.emplace_back(_key, _val.Int64());
+                    return items.size() == _count_max;
+                },
+                _from_key);
+            return items;
+        };
+        for (auto* node_p : {&node_sp, &node_check_sp}) {
+            EXPECT_EQ(pf_visit(*node_p, {}, SIZE_MAX), pf_items(node_check_sp->BulkGetAll()));
+            EXPECT_EQ(pf_visit(*node_p, "key_20", SIZE_MAX), pf_items(node_check_sp->BulkGetAll(nullptr, "key_20")));
+            EXPECT_EQ(pf_visit(*node_p, {}, 3).size(), 3);
+            EXPECT_FALSE((*node_p)->Visit([](const XKey&, const XValueRT&) { return false; }, "key_100"));
+        }
+
+        node_sp->Clear();
+        EXPECT_TRUE(node_sp->Empty());
+        EXPECT_TRUE(node_sp->At("key_7").IsEmpty());
+    }
+
+    auto array_sp = xnode::Create(INode::NodeType::Array, {}, 0, options);
+    array_sp->BulkInsert(kIdxEnd, {1, 2, 3});
+    EXPECT_EQ(array_sp->Size(), 3);
+    EXPECT_EQ(array_sp->At(1), 2);
+    EXPECT_EQ(array_sp->At(kIdxLast), 3);
+    EXPECT_TRUE(array_sp->At(3).IsEmpty());
+    array_sp->Erase(0);
+    EXPECT_EQ(array_sp->At(0), 2);
+
+    // Readers always see consistent items: counter and its copy are changed together by BulkSet()
+    auto                node_sp = xnode::Create(INode::NodeType::Map, {}, 0, options);
+    std::atomic_bool    stop    = {false};
+    std::atomic<size_t> reads   = 0;
+    node_sp->BulkSet({{"counter", 0}, {"copy", 0}});
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            int64_t counter_prev = 0;
+            while (!stop) {
+                int64_t counter = -1;
+                int64_t copy    = -2;
+                for (const auto& [key, val] : node_sp->BulkGetAll()) {
+                    if (key == XKey("counter"))
+                        counter = val.Int64();
+                    else if (key == XKey("copy"))
+                        copy = val.Int64();
+                }
+                EXPECT_EQ(counter, copy);
+                EXPECT_GE(counter, counter_prev);
+                counter_prev = counter;
+
+                auto child_sp = node_sp->At("child").QueryPtr<INode>();
+                if (child_sp)
+                    EXPECT_EQ(child_sp->At("value"), 1);
+                ++reads;
+            }
+        });
+    }
+
+    for (int64_t i = 1; i <= 2000; ++i) {
+        node_sp->BulkSet({{"counter", i}, {"copy", i}});
+        node_sp->Set("child", xnode::CreateMap({{"value", 1}}));
+        if (i % 100 == 0)
+            node_sp->Erase("child");
+    }
+    while (reads < 100)
+        std::this_thread::yield();
+
+    stop = true;
+    for (auto& th : readers)
+        th.join();
+
+    EXPECT_EQ(node_sp->At("counter"), 2000);
+    EXPECT_EQ(node_sp->At("copy"), 2000);
+}
+
+TEST(xnode_thread_tests, scalar_slots)
+{
+    INodeFactory::Options options;
+    options.scalar_slots = true;
+
+    // Same values as At() for scalars, empty for other values
+    for (auto layout : {MapLayout::Tree, MapLayout::Hash, MapLayout::Flat, MapLayout::FlatHash}) {
+        options.map_layout = layout;
+
+        auto node_sp = xnode::Create(INode::NodeType::Map, {}, 0, options);
+        node_sp->BulkSet({{"bool", true}, {"int", -5}, {"uint", uint64_t(7)}, {"double", 0.25}, {"str", "str"}});
+        node_sp->Set("child", xnode::CreateMap({{"a", 1}}));
+
+        EXPECT_EQ(node_sp->AtScalar("bool"), true);
+        EXPECT_EQ(node_sp->AtScalar("int"), -5);
+        EXPECT_EQ(node_sp->AtScalar("uint").Type(), XValue::kUint64);
+        EXPECT_EQ(node_sp->AtScalar("uint"), uint64_t(7));
+        EXPECT_EQ(node_sp->AtScalar("double"), 0.25);
+        EXPECT_EQ(node_sp->AtScalar("int").Timestamp(), node_sp->At("int").Timestamp());
+        EXPECT_TRUE(node_sp->AtScalar("str").IsEmpty());
+        EXPECT_TRUE(node_sp->AtScalar("child").IsEmpty());
+        EXPECT_TRUE(node_sp->AtScalar("key_not_interned_ever").IsEmpty());
+        for (size_t pos = 0; pos < node_sp->Size(); ++pos) {
+            auto val = node_sp->At(pos);
+            EXPECT_EQ(node_sp->AtScalar(pos), val.IsObject() || val.Type() == XValue::kString ? XValueRT() : val);
+        }
+
+        // Changes by all methods
+        node_sp->Increment("int", 10);
+        EXPECT_EQ(node_sp->AtScalar("int"), 5);
+        node_sp->Set("str", 3);
+        EXPECT_EQ(node_sp->AtScalar("str"), 3);
+        node_sp->Set("bool", "not scalar");
+        EXPECT_TRUE(node_sp->AtScalar("bool").IsEmpty());
+        node_sp->CompareExchange("double", 0.25, 0.5);
+        EXPECT_EQ(node_sp->AtScalar("double"), 0.5);
+        node_sp->ForEach([](const XKey& _key, XValueRT& _val) {
+            if (_key == XKey("uint"))
+                _val = XValue(uint64_t(8));
+            return OnEachRes::Next;
+        });
+        EXPECT_EQ(node_sp->AtScalar("uint"), uint64_t(8));
+        node_sp->KeyChange("uint", "uint_new");
+        EXPECT_TRUE(node_sp->AtScalar("uint").IsEmpty());
+        EXPECT_EQ(node_sp->AtScalar("uint_new"), uint64_t(8));
+        node_sp->Erase("int");
+        EXPECT_TRUE(node_sp->AtScalar("int").IsEmpty());
+        node_sp->BulkErase({"str"});
+        EXPECT_TRUE(node_sp->AtScalar("str").IsEmpty());
+        node_sp->Clear();
+        EXPECT_TRUE(node_sp->AtScalar("double").IsEmpty());
+        node_sp->Set("double", 1.5);
+        EXPECT_EQ(node_sp->AtScalar("double"), 1.5);
+    }
+
+    // Slots of erased keys are reclaimed with their keys, other slots keep values
+    {
+        options.map_layout = MapLayout::Tree;
+        auto node_sp       = xnode::Create(INode::NodeType::Map, {}, 0, options);
+        for (int i = 0; i < 100; ++i)
+            node_sp->Set("scalar_slots_" + std::to_string(i), i);
+
+        // Less than kEmptyMin empty slots could be kept
+        auto count_before = xnode::StringAtom::Count();
+        for (int i = 0; i < 100; ++i) {
+            if (i % 10)
+                node_sp->Erase("scalar_slots_" + std::to_string(i));
+        }
+        node_sp->ErasedCompact();
+        impl::XEpoch::Reclaim();
+
+        EXPECT_LE(xnode::StringAtom::Count() + 75, count_before);
+        EXPECT_TRUE(xnode::StringAtom::Find("scalar_slots_1").empty());
+        for (int i = 0; i < 100; i += 10)
+            EXPECT_EQ(node_sp->AtScalar("scalar_slots_" + std::to_string(i)), i);
+        EXPECT_TRUE(node_sp->AtScalar("scalar_slots_1").IsEmpty());
+        node_sp->Set("scalar_slots_1", 1.5);
+        EXPECT_EQ(node_sp->AtScalar("scalar_slots_1"), 1.5);
+    }
+
+    // Values w/o scalar slots
+    auto array_sp = xnode::CreateArray({1, "str"});
+    EXPECT_EQ(array_sp->AtScalar(0), 1);
+    EXPECT_TRUE(array_sp->AtScalar(1).IsEmpty());
+
+    // Readers never see torn slots: type and value are changed together, timestamps are not decreased
+    auto                node_sp = xnode::Create(INode::NodeType::Map, {}, 0, options);
+    std::atomic_bool    stop    = {false};
+    std::atomic<size_t> reads   = 0;
+    node_sp->Set("value", 0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            double  value_prev     = 0;
+            int64_t timestamp_prev = 0;
+            while (!stop) {
+                auto val = node_sp->AtScalar("value");
+                if (val.Type() == XValue::kInt64)
+                    EXPECT_EQ(val.Int64() % 2, 0);
+                else
+                    EXPECT_EQ(val.Double() - floor(val.Double()), 0.5);
+                EXPECT_GE(val.Double(), value_prev);
+                EXPECT_GE(val.Timestamp(), timestamp_prev);
+                value_prev     = val.Double();
+                timestamp_prev = val.Timestamp();
+                ++reads;
+            }
+        });
+    }
+
+    for (int64_t i = 1; i <= 20000; ++i) {
+        if (i % 2)
+            node_sp->Set("value", double(i) + 0.5);
+        else
+            node_sp->Set("value", i);
+    }
+    while (reads < 100)
+        std::this_thread::yield();
+
+    stop = true;
+    for (auto& th : readers)
+        th.join();
+
+    EXPECT_EQ(node_sp->AtScalar("value"), 20000);
+}
+
+TEST(xnode_thread_tests, json_transaction)
+{
+    // Transaction locks nodes by address: children below parent are locked first, so reader locking children
+    // under the parent lock would deadlock with it
+    std::vector<INode::SPtr> children;
+    for (size_t i = 0; i < 65; ++i)
+        children.push_back(xnode::CreateMap({{"v", 0}}));
+    std::sort(children.begin(), children.end());
+    auto parent_sp = children.back();
+    children.pop_back();
+    for (size_t i = 0; i < children.size(); ++i)
+        ASSERT_TRUE(parent_sp->Insert("child_" + std::to_string(i), children[i]).succeeded);
+
+    std::atomic_bool stop = false;
+    std::thread      writer([&] {
+        xnode::Transaction transaction(parent_sp);
+        for (int64_t i = 1; !stop; ++i) {
+            transaction.Set("v", i);
+            for (size_t c = 0; c < children.size(); ++c)
+                transaction.Set("child_" + std::to_string(c) + "::v", i);
+            EXPECT_TRUE(transaction.Commit());
+        }
+    });
+
+    // Nested nodes and sinks are processed w/o parent lock
+    for (size_t i = 0; i < 200; ++i) {
+        auto json = xnode::ToJson(parent_sp, nullptr, xnode::JsonFormat::kOneLine);
+        EXPECT_EQ(json.rfind("{\"child_0\":{\"v\":", 0), 0);
+
+        std::string streamed;
+        EXPECT_TRUE(xnode::ToJson(
+            parent_sp,
+            [&](std::string_view _chunk) {
+                streamed.append(_chunk);
+                return true;
+            },
+            xnode::JsonFormat::kOneLine,
+            kExportIndentCount,
+            kExportIndentChar,
+            16));
+        EXPECT_EQ(streamed.rfind("{\"child_0\":{\"v\":", 0), 0);
+    }
+
+    stop = true;
+    writer.join();
+}
+
+TEST(xnode_thread_tests, async_callbacks)
+{
+    // Small queue for check of backpressure (options are applied before first async callback): writers wait
+    // for queue space w/o node lock, so callbacks reading own node do not deadlock
+    xnode::AsyncOptions options;
+    options.threads    = 2;
+    options.queue_size = 4;
+    EXPECT_TRUE(xnode::AsyncConfigure(options));
+
+    auto map_sp = xnode::CreateMap({{"a", 0}});
+    map_sp->OnChangeAdd([](INode::CallbackReason, const INode::SPtrC&, const XKey&, const XValueRT&,
+                           const XValueRT& _to) -> std::optional<bool> { return _to != XValue("veto"); });
+
+    // Called by dispatcher thread w/o node lock (so could read node), in order of changes
+    std::mutex                                                      mutex;
+    std::vector<std::tuple<INode::CallbackReason, XKey, XValueRT>> notifications;
+    std::atomic<size_t>                                             slow = 0;
+    auto writer_id = std::this_thread::get_id();
+    auto id        = map_sp->OnChangeAsyncAdd([&](INode::CallbackReason _reason, const INode::SPtrC& _node,
+                                           const XKey& _key, const XValueRT&, const XValueRT& _to)
+                                           -> std::optional<bool> {
+        EXPECT_NE(std::this_thread::get_id(), writer_id);
+        EXPECT_FALSE(_node->At("a").IsEmpty());
+        if (slow.load() > 0) {
+            --slow;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+
+        std::lock_guard lck(mutex);
+        notifications.emplace_back(_reason, _key, _to);
+        return true;
+    });
+    EXPECT_NE(id, 0);
+    EXPECT_FALSE(xnode::AsyncConfigure(options));
+
+    slow = 200;
+    for (int64_t i = 1; i <= 1000; ++i)
+        map_sp->Set("a", i);
+    EXPECT_FALSE(map_sp->Set("b", "veto").first);
+    xnode::AsyncFlush();
+
+    {
+        std::lock_guard lck(mutex);
+        ASSERT_EQ(notifications.size(), 1000);
+        for (int64_t i = 1; i <= 1000; ++i)
+            EXPECT_EQ(std::get<2>(notifications[i - 1]), i);
+        notifications.clear();
+    }
+
+    auto metrics = xnode::AsyncMetricsGet();
+    EXPECT_GE(metrics.enqueued, 1000);
+    EXPECT_EQ(metrics.depth, 0);
+    EXPECT_EQ(metrics.delivered, metrics.enqueued);
+    EXPECT_EQ(metrics.dropped, 0);
+    EXPECT_GT(metrics.blocked, 0);
+    EXPECT_LE(metrics.depth_max, 4 + 1); // Including called notification
+    EXPECT_GT(metrics.latency_max_usec, 0);
+
+    // Reverted changes of aborted transaction are passed as rollback
+    xnode::Transaction transaction(map_sp);
+    transaction.Set("a", -1);
+    transaction.Set("b", "veto");
+    EXPECT_FALSE(transaction.Commit());
+    xnode::AsyncFlush();
+    {
+        std::lock_guard lck(mutex);
+        ASSERT_EQ(notifications.size(), 2);
+        EXPECT_EQ(std::get<0>(notifications[0]), INode::CallbackReason::ChangesNoDiscard);
+        EXPECT_EQ(std::get<2>(notifications[0]), -1);
+        EXPECT_EQ(std::get<0>(notifications[1]), INode::CallbackReason::Rollback);
+        EXPECT_EQ(std::get<2>(notifications[1]), 1000);
+        notifications.clear();
+    }
+
+    // Removed callback is not called (including queued notifications)
+    EXPECT_TRUE(map_sp->OnChangeRemove(id));
+    map_sp->Set("a", 1);
+    xnode::AsyncFlush();
+    EXPECT_TRUE(notifications.empty());
+
+    // Callback returned std::nullopt is removed
+    std::atomic<size_t> calls = 0;
+    map_sp->OnChangeAsyncAdd([&](INode::CallbackReason, const INode::SPtrC&, const XKey&, const XValueRT&,
+                                 const XValueRT&) -> std::optional<bool> {
+        ++calls;
+        return std::nullopt;
+    });
+    map_sp->Set("a", 2);
+    xnode::AsyncFlush();
+    map_sp->Set("a", 3);
+    xnode::AsyncFlush();
+    EXPECT_EQ(calls, 1);
+
+    // Writer waits for queue space w/o node lock: the callback reads own node when the queue is full
+    std::atomic_bool reading = false;
+    id                       = map_sp->OnChangeAsyncAdd([&](INode::CallbackReason, const INode::SPtrC& _node,
+                                      const XKey&, const XValueRT&, const XValueRT&) -> std::optional<bool> {
+        if (!reading.exchange(true))
+            std::this_thread::sleep_for(std::chrono::milliseconds(50)); // The writer fills the queue
+        EXPECT_FALSE(_node->At("a").IsEmpty());
+        return true;
+    });
+    for (int64_t i = 1; i <= 100; ++i)
+        map_sp->Set("a", i);
+    xnode::AsyncFlush();
+    EXPECT_TRUE(map_sp->OnChangeRemove(id));
+    EXPECT_EQ(map_sp->OnChangeReset(), 1); // Sync callback
+}
+
 // NOLINTEND(*)
\ No newline at end of file
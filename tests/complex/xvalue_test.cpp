@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <atomic>
 #include <deque>
+#include <mutex>
 #include <thread>
 
 using namespace xsdk;
@@ -215,8 +216,16 @@ TEST(xvalue_tests, compare)
         XValue test5(99.0);
         XValue test6(nullptr);
 
-        EXPECT_EQ(test1.StringView().data(), test3.StringView().data());
-        EXPECT_EQ(test1.StringView().data(), test33.StringView().data());
+        // Short strings are copied (stored inline), long strings are shared
+        EXPECT_EQ(test1.StringView(), test3.StringView());
+        EXPECT_EQ(test1.StringView(), test33.StringView());
+
+        XValue test_long1(std::string(xnode::StringShort::kSizeMax + 1, 'x'));
+        XValue test_long2 = test_long1;
+        XValue test_long3;
+        test_long3 = test_long2;
+        EXPECT_EQ(test_long1.StringView().data(), test_long2.StringView().data());
+        EXPECT_EQ(test_long1.StringView().data(), test_long3.StringView().data());
 
         EXPECT_TRUE(test1 == test2);
         EXPECT_TRUE(test3 == test2);
@@ -346,6 +355,94 @@ TEST(xvalue_tests, rt_test)
     EXPECT_EQ(val_no_ts.Timestamp(), kAbsentRT);
 }
 
+TEST(xvalue_tests, short_string)
+{
+    EXPECT_EQ(sizeof(XValue), sizeof(std::shared_ptr<const std::string>) + sizeof(size_t));
+
+    for (size_t size = 0; size <= xnode::StringShort::kSizeMax + 2; ++size) {
+        std::string str(size, 'a');
+        if (size > 0)
+            str.back() = '1';
+
+        XValue val(str);
+        XValue val_sv {std::string_view(str)};
+        XValue val_moved {std::string(str)};
+        XValue val_c(str.c_str());
+        EXPECT_EQ(val.Type(), XValue::kString);
+        EXPECT_EQ(val.StringView(), str);
+        EXPECT_EQ(val.StringView().size(), size);
+        EXPECT_EQ(val.String(), str);
+        EXPECT_EQ(val.IsEmpty(), size == 0);
+        EXPECT_TRUE(val.IsAttribute());
+        EXPECT_EQ(val, val_sv);
+        EXPECT_EQ(val, val_moved);
+        EXPECT_EQ(val, val_c);
+        EXPECT_EQ(val.Compare(val_sv), 0);
+        // Zero terminated
+        EXPECT_EQ(val.StringView().data()[size], 0);
+    }
+
+    // Short and long strings comparison
+    XValue val_short("abc");
+    XValue val_long(std::string(xnode::StringShort::kSizeMax + 1, 'b'));
+    EXPECT_LT(val_short, val_long);
+    EXPECT_GT(val_long, val_short);
+    EXPECT_NE(val_short, val_long);
+
+    // Conversions
+    EXPECT_EQ(XValue("42").Int64(), 42);
+    EXPECT_EQ(XValue("-42").Uint64(7, 13), 13);
+    EXPECT_EQ(XValue("0.5").Double(), 0.5);
+    EXPECT_TRUE(XValue("true").Bool());
+    EXPECT_EQ(XValue("1").StringView(), "1");
+}
+
+TEST(xvalue_tests, sharded_clock)
+{
+    using XValueSharded = XTimed<XValue, xnode::ShardedClock<>>;
+
+    XValueSharded val_with_ts(100);
+    EXPECT_GT(val_with_ts.Timestamp(), 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto ts = val_with_ts.TimeElapsed();
+    EXPECT_GT(ts, XValueSharded::MsecToTicks(99));
+    EXPECT_LT(ts, XValueSharded::MsecToTicks(150));
+
+    // Unique and monotonic per thread and under lock (as for node changes)
+    constexpr size_t                  kThreads = 8;
+    constexpr size_t                  kTests   = 100'000;
+    std::mutex                        lock_mutex;
+    std::vector<int64_t>              locked_timestamps;
+    std::vector<std::vector<int64_t>> threads_timestamps(kThreads);
+    std::vector<std::thread>          threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            auto& timestamps = threads_timestamps[t];
+            for (size_t i = 0; i < kTests; ++i) {
+                timestamps.push_back(xnode::ShardedClock<>::Timestamp());
+                if (i % 16 == 0) {
+                    std::lock_guard lck(lock_mutex);
+                    locked_timestamps.push_back(XValueSharded(XValue(i)).Timestamp());
+                }
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    std::vector<int64_t> all_timestamps;
+    for (const auto& timestamps : threads_timestamps) {
+        EXPECT_TRUE(std::is_sorted(timestamps.begin(), timestamps.end(), std::less_equal<int64_t>()));
+        all_timestamps.insert(all_timestamps.end(), timestamps.begin(), timestamps.end());
+    }
+    all_timestamps.insert(all_timestamps.end(), locked_timestamps.begin(), locked_timestamps.end());
+    std::sort(all_timestamps.begin(), all_timestamps.end());
+    EXPECT_EQ(std::adjacent_find(all_timestamps.begin(), all_timestamps.end()), all_timestamps.end());
+
+    for (size_t i = 1; i < locked_timestamps.size(); ++i)
+        ASSERT_LT(locked_timestamps[i - 1], locked_timestamps[i]);
+}
+
 // TEST(modern_tests, perf_clock)
 //{
 //     xbase::clock_cpp clockTest;
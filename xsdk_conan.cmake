@@ -514,17 +514,23 @@ macro(conan_provide_dependency method package_name)
             endif()
             set(generator "-g;CMakeDeps")
         endif()
+        # Optional requirements of conanfile.py
+        set(_options_flags "")
+        if(WITH_BENCHMARKS)
+            list(APPEND _options_flags "-o;with_benchmarks=True")
+        endif()
         get_property(_multiconfig_generator GLOBAL PROPERTY GENERATOR_IS_MULTI_CONFIG)
         if(NOT _multiconfig_generator)
             message(STATUS "CMake-Conan: Installing single configuration ${CMAKE_BUILD_TYPE}")
-            conan_install(${_host_profile_flags} ${_build_profile_flags} --build=missing ${generator})
+            conan_install(${_host_profile_flags} ${_build_profile_flags} --build=missing ${_options_flags} ${generator})
         else()
             message(STATUS "CMake-Conan: Installing both Debug and RelWithDebInfo")
-            conan_install(${_host_profile_flags} ${_build_profile_flags} -s build_type=RelWithDebInfo --build=missing ${generator})
-            conan_install(${_host_profile_flags} ${_build_profile_flags} -s build_type=Debug --build=missing ${generator})
+            conan_install(${_host_profile_flags} ${_build_profile_flags} -s build_type=RelWithDebInfo --build=missing ${_options_flags} ${generator})
+            conan_install(${_host_profile_flags} ${_build_profile_flags} -s build_type=Debug --build=missing ${_options_flags} ${generator})
         endif()
         unset(_host_profile_flags)
         unset(_build_profile_flags)
+        unset(_options_flags)
         unset(_multiconfig_generator)
         unset(_conan_install_success)
     else()